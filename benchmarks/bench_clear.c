@@ -0,0 +1,77 @@
+/**
+ * @file bench_clear.c
+ * @brief cerror_clear_last() throughput: clean context, dirty context, legacy clear
+ *
+ * The success path of a typical call (see processData in examples/basic_usage.c)
+ * clears an already clear context. With the dirty-word design this is one load
+ * and a branch; the target is well above 100M clears per second per thread.
+ */
+
+#include "bench_common.h"
+
+#include <c-error/lasterror.h>
+
+#define BENCH_ITERATIONS 200000000ULL
+
+/**
+ * @brief The previous clear: three unconditional stores, one into the heap buffer
+ */
+static inline void legacy_clear_last(void)
+{
+    g_LastErrorCtx.ullLastError = 0ULL;
+    g_LastErrorCtx.pszLastErrorInfo = NULL;
+    if (NULL != g_LastErrorCtx.pszLastErrorInfoBuffer)
+    {
+        g_LastErrorCtx.pszLastErrorInfoBuffer[0] = '\0';
+    }
+}
+
+int main(void)
+{
+    uint64_t ullStart;
+    uint64_t i;
+
+    printf("c-error clear benchmark (%llu iterations)\n", (unsigned long long)BENCH_ITERATIONS);
+    printf("========================================\n");
+
+    /* Give the context a heap buffer so the legacy clear has something to touch */
+    cerror_set_last_info_copy(MAKE_ERROR_CODE(1, 2, 3, 4), "allocate the info buffer");
+    cerror_clear_last();
+
+    ullStart = bench_now_ns();
+    for (i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        cerror_clear_last();
+        BENCH_BARRIER();
+    }
+    bench_report("clear (already clear)", BENCH_ITERATIONS, bench_now_ns() - ullStart);
+
+    ullStart = bench_now_ns();
+    for (i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        legacy_clear_last();
+        BENCH_BARRIER();
+    }
+    bench_report("legacy clear (already clear)", BENCH_ITERATIONS, bench_now_ns() - ullStart);
+
+    ullStart = bench_now_ns();
+    for (i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        cerror_set_last(MAKE_ERROR_CODE(1, 2, 3, 4));
+        cerror_clear_last();
+        BENCH_BARRIER();
+    }
+    bench_report("set + clear (dirty)", BENCH_ITERATIONS, bench_now_ns() - ullStart);
+
+    ullStart = bench_now_ns();
+    for (i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        cerror_set_last(MAKE_ERROR_CODE(1, 2, 3, 4));
+        legacy_clear_last();
+        BENCH_BARRIER();
+    }
+    bench_report("set + legacy clear (dirty)", BENCH_ITERATIONS, bench_now_ns() - ullStart);
+
+    cerror_cleanup_thread_local_buffer();
+    return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file bench_common.h
+ * @brief Shared helpers for c-error benchmarks (timing, compiler barrier, reporting)
+ */
+#pragma once
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/**
+ * @brief Compiler barrier: keeps loop bodies from being hoisted or merged
+ */
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define BENCH_BARRIER() _ReadWriteBarrier()
+#else
+    #define BENCH_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+
+/**
+ * @brief Monotonic time in nanoseconds
+ */
+static inline uint64_t bench_now_ns(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Print one result line: name, ns/op and million ops/s
+ */
+static inline void bench_report(const char* pszName, uint64_t ullOps, uint64_t ullElapsedNs)
+{
+    const double dNsPerOp = (double)ullElapsedNs / (double)ullOps;
+    printf("%-40s %8.3f ns/op %10.1f Mops/s\n", pszName, dNsPerOp, 1e3 / dNsPerOp);
+}
@@ -0,0 +1,575 @@
+/**
+ * @file bench_compare.cpp
+ * @brief c-error against errno, std::error_code, exceptions and std::expected
+ *
+ * Every strategy runs the same workload: a non-inlined callee parses a value
+ * and fails for a randomly placed share of the calls (0% to 50%); the caller
+ * checks the result and, on failure, consumes and clears the error. Each
+ * strategy runs without and with a message (the same 46-byte string, copied
+ * on every failure).
+ *
+ * Reported per strategy, message mode and failure rate:
+ *  - throughput in million calls per second
+ *  - p50 / p99 / p99.9 latency of single calls (timer overhead subtracted)
+ * and per strategy the machine code size of its callee and caller loop. Code
+ * size needs GCC or Clang on ELF: each strategy's functions go into their own
+ * section, measured through the linker's __start_/__stop_ symbols. Shared
+ * out-of-line code (c-error slow paths, libstdc++, the unwinder) and unwind
+ * tables are not included.
+ *
+ * std::expected is measured when the standard library provides it (C++23).
+ *
+ * Usage: bench_compare [calls per run]
+ */
+
+#include "bench_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__has_include)
+    #if __has_include(<version>)
+        #include <version>
+    #endif
+#endif
+#if defined(__cpp_lib_expected)
+    #include <expected>
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+    #define BENCH_HAVE_TSC 1
+#endif
+
+#define BENCH_DEFAULT_CALLS     10000000u
+#define BENCH_LATENCY_SAMPLES   200000u
+#define BENCH_FAIL_BIT          0x80000000u
+
+/** Failure rates in basis points: 0%, 0.1%, 1%, 10%, 50% */
+static const uint32_t g_aFailureRates[] = { 0u, 10u, 100u, 1000u, 5000u };
+
+static const char g_szMessage[] = "record 4711 rejected: checksum mismatch at 0x2a";
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x20, CERROR_INVALID_ARGUMENT, 0x0007);
+
+/* ============================================================================
+ * Code Placement
+ * ============================================================================ */
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__ELF__)
+    #define BENCH_HAVE_CODE_SIZE 1
+    #define BENCH_CODE(name)            __attribute__((noinline, section(#name)))
+    #define BENCH_SECTION(name)         extern "C" const char __start_##name[]; \
+                                        extern "C" const char __stop_##name[];
+    #define BENCH_CODE_SIZE(name)       ((size_t)(__stop_##name - __start_##name))
+#else
+    #if defined(_MSC_VER)
+        #define BENCH_CODE(name)        __declspec(noinline)
+    #else
+        #define BENCH_CODE(name)        __attribute__((noinline))
+    #endif
+    #define BENCH_SECTION(name)
+    #define BENCH_CODE_SIZE(name)       ((size_t)0)
+#endif
+
+/** Result of a parse: the input value, transformed */
+static inline int64_t benchValue(uint32_t uInput)
+{
+    return (int64_t)(uInput * 3u + 1u);
+}
+
+/* ============================================================================
+ * c-error
+ * ============================================================================ */
+
+BENCH_CODE(bench_cerror) static int64_t parseCError(uint32_t uInput)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        cerror_set_last(g_ullCode);
+        return -1;
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_cerror) static uint64_t runCError(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        const int64_t llValue = parseCError(aInputs[i]);
+        if (llValue < 0)
+        {
+            ullSum += cerror_get_last();
+            cerror_clear_last();
+            continue;
+        }
+        ullSum += (uint64_t)llValue;
+    }
+    return ullSum;
+}
+
+BENCH_CODE(bench_cerror_msg) static int64_t parseCErrorMessage(uint32_t uInput)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        cerror_set_last_info_copy(g_ullCode, g_szMessage);
+        return -1;
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_cerror_msg) static uint64_t runCErrorMessage(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        const int64_t llValue = parseCErrorMessage(aInputs[i]);
+        if (llValue < 0)
+        {
+            ullSum += cerror_get_last() + (uint8_t)cerror_get_last_info()[0];
+            cerror_clear_last();
+            continue;
+        }
+        ullSum += (uint64_t)llValue;
+    }
+    return ullSum;
+}
+
+/* ============================================================================
+ * errno (message in a thread-local buffer)
+ * ============================================================================ */
+
+static thread_local char g_szErrnoMessage[128];
+
+BENCH_CODE(bench_errno) static int64_t parseErrno(uint32_t uInput)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_errno) static uint64_t runErrno(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        const int64_t llValue = parseErrno(aInputs[i]);
+        if (llValue < 0)
+        {
+            ullSum += (uint64_t)errno;
+            errno = 0;
+            continue;
+        }
+        ullSum += (uint64_t)llValue;
+    }
+    return ullSum;
+}
+
+BENCH_CODE(bench_errno_msg) static int64_t parseErrnoMessage(uint32_t uInput)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        const size_t nLength = std::min(strlen(g_szMessage), sizeof(g_szErrnoMessage) - 1);
+        memcpy(g_szErrnoMessage, g_szMessage, nLength);
+        g_szErrnoMessage[nLength] = '\0';
+        errno = EINVAL;
+        return -1;
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_errno_msg) static uint64_t runErrnoMessage(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        const int64_t llValue = parseErrnoMessage(aInputs[i]);
+        if (llValue < 0)
+        {
+            ullSum += (uint64_t)errno + (uint8_t)g_szErrnoMessage[0];
+            errno = 0;
+            continue;
+        }
+        ullSum += (uint64_t)llValue;
+    }
+    return ullSum;
+}
+
+/* ============================================================================
+ * std::error_code (message in a std::string out-parameter)
+ * ============================================================================ */
+
+BENCH_CODE(bench_error_code) static int64_t parseErrorCode(uint32_t uInput, std::error_code& ec)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return -1;
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_error_code) static uint64_t runErrorCode(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        std::error_code ec;
+        const int64_t   llValue = parseErrorCode(aInputs[i], ec);
+        if (ec)
+        {
+            ullSum += (uint64_t)ec.value();
+            continue;
+        }
+        ullSum += (uint64_t)llValue;
+    }
+    return ullSum;
+}
+
+BENCH_CODE(bench_error_code_msg) static int64_t parseErrorCodeMessage(uint32_t uInput, std::error_code& ec,
+                                                                      std::string& strMessage)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        strMessage = g_szMessage;
+        return -1;
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_error_code_msg) static uint64_t runErrorCodeMessage(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        std::error_code ec;
+        std::string     strMessage;
+        const int64_t   llValue = parseErrorCodeMessage(aInputs[i], ec, strMessage);
+        if (ec)
+        {
+            ullSum += (uint64_t)ec.value() + (uint8_t)strMessage[0];
+            continue;
+        }
+        ullSum += (uint64_t)llValue;
+    }
+    return ullSum;
+}
+
+/* ============================================================================
+ * Exceptions
+ * ============================================================================ */
+
+/** Exception without a message: just the code */
+struct BenchError
+{
+    uint64_t ullCode;
+};
+
+BENCH_CODE(bench_exception) static int64_t parseException(uint32_t uInput)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        throw BenchError{ g_ullCode };
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_exception) static uint64_t runException(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        try
+        {
+            ullSum += (uint64_t)parseException(aInputs[i]);
+        }
+        catch (const BenchError& e)
+        {
+            ullSum += e.ullCode;
+        }
+    }
+    return ullSum;
+}
+
+BENCH_CODE(bench_exception_msg) static int64_t parseExceptionMessage(uint32_t uInput)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        throw std::runtime_error(g_szMessage);
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_exception_msg) static uint64_t runExceptionMessage(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        try
+        {
+            ullSum += (uint64_t)parseExceptionMessage(aInputs[i]);
+        }
+        catch (const std::runtime_error& e)
+        {
+            ullSum += (uint8_t)e.what()[0];
+        }
+    }
+    return ullSum;
+}
+
+/* ============================================================================
+ * std::expected
+ * ============================================================================ */
+
+#if defined(__cpp_lib_expected)
+BENCH_CODE(bench_expected) static std::expected<int64_t, std::error_code> parseExpected(uint32_t uInput)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_expected) static uint64_t runExpected(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        const auto result = parseExpected(aInputs[i]);
+        if (!result)
+        {
+            ullSum += (uint64_t)result.error().value();
+            continue;
+        }
+        ullSum += (uint64_t)*result;
+    }
+    return ullSum;
+}
+
+BENCH_CODE(bench_expected_msg) static std::expected<int64_t, std::string> parseExpectedMessage(uint32_t uInput)
+{
+    if (0u != (uInput & BENCH_FAIL_BIT))
+    {
+        return std::unexpected(std::string(g_szMessage));
+    }
+    return benchValue(uInput);
+}
+
+BENCH_CODE(bench_expected_msg) static uint64_t runExpectedMessage(const uint32_t* aInputs, size_t nCalls)
+{
+    uint64_t ullSum = 0;
+    for (size_t i = 0; i < nCalls; ++i)
+    {
+        const auto result = parseExpectedMessage(aInputs[i]);
+        if (!result)
+        {
+            ullSum += (uint8_t)result.error()[0];
+            continue;
+        }
+        ullSum += (uint64_t)*result;
+    }
+    return ullSum;
+}
+#endif
+
+/* ============================================================================
+ * Strategy Table
+ * ============================================================================ */
+
+BENCH_SECTION(bench_cerror)
+BENCH_SECTION(bench_cerror_msg)
+BENCH_SECTION(bench_errno)
+BENCH_SECTION(bench_errno_msg)
+BENCH_SECTION(bench_error_code)
+BENCH_SECTION(bench_error_code_msg)
+BENCH_SECTION(bench_exception)
+BENCH_SECTION(bench_exception_msg)
+#if defined(__cpp_lib_expected)
+BENCH_SECTION(bench_expected)
+BENCH_SECTION(bench_expected_msg)
+#endif
+
+typedef uint64_t (*RunFn)(const uint32_t* aInputs, size_t nCalls);
+
+struct Strategy
+{
+    const char* pszName;
+    int         bMessage;
+    RunFn       pfnRun;
+    size_t      nCodeSize;
+};
+
+static const Strategy g_aStrategies[] = {
+    { "c-error",          0, runCError,           BENCH_CODE_SIZE(bench_cerror)         },
+    { "c-error",          1, runCErrorMessage,    BENCH_CODE_SIZE(bench_cerror_msg)     },
+    { "errno",            0, runErrno,            BENCH_CODE_SIZE(bench_errno)          },
+    { "errno",            1, runErrnoMessage,     BENCH_CODE_SIZE(bench_errno_msg)      },
+    { "std::error_code",  0, runErrorCode,        BENCH_CODE_SIZE(bench_error_code)     },
+    { "std::error_code",  1, runErrorCodeMessage, BENCH_CODE_SIZE(bench_error_code_msg) },
+    { "exceptions",       0, runException,        BENCH_CODE_SIZE(bench_exception)      },
+    { "exceptions",       1, runExceptionMessage, BENCH_CODE_SIZE(bench_exception_msg)  },
+#if defined(__cpp_lib_expected)
+    { "std::expected",    0, runExpected,         BENCH_CODE_SIZE(bench_expected)       },
+    { "std::expected",    1, runExpectedMessage,  BENCH_CODE_SIZE(bench_expected_msg)   },
+#endif
+};
+
+/* ============================================================================
+ * Measurement
+ * ============================================================================ */
+
+/**
+ * @brief Timestamp for single-call latencies: TSC where available (a clock
+ *        read through the vDSO costs tens of nanoseconds), else the clock
+ */
+static inline uint64_t benchTicks(void)
+{
+#if defined(BENCH_HAVE_TSC)
+    return __rdtsc();
+#else
+    return bench_now_ns();
+#endif
+}
+
+/**
+ * @brief Nanoseconds per benchTicks() unit, measured against the monotonic clock
+ */
+static double benchNsPerTick(void)
+{
+#if defined(BENCH_HAVE_TSC)
+    const uint64_t ullStartNs = bench_now_ns();
+    const uint64_t ullStartTicks = benchTicks();
+    uint64_t       ullEndNs;
+
+    do
+    {
+        ullEndNs = bench_now_ns();
+    } while (ullEndNs - ullStartNs < 20000000u);
+    return (double)(ullEndNs - ullStartNs) / (double)(benchTicks() - ullStartTicks);
+#else
+    return 1.0;
+#endif
+}
+
+/**
+ * @brief Inputs with a share of uFailureBp / 10000 failing calls at random positions
+ */
+static void fillInputs(std::vector<uint32_t>& aInputs, uint32_t uFailureBp)
+{
+    uint64_t ullState = 0x9E3779B97F4A7C15ULL;
+
+    for (size_t i = 0; i < aInputs.size(); ++i)
+    {
+        ullState ^= ullState << 13;
+        ullState ^= ullState >> 7;
+        ullState ^= ullState << 17;
+        aInputs[i] = (uint32_t)(ullState & 0xFFFFu);
+        if ((uint32_t)((ullState >> 32) % 10000u) < uFailureBp)
+        {
+            aInputs[i] |= BENCH_FAIL_BIT;
+        }
+    }
+}
+
+/**
+ * @brief Median cost of an empty timed region in ticks (subtracted from single-call latencies)
+ */
+static uint64_t timerOverheadTicks(void)
+{
+    std::vector<uint64_t> aSamples(BENCH_LATENCY_SAMPLES);
+
+    for (size_t i = 0; i < aSamples.size(); ++i)
+    {
+        const uint64_t ullStart = benchTicks();
+        BENCH_BARRIER();
+        aSamples[i] = benchTicks() - ullStart;
+    }
+    std::sort(aSamples.begin(), aSamples.end());
+    return aSamples[aSamples.size() / 2];
+}
+
+static double percentileNs(const std::vector<uint64_t>& aSorted, double dPercentile, double dNsPerTick)
+{
+    const size_t nIndex = (size_t)(dPercentile / 100.0 * (double)(aSorted.size() - 1) + 0.5);
+    return (double)aSorted[nIndex] * dNsPerTick;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t          nCalls = (argc > 1) ? (size_t)strtoull(argv[1], NULL, 10) : BENCH_DEFAULT_CALLS;
+    const size_t          nSamples = std::min<size_t>(nCalls, BENCH_LATENCY_SAMPLES);
+    const double          dNsPerTick = benchNsPerTick();
+    const uint64_t        ullOverhead = timerOverheadTicks();
+    std::vector<uint32_t> aInputs(nCalls);
+    std::vector<uint64_t> aLatencies(nSamples);
+    volatile uint64_t     ullSink = 0;
+
+    printf("c-error comparison benchmark (%zu calls per run)\n", nCalls);
+    printf("========================================\n");
+#if !defined(__cpp_lib_expected)
+    printf("std::expected not available (needs C++23), skipped\n");
+#endif
+    printf("%-16s %-4s %6s %10s %9s %9s %9s\n", "strategy", "msg", "fail%", "Mcalls/s", "p50 ns", "p99 ns",
+           "p99.9 ns");
+
+    for (size_t r = 0; r < sizeof(g_aFailureRates) / sizeof(g_aFailureRates[0]); ++r)
+    {
+        fillInputs(aInputs, g_aFailureRates[r]);
+
+        for (size_t s = 0; s < sizeof(g_aStrategies) / sizeof(g_aStrategies[0]); ++s)
+        {
+            const Strategy& stStrategy = g_aStrategies[s];
+            uint64_t        ullStart;
+            uint64_t        ullElapsed;
+
+            /* Warm-up (first info buffer allocation, exception runtime) */
+            ullSink = ullSink + stStrategy.pfnRun(aInputs.data(), nSamples);
+
+            ullStart = bench_now_ns();
+            ullSink = ullSink + stStrategy.pfnRun(aInputs.data(), nCalls);
+            ullElapsed = bench_now_ns() - ullStart;
+
+            for (size_t i = 0; i < nSamples; ++i)
+            {
+                const uint64_t ullCallStart = benchTicks();
+                ullSink = ullSink + stStrategy.pfnRun(&aInputs[i], 1);
+                const uint64_t ullCallTicks = benchTicks() - ullCallStart;
+                aLatencies[i] = (ullCallTicks > ullOverhead) ? ullCallTicks - ullOverhead : 0;
+            }
+            std::sort(aLatencies.begin(), aLatencies.end());
+
+            printf("%-16s %-4s %6.1f %10.1f %9.1f %9.1f %9.1f\n", stStrategy.pszName,
+                   stStrategy.bMessage ? "yes" : "no", (double)g_aFailureRates[r] / 100.0,
+                   (double)nCalls * 1e3 / (double)ullElapsed, percentileNs(aLatencies, 50.0, dNsPerTick),
+                   percentileNs(aLatencies, 99.0, dNsPerTick), percentileNs(aLatencies, 99.9, dNsPerTick));
+        }
+        printf("\n");
+    }
+
+    printf("Code size of callee + caller loop (bytes, unwind tables excluded)\n");
+    for (size_t s = 0; s < sizeof(g_aStrategies) / sizeof(g_aStrategies[0]); ++s)
+    {
+        if (0 == g_aStrategies[s].nCodeSize)
+        {
+            printf("%-16s %-4s %9s\n", g_aStrategies[s].pszName, g_aStrategies[s].bMessage ? "yes" : "no", "n/a");
+            continue;
+        }
+        printf("%-16s %-4s %9zu\n", g_aStrategies[s].pszName, g_aStrategies[s].bMessage ? "yes" : "no",
+               g_aStrategies[s].nCodeSize);
+    }
+    printf("Timer overhead subtracted from latencies: %.1f ns\n", (double)ullOverhead * dNsPerTick);
+
+    cerror_cleanup_thread_local_buffer();
+    return (0 == ullSink) ? 1 : 0;
+}
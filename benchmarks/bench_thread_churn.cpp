@@ -0,0 +1,225 @@
+/**
+ * @file bench_thread_churn.cpp
+ * @brief Cost and leaks of the info buffer under thread creation and exit
+ *
+ * Threads are created and joined in rounds of BENCH_CONCURRENCY. Each thread
+ * sets copied info of varying sizes (the buffer grows up to a few KiB) and
+ * exits with one of the cleanup strategies:
+ *  - baseline:        no error handling at all (cost of the thread itself)
+ *  - no cleanup:      the thread exits holding its buffer
+ *  - cleanup:         cerror_cleanup_thread_local_buffer() before returning
+ *  - cleanup + pool:  the same with the buffer pool enabled
+ *  - C++ helper:      Chameleon::setLastErrorInfoCopy(), freed by the
+ *                     thread_local helper's destructor
+ *
+ * Per strategy: average start latency (create to first instruction of the
+ * thread), average and p99 exit latency (end of the thread's work to join
+ * returning, cleanup included), allocator calls per thread counted by hooks
+ * installed with cerror_set_allocator(), and bytes still held by the
+ * allocator after all threads are joined (leaked), cross-checked with
+ * cerror_get_memory_stats().
+ *
+ * Usage: bench_thread_churn [threads per strategy]
+ */
+
+#include "bench_common.h"
+
+#include <c-error/lasterror.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BENCH_DEFAULT_THREADS   20000u
+#define BENCH_CONCURRENCY       8u
+#define BENCH_SETS_PER_THREAD   4u
+
+enum ChurnMode
+{
+    CHURN_BASELINE = 0,
+    CHURN_NO_CLEANUP,
+    CHURN_CLEANUP,
+    CHURN_CLEANUP_POOL,
+    CHURN_CPP_HELPER,
+    CHURN_MODE_COUNT
+};
+
+static const char* const g_apszModeNames[CHURN_MODE_COUNT] = {
+    "baseline", "no cleanup", "cleanup", "cleanup + pool", "C++ helper",
+};
+
+/** Info lengths; each thread starts at a different one and cycles */
+static const size_t g_aInfoLengths[] = { 12, 60, 250, 1000, 3000 };
+#define BENCH_INFO_LENGTH_COUNT (sizeof(g_aInfoLengths) / sizeof(g_aInfoLengths[0]))
+
+static std::string g_aInfos[BENCH_INFO_LENGTH_COUNT];
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x21, CERROR_RESOURCE_EXHAUSTED, 0x0001);
+
+/* ============================================================================
+ * Counting Allocator
+ * ============================================================================ */
+
+static std::atomic<uint64_t> g_ullAllocCalls(0);
+static std::atomic<uint64_t> g_ullFreeCalls(0);
+static std::atomic<int64_t>  g_llLiveBytes(0);
+
+static void* countingRealloc(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData)
+{
+    void* pNew = realloc(pBlock, nNewSize);
+
+    (void)pUserData;
+    if (NULL != pNew)
+    {
+        g_ullAllocCalls.fetch_add(1, std::memory_order_relaxed);
+        g_llLiveBytes.fetch_add((int64_t)nNewSize - (int64_t)nOldSize, std::memory_order_relaxed);
+    }
+    return pNew;
+}
+
+static void countingFree(void* pBlock, size_t nSize, void* pUserData)
+{
+    (void)pUserData;
+    free(pBlock);
+    g_ullFreeCalls.fetch_add(1, std::memory_order_relaxed);
+    g_llLiveBytes.fetch_sub((int64_t)nSize, std::memory_order_relaxed);
+}
+
+/* ============================================================================
+ * Thread Body
+ * ============================================================================ */
+
+/**
+ * @brief Timestamps of one thread (written by the thread, read after join)
+ */
+struct ChurnSample
+{
+    uint64_t ullCreateNs;   /**< Before the thread object was constructed */
+    uint64_t ullStartNs;    /**< First instruction of the thread */
+    uint64_t ullDoneNs;     /**< Work done, cleanup still to come */
+    uint64_t ullJoinedNs;   /**< join() returned */
+};
+
+static void churnThread(ChurnMode eMode, size_t nIndex, ChurnSample* pSample)
+{
+    pSample->ullStartNs = bench_now_ns();
+
+    for (size_t i = 0; (CHURN_BASELINE != eMode) && (i < BENCH_SETS_PER_THREAD); ++i)
+    {
+        const std::string& strInfo = g_aInfos[(nIndex + i) % BENCH_INFO_LENGTH_COUNT];
+
+        if (CHURN_CPP_HELPER == eMode)
+        {
+            Chameleon::setLastErrorInfoCopy(g_ullCode, strInfo.c_str());
+        }
+        else
+        {
+            cerror_set_last_info_copy(g_ullCode, strInfo.c_str());
+        }
+    }
+
+    pSample->ullDoneNs = bench_now_ns();
+    if ((CHURN_CLEANUP == eMode) || (CHURN_CLEANUP_POOL == eMode))
+    {
+        cerror_cleanup_thread_local_buffer();
+    }
+}
+
+/* ============================================================================
+ * Measurement
+ * ============================================================================ */
+
+static void runMode(ChurnMode eMode, size_t nThreads)
+{
+    std::vector<ChurnSample> aSamples(nThreads);
+    std::vector<uint64_t>    aExitNs(nThreads);
+    CErrorMemoryStats        stBefore;
+    CErrorMemoryStats        stAfter;
+    uint64_t                 ullStartSum = 0;
+    uint64_t                 ullExitSum = 0;
+
+    if (CHURN_CLEANUP_POOL == eMode)
+    {
+        cerror_pool_enable(1024 * 1024);
+    }
+
+    const uint64_t ullAllocBefore = g_ullAllocCalls.load();
+    const uint64_t ullFreeBefore = g_ullFreeCalls.load();
+    const int64_t  llLiveBefore = g_llLiveBytes.load();
+    cerror_get_memory_stats(&stBefore);
+
+    for (size_t nBase = 0; nBase < nThreads; nBase += BENCH_CONCURRENCY)
+    {
+        const size_t nRound = std::min<size_t>(BENCH_CONCURRENCY, nThreads - nBase);
+        std::thread  aThreads[BENCH_CONCURRENCY];
+
+        for (size_t t = 0; t < nRound; ++t)
+        {
+            ChurnSample* const pSample = &aSamples[nBase + t];
+            pSample->ullCreateNs = bench_now_ns();
+            aThreads[t] = std::thread(churnThread, eMode, nBase + t, pSample);
+        }
+        for (size_t t = 0; t < nRound; ++t)
+        {
+            aThreads[t].join();
+            aSamples[nBase + t].ullJoinedNs = bench_now_ns();
+        }
+    }
+
+    if (CHURN_CLEANUP_POOL == eMode)
+    {
+        /* Cached buffers are not leaked: hand them back before counting */
+        cerror_pool_disable();
+    }
+
+    const uint64_t ullAllocCalls = g_ullAllocCalls.load() - ullAllocBefore;
+    const uint64_t ullFreeCalls = g_ullFreeCalls.load() - ullFreeBefore;
+    const int64_t  llLeaked = g_llLiveBytes.load() - llLiveBefore;
+    cerror_get_memory_stats(&stAfter);
+
+    for (size_t i = 0; i < nThreads; ++i)
+    {
+        ullStartSum += aSamples[i].ullStartNs - aSamples[i].ullCreateNs;
+        aExitNs[i] = aSamples[i].ullJoinedNs - aSamples[i].ullDoneNs;
+        ullExitSum += aExitNs[i];
+    }
+    std::sort(aExitNs.begin(), aExitNs.end());
+
+    printf("%-16s %9.0f %9.0f %9llu %9.3f %9.3f %12lld %12lld\n", g_apszModeNames[eMode],
+           (double)ullStartSum / (double)nThreads, (double)ullExitSum / (double)nThreads,
+           (unsigned long long)aExitNs[(nThreads - 1) * 99 / 100], (double)ullAllocCalls / (double)nThreads,
+           (double)ullFreeCalls / (double)nThreads, (long long)llLeaked,
+           (long long)(stAfter.ullCurrentBytes - stBefore.ullCurrentBytes));
+}
+
+int main(int argc, char** argv)
+{
+    const size_t nThreads = (argc > 1) ? (size_t)strtoull(argv[1], NULL, 10) : BENCH_DEFAULT_THREADS;
+
+    if (0 == nThreads)
+    {
+        return 1;
+    }
+    for (size_t i = 0; i < BENCH_INFO_LENGTH_COUNT; ++i)
+    {
+        g_aInfos[i].assign(g_aInfoLengths[i], (char)('a' + i));
+    }
+    cerror_set_allocator(countingRealloc, countingFree, NULL);
+
+    printf("c-error thread churn benchmark (%zu threads per strategy, %u at a time, %u sets each)\n", nThreads,
+           BENCH_CONCURRENCY, BENCH_SETS_PER_THREAD);
+    printf("========================================\n");
+    printf("%-16s %9s %9s %9s %9s %9s %12s %12s\n", "strategy", "start ns", "exit ns", "exit p99", "allocs/t",
+           "frees/t", "leaked B", "stats B");
+
+    for (int eMode = CHURN_BASELINE; eMode < CHURN_MODE_COUNT; ++eMode)
+    {
+        runMode((ChurnMode)eMode, nThreads);
+    }
+
+    printf("\nexit ns: end of the thread's work to join() returning (cleanup included)\n");
+    printf("leaked B: allocator bytes not freed; stats B: cerror_get_memory_stats() current bytes delta\n");
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file bench_timestamp.c
+ * @brief Cost of cerror_set_last() per clock source (none, coarse, TSC)
+ *
+ * Also reports the raw read cost of each clock and CLOCK_MONOTONIC for
+ * reference. The default (CERROR_CLOCK_NONE) and the coarse clock should
+ * stay below 10 ns per set.
+ */
+
+#include "bench_common.h"
+
+#include <c-error/lasterror.h>
+
+#define BENCH_ITERATIONS 20000000ULL
+
+static const struct
+{
+    CErrorClockSource eSource;
+    const char*       pszName;
+} g_aSources[] = {
+    { CERROR_CLOCK_NONE,   "none"   },
+    { CERROR_CLOCK_COARSE, "coarse" },
+    { CERROR_CLOCK_TSC,    "tsc"    },
+};
+
+int main(void)
+{
+    char     szName[64];
+    uint64_t ullStart;
+    uint64_t ullSink = 0;
+    uint64_t i;
+    size_t   s;
+
+    printf("c-error timestamp benchmark (%llu iterations)\n", (unsigned long long)BENCH_ITERATIONS);
+    printf("========================================\n");
+
+    ullStart = bench_now_ns();
+    for (i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        ullSink += cerror_clock_now_ns();
+        BENCH_BARRIER();
+    }
+    bench_report("read CLOCK_MONOTONIC", BENCH_ITERATIONS, bench_now_ns() - ullStart);
+
+    for (s = 0; s < sizeof(g_aSources) / sizeof(g_aSources[0]); ++s)
+    {
+        if (!cerror_set_clock_source(g_aSources[s].eSource))
+        {
+            printf("%-40s not available\n", g_aSources[s].pszName);
+            continue;
+        }
+
+        if (CERROR_CLOCK_NONE != g_aSources[s].eSource)
+        {
+            ullStart = bench_now_ns();
+            for (i = 0; i < BENCH_ITERATIONS; ++i)
+            {
+                ullSink += cerror_clock_read();
+                BENCH_BARRIER();
+            }
+            snprintf(szName, sizeof(szName), "read %s", g_aSources[s].pszName);
+            bench_report(szName, BENCH_ITERATIONS, bench_now_ns() - ullStart);
+        }
+
+        ullStart = bench_now_ns();
+        for (i = 0; i < BENCH_ITERATIONS; ++i)
+        {
+            cerror_set_last(MAKE_ERROR_CODE(1, 2, 3, 4));
+            BENCH_BARRIER();
+        }
+        snprintf(szName, sizeof(szName), "set (clock %s)", g_aSources[s].pszName);
+        bench_report(szName, BENCH_ITERATIONS, bench_now_ns() - ullStart);
+
+        /* Sanity check: the timestamp is close to now (coarse lags by up to one tick) */
+        if (CERROR_CLOCK_NONE != g_aSources[s].eSource)
+        {
+            printf("%-40s %+.3f ms\n", "  timestamp - now",
+                   ((double)cerror_get_last_timestamp_ns() - (double)cerror_clock_now_ns()) / 1e6);
+        }
+    }
+
+    cerror_set_clock_source(CERROR_CLOCK_NONE);
+    cerror_cleanup_thread_local_buffer();
+    return (0 == ullSink) ? 1 : 0;
+}
@@ -13,6 +13,18 @@ function(target_add_c_error target)
     # Add source files to target
     target_sources(${target} PRIVATE
         "${C_ERROR_SOURCE_DIR}/src/lasterror.c"
+        "${C_ERROR_SOURCE_DIR}/src/allocator.c"
+        "${C_ERROR_SOURCE_DIR}/src/bufferpool.c"
+        "${C_ERROR_SOURCE_DIR}/src/clock.c"
+        "${C_ERROR_SOURCE_DIR}/src/errnomap.c"
+        "${C_ERROR_SOURCE_DIR}/src/errorvec.c"
+        "${C_ERROR_SOURCE_DIR}/src/frames.c"
+        "${C_ERROR_SOURCE_DIR}/src/inject.c"
+        "${C_ERROR_SOURCE_DIR}/src/latency.c"
+        "${C_ERROR_SOURCE_DIR}/src/observer.c"
+        "${C_ERROR_SOURCE_DIR}/src/payload.c"
+        "${C_ERROR_SOURCE_DIR}/src/reduce.c"
+        "${C_ERROR_SOURCE_DIR}/src/sharedinfo.c"
     )
 
     # Add include directories (BUILD_INTERFACE to avoid source path in install exports)
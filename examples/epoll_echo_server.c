@@ -0,0 +1,317 @@
+/**
+ * @file epoll_echo_server.c
+ * @brief Request-scoped error contexts in an epoll event loop
+ *
+ * One server thread multiplexes many connections. Each request is handled in
+ * two steps on different loop iterations: the EPOLLIN callback processes it
+ * (and may set an error), the EPOLLOUT callback echoes the request id back
+ * together with the current error. Between the two steps the loop runs the
+ * callbacks of other connections.
+ *
+ * With the thread's own context those callbacks overwrite each other's error
+ * and replies carry the wrong result. Binding a per-connection ErrorContext
+ * around every callback keeps them apart. Both modes are run and their
+ * throughput compared; both are built with CERROR_ENABLE_CONTEXT_BINDING (see
+ * examples/CMakeLists.txt), so the shared mode pays the binding check too.
+ *
+ * Usage: epoll_echo_server [seconds per mode]
+ */
+
+#define _GNU_SOURCE
+
+#include <c-error/lasterror.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CONNECTION_COUNT 64
+#define EVENT_BATCH      64
+#define FAILURE_PERIOD   8u     /**< Every 8th request fails */
+
+/** Request: client -> server */
+typedef struct {
+    uint32_t uRequestId;
+} Request;
+
+/** Reply: server -> client */
+typedef struct {
+    uint32_t uRequestId;
+    uint32_t uReserved;
+    uint64_t ullError;
+} Reply;
+
+/** Server side of a connection; the context must stay first (64-byte aligned) */
+typedef struct {
+    ErrorContext stErrorCtx;
+    int          nFd;
+    uint32_t     uRequestId;
+} Connection;
+
+typedef struct {
+    int         aServerFds[CONNECTION_COUNT];
+    int         aClientFds[CONNECTION_COUNT];
+    int         bBindContexts;
+    double      dSeconds;
+    uint64_t    ullReplies;
+    uint64_t    ullMisattributed;
+} Run;
+
+static uint64_t expectedError(uint32_t uRequestId)
+{
+    return (0u == uRequestId % FAILURE_PERIOD) ? MAKE_ERROR_CODE(0x01, 0x20, 0x0E, (uint16_t)uRequestId) : 0ULL;
+}
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void watch(int nEpoll, int nOp, int nFd, uint32_t uEvents, void* pData)
+{
+    struct epoll_event ev;
+    ev.events = uEvents;
+    ev.data.ptr = pData;
+    epoll_ctl(nEpoll, nOp, nFd, &ev);
+}
+
+/* ============================================================================
+ * Server
+ * ============================================================================ */
+
+/**
+ * @brief EPOLLIN callback: process the request
+ */
+static void onRequest(Connection* pConn, int nEpoll)
+{
+    char szInfo[64];
+
+    if (0ULL != expectedError(pConn->uRequestId))
+    {
+        snprintf(szInfo, sizeof(szInfo), "request %u rejected", (unsigned)pConn->uRequestId);
+        cerror_set_last_info_copy(expectedError(pConn->uRequestId), szInfo);
+    }
+    else
+    {
+        cerror_clear_last();
+    }
+    watch(nEpoll, EPOLL_CTL_MOD, pConn->nFd, EPOLLOUT, pConn);
+}
+
+/**
+ * @brief EPOLLOUT callback: echo the request id with the current error
+ */
+static void onWritable(Connection* pConn, int nEpoll)
+{
+    Reply stReply;
+
+    stReply.uRequestId = pConn->uRequestId;
+    stReply.uReserved = 0;
+    stReply.ullError = cerror_get_last();
+    (void)send(pConn->nFd, &stReply, sizeof(stReply), MSG_NOSIGNAL);
+    watch(nEpoll, EPOLL_CTL_MOD, pConn->nFd, EPOLLIN, pConn);
+}
+
+static void* serverThread(void* pArg)
+{
+    Run* const         pRun = (Run*)pArg;
+    Connection* const  aConns = (Connection*)aligned_alloc(64, CONNECTION_COUNT * sizeof(Connection));
+    const int          nEpoll = epoll_create1(0);
+    struct epoll_event aEvents[EVENT_BATCH];
+    int                nOpen = CONNECTION_COUNT;
+    int                i;
+
+    for (i = 0; i < CONNECTION_COUNT; ++i)
+    {
+        cerror_context_init(&aConns[i].stErrorCtx);
+        aConns[i].nFd = pRun->aServerFds[i];
+        aConns[i].uRequestId = 0;
+        watch(nEpoll, EPOLL_CTL_ADD, aConns[i].nFd, EPOLLIN, &aConns[i]);
+    }
+
+    while (nOpen > 0)
+    {
+        const int nReady = epoll_wait(nEpoll, aEvents, EVENT_BATCH, -1);
+
+        for (i = 0; i < nReady; ++i)
+        {
+            Connection* const   pConn = (Connection*)aEvents[i].data.ptr;
+            ErrorContext* const pPrevious = pRun->bBindContexts ? cerror_bind_context(&pConn->stErrorCtx) : NULL;
+
+            if (0 != (aEvents[i].events & EPOLLOUT))
+            {
+                onWritable(pConn, nEpoll);
+            }
+            else
+            {
+                Request stRequest;
+
+                if (recv(pConn->nFd, &stRequest, sizeof(stRequest), MSG_WAITALL) == (ssize_t)sizeof(stRequest))
+                {
+                    pConn->uRequestId = stRequest.uRequestId;
+                    onRequest(pConn, nEpoll);
+                }
+                else
+                {
+                    /* Client closed the connection */
+                    epoll_ctl(nEpoll, EPOLL_CTL_DEL, pConn->nFd, NULL);
+                    nOpen--;
+                }
+            }
+
+            if (pRun->bBindContexts)
+            {
+                (void)cerror_bind_context(pPrevious);
+            }
+        }
+    }
+
+    for (i = 0; i < CONNECTION_COUNT; ++i)
+    {
+        cerror_context_destroy(&aConns[i].stErrorCtx);
+    }
+    cerror_cleanup_thread_local_buffer();
+    close(nEpoll);
+    free(aConns);
+    return NULL;
+}
+
+/* ============================================================================
+ * Load Generator
+ * ============================================================================ */
+
+/**
+ * @brief Keep one request in flight per connection for the run's duration
+ */
+static void runClient(Run* pRun)
+{
+    const int          nEpoll = epoll_create1(0);
+    uint32_t           aNextId[CONNECTION_COUNT];
+    struct epoll_event aEvents[EVENT_BATCH];
+    const double       dEnd = nowSeconds() + pRun->dSeconds;
+    int                nActive = CONNECTION_COUNT;
+    int                i;
+
+    for (i = 0; i < CONNECTION_COUNT; ++i)
+    {
+        Request stRequest;
+
+        aNextId[i] = (uint32_t)i * 0x01000000u;
+        stRequest.uRequestId = aNextId[i];
+        (void)send(pRun->aClientFds[i], &stRequest, sizeof(stRequest), MSG_NOSIGNAL);
+        watch(nEpoll, EPOLL_CTL_ADD, pRun->aClientFds[i], EPOLLIN, (void*)(intptr_t)i);
+    }
+
+    while (nActive > 0)
+    {
+        const int nReady = epoll_wait(nEpoll, aEvents, EVENT_BATCH, -1);
+        const int bStop = nowSeconds() >= dEnd;
+
+        for (i = 0; i < nReady; ++i)
+        {
+            const int nConn = (int)(intptr_t)aEvents[i].data.ptr;
+            Reply     stReply;
+            Request   stRequest;
+
+            if (recv(pRun->aClientFds[nConn], &stReply, sizeof(stReply), MSG_WAITALL) != (ssize_t)sizeof(stReply))
+            {
+                continue;
+            }
+            pRun->ullReplies++;
+            if (stReply.uRequestId != aNextId[nConn] || stReply.ullError != expectedError(stReply.uRequestId))
+            {
+                pRun->ullMisattributed++;
+            }
+
+            if (bStop)
+            {
+                epoll_ctl(nEpoll, EPOLL_CTL_DEL, pRun->aClientFds[nConn], NULL);
+                shutdown(pRun->aClientFds[nConn], SHUT_WR);
+                nActive--;
+                continue;
+            }
+            stRequest.uRequestId = ++aNextId[nConn];
+            (void)send(pRun->aClientFds[nConn], &stRequest, sizeof(stRequest), MSG_NOSIGNAL);
+        }
+    }
+    close(nEpoll);
+}
+
+/**
+ * @brief Run one mode and print its throughput
+ *
+ * @return Requests per second
+ */
+static double runMode(int bBindContexts, double dSeconds, uint64_t* pMisattributed)
+{
+    Run       stRun;
+    pthread_t hServer;
+    double    dStart;
+    double    dElapsed;
+    int       i;
+
+    memset(&stRun, 0, sizeof(stRun));
+    stRun.bBindContexts = bBindContexts;
+    stRun.dSeconds = dSeconds;
+    for (i = 0; i < CONNECTION_COUNT; ++i)
+    {
+        int aPair[2];
+        if (0 != socketpair(AF_UNIX, SOCK_STREAM, 0, aPair))
+        {
+            perror("socketpair");
+            exit(1);
+        }
+        stRun.aServerFds[i] = aPair[0];
+        stRun.aClientFds[i] = aPair[1];
+    }
+
+    pthread_create(&hServer, NULL, serverThread, &stRun);
+    dStart = nowSeconds();
+    runClient(&stRun);
+    dElapsed = nowSeconds() - dStart;
+    pthread_join(hServer, NULL);
+
+    for (i = 0; i < CONNECTION_COUNT; ++i)
+    {
+        close(stRun.aServerFds[i]);
+        close(stRun.aClientFds[i]);
+    }
+
+    printf("%-24s %10.0f req/s  %8llu replies  %8llu misattributed\n",
+           bBindContexts ? "per-connection context" : "shared thread context",
+           (double)stRun.ullReplies / dElapsed, (unsigned long long)stRun.ullReplies,
+           (unsigned long long)stRun.ullMisattributed);
+    *pMisattributed = stRun.ullMisattributed;
+    return (double)stRun.ullReplies / dElapsed;
+}
+
+/**
+ * @brief Main example entry point
+ */
+int main(int argc, char** argv)
+{
+    const double dSeconds = (argc > 1) ? atof(argv[1]) : 1.0;
+    uint64_t     ullSharedWrong;
+    uint64_t     ullBoundWrong;
+    double       dShared;
+    double       dBound;
+
+    printf("c-error epoll Echo Server Example\n");
+    printf("========================================\n");
+    printf("%d connections, one request in flight each, 1 in %u requests fails\n\n",
+           CONNECTION_COUNT, FAILURE_PERIOD);
+
+    dShared = runMode(0, dSeconds, &ullSharedWrong);
+    dBound = runMode(1, dSeconds, &ullBoundWrong);
+
+    printf("\nBinding overhead: %+.1f%% throughput\n", (dBound / dShared - 1.0) * 100.0);
+    printf("========================================\n");
+    printf("Example completed!\n");
+
+    /* Request-scoped contexts must never misattribute an error */
+    return (0 == ullBoundWrong) ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file realtime_mode.c
+ * @brief Fixed-capacity (never-allocating) mode for real-time threads
+ *
+ * Installs counting allocator hooks, switches the thread to fixed-capacity
+ * mode and exercises every info API path. Exits with failure if any of them
+ * reached the allocator.
+ */
+
+#include <c-error/lasterror.h>
+#include <stdio.h>
+
+static unsigned g_uAllocatorCalls = 0;
+
+static void* countingRealloc(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData)
+{
+    (void)nOldSize;
+    (void)pUserData;
+    ++g_uAllocatorCalls;
+    return realloc(pBlock, nNewSize);
+}
+
+static void countingFree(void* pBlock, size_t nSize, void* pUserData)
+{
+    (void)nSize;
+    (void)pUserData;
+    ++g_uAllocatorCalls;
+    free(pBlock);
+}
+
+/**
+ * @brief Main example entry point
+ */
+int main(void)
+{
+    char szLong[4 * ERROR_INFO_INLINE_CAPACITY];
+    size_t i;
+    size_t nTruncatedLength;
+
+    printf("c-error Real-time Mode Example\n");
+    printf("========================================\n\n");
+
+    cerror_set_allocator(countingRealloc, countingFree, NULL);
+
+    /* Enter fixed-capacity mode before the real-time section */
+    cerror_set_fixed_info_mode(1);
+    g_uAllocatorCalls = 0;
+
+    /* Short message: copied into the in-context buffer */
+    cerror_set_last_info_copy(MAKE_ERROR_CODE(0x01, 0x10, 0x0D, 0x0001), "buffer underrun");
+    printf("Info: '%s' (truncated: %d)\n", cerror_get_last_info(), cerror_is_last_info_truncated());
+
+    /* Long message with multi-byte characters: truncated on a UTF-8 boundary */
+    for (i = 0; i + 2 < sizeof(szLong); i += 2)
+    {
+        szLong[i] = (char)0xC3;     /* U+00E9 'e acute' */
+        szLong[i + 1] = (char)0xA9;
+    }
+    szLong[i] = '\0';
+    cerror_set_last_info_copy(MAKE_ERROR_CODE(0x01, 0x10, 0x0D, 0x0002), szLong);
+    nTruncatedLength = strlen(cerror_get_last_info());
+    printf("Truncated length: %u bytes (truncated: %d)\n",
+           (unsigned)nTruncatedLength, cerror_is_last_info_truncated());
+
+    cerror_set_last_info(MAKE_ERROR_CODE(0x01, 0x10, 0x0D, 0x0003), "static info");
+    cerror_set_last(MAKE_ERROR_CODE(0x01, 0x10, 0x0D, 0x0004));
+    cerror_clear_last();
+    cerror_cleanup_thread_local_buffer();
+
+    printf("Allocator calls in real-time section: %u (should be 0)\n\n", g_uAllocatorCalls);
+
+    printf("========================================\n");
+    printf("Example completed!\n");
+
+    /* No allocator calls, and no split two-byte characters */
+    return (0 == g_uAllocatorCalls && 0 == nTruncatedLength % 2) ? 0 : 1;
+}
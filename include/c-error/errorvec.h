@@ -0,0 +1,142 @@
+/** @file errorvec.h
+ *  @brief Columnar Per-row Error Vector for Batch Kernels
+ *
+ *  The batch counterpart to cerror_set_last(): a kernel processing N rows
+ *  records a 53-bit code per failed row in a caller-provided column, plus a
+ *  validity bitmap (bit set = row failed, code valid). Bulk operations and
+ *  queries work a 64-row bitmap word at a time with branch-free inner loops,
+ *  so compilers vectorize them and error-free words cost one test.
+ *
+ *  Layout (caller storage):
+ *  | Array      | Length                          | Content                    |
+ *  |:---------- |:------------------------------- |:-------------------------- |
+ *  | pCodes     | nRows                           | Code of each failed row    |
+ *  | pValidity  | CERROR_VECTOR_BITMAP_WORDS(n)   | Bit r % 64 of word r / 64  |
+ *
+ *  Codes of rows whose bit is clear are unspecified.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include "lasterror.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of bitmap words for nRows rows */
+#define CERROR_VECTOR_BITMAP_WORDS(nRows) (((nRows) + 63u) / 64u)
+
+/** Returned by cerror_vector_first() when no row failed */
+#define CERROR_VECTOR_NONE ((size_t)-1)
+
+/**
+ * @brief Error vector over caller-provided columns
+ */
+typedef struct CErrorVector
+{
+    uint64_t* pCodes;       /**< Per-row codes (nRows entries) */
+    uint64_t* pValidity;    /**< Failed-row bitmap (CERROR_VECTOR_BITMAP_WORDS(nRows) words) */
+    size_t    nRows;        /**< Number of rows */
+} CErrorVector;
+
+/**
+ * @brief Initialize a vector over caller storage; all rows start without error
+ */
+void cerror_vector_init(CErrorVector* pVector, uint64_t* pCodes, uint64_t* pValidity, size_t nRows);
+
+/**
+ * @brief Mark all rows as successful (clears the bitmap only)
+ */
+void cerror_vector_reset(CErrorVector* pVector);
+
+/**
+ * @brief Record an error for one row
+ */
+static inline void cerror_vector_set(CErrorVector* pVector, const size_t nRow, const uint64_t ullError)
+{
+    assert(nRow < pVector->nRows);
+    pVector->pCodes[nRow] = ullError & VALID_ERROR_MASK;
+    pVector->pValidity[nRow / 64u] |= 1ULL << (nRow % 64u);
+}
+
+/**
+ * @brief Check whether a row failed
+ */
+static inline int cerror_vector_is_set(const CErrorVector* pVector, const size_t nRow)
+{
+    return 0 != (pVector->pValidity[nRow / 64u] & (1ULL << (nRow % 64u)));
+}
+
+/**
+ * @brief Get the code of a row (0 if the row did not fail)
+ */
+static inline uint64_t cerror_vector_get(const CErrorVector* pVector, const size_t nRow)
+{
+    return cerror_vector_is_set(pVector, nRow) ? pVector->pCodes[nRow] : 0ULL;
+}
+
+/* ============================================================================
+ * Bulk Operations
+ * ============================================================================ */
+
+/**
+ * @brief Record ullError for every row whose flag byte is non-zero
+ *
+ * pFlags is the natural output of a vectorized compare (one byte per row).
+ * Rows that already failed are overwritten.
+ */
+void cerror_vector_set_flags(CErrorVector* pVector, const uint8_t* pFlags, uint64_t ullError);
+
+/**
+ * @brief Record ullError for every row set in pMask (a bitmap shaped like pValidity)
+ *
+ * Rows that already failed are overwritten.
+ */
+void cerror_vector_set_mask(CErrorVector* pVector, const uint64_t* pMask, uint64_t ullError);
+
+/**
+ * @brief Merge another vector of the same length: rows that failed only in pSource take its code
+ *
+ * Rows that already failed in pTarget keep their (earlier) error.
+ */
+void cerror_vector_merge(CErrorVector* pTarget, const CErrorVector* pSource);
+
+/* ============================================================================
+ * Queries
+ * ============================================================================ */
+
+/**
+ * @brief Check whether any row failed
+ */
+int cerror_vector_any(const CErrorVector* pVector);
+
+/**
+ * @brief Get the first failed row (CERROR_VECTOR_NONE if none)
+ */
+size_t cerror_vector_first(const CErrorVector* pVector);
+
+/**
+ * @brief Count the failed rows
+ */
+size_t cerror_vector_count(const CErrorVector* pVector);
+
+/**
+ * @brief Count the failed rows per status
+ *
+ * @param aCounts Receives the count of each 5-bit status (MAX_STATUS + 1 entries, overwritten)
+ */
+void cerror_vector_count_by_status(const CErrorVector* pVector, size_t aCounts[MAX_STATUS + 1]);
+
+/**
+ * @brief Set the thread's last error to the code of the first failed row
+ *
+ * @return First failed row, or CERROR_VECTOR_NONE (last error untouched)
+ */
+size_t cerror_vector_to_last(const CErrorVector* pVector);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,103 @@
+/** @file frames.h
+ *  @brief Scoped Annotation Frames ("while handling tenant 42 / shard 7")
+ *
+ *  A frame is a pointer to a static format plus two integer arguments, pushed
+ *  onto a per-thread stack around a unit of work. Nothing is formatted on
+ *  push: a successful request pays one push and one pop.
+ *
+ *  When an error is set while frames are active, only the stack depth is
+ *  recorded. The frames are copied aside only if a later push would overwrite
+ *  one of them, and are rendered to text only when the error is read.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include "lasterror.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Copy the frames of the last error out of the stack
+ *
+ * Internal: called by cerror_frame_push() before it overwrites a captured frame.
+ */
+void cerror_frames_detach(void);
+
+/**
+ * @brief Push an annotation frame
+ *
+ * @param pszFormat Static printf format (must outlive the error), e.g. "tenant %lld"
+ * @param llArg0 First argument (%lld)
+ * @param llArg1 Second argument (%lld, ignored if the format has only one)
+ */
+static inline void cerror_frame_push(const char* pszFormat, const int64_t llArg0, const int64_t llArg1)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    const uint32_t uDepth = pCtx->uFrameDepth;
+
+    /* The last error still refers to this slot */
+    if (uDepth < pCtx->uFramesPinned)
+    {
+        cerror_frames_detach();
+    }
+
+    if (uDepth < CERROR_MAX_FRAMES)
+    {
+        pCtx->aFrames[uDepth].pszFormat = pszFormat;
+        pCtx->aFrames[uDepth].llArg0 = llArg0;
+        pCtx->aFrames[uDepth].llArg1 = llArg1;
+    }
+    pCtx->uFrameDepth = uDepth + 1u;
+    pCtx->uModeFlags |= CERROR_MODE_FRAMES;
+}
+
+/**
+ * @brief Pop the innermost annotation frame
+ */
+static inline void cerror_frame_pop(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    assert(0u != pCtx->uFrameDepth);
+    if (0u == --pCtx->uFrameDepth)
+    {
+        pCtx->uModeFlags &= ~CERROR_MODE_FRAMES;
+    }
+}
+
+/**
+ * @brief Get the number of frames captured with the last error
+ */
+static inline uint32_t cerror_get_frame_count(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    return (0 != (pCtx->ullLastError & CERROR_FLAG_HAS_FRAMES)) ? pCtx->uFramesCaptured : 0u;
+}
+
+/**
+ * @brief Get the frames captured with the last error, outermost first
+ *
+ * Valid until the next set or push; use cerror_get_frame_count() for the length.
+ */
+static inline const CErrorFrame* cerror_get_frames(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    return (0u != pCtx->uFramesPinned) ? pCtx->aFrames : pCtx->aFrameSnapshot;
+}
+
+/**
+ * @brief Render the frames of the last error as "outer / inner" text
+ *
+ * @return Length of the full rendering (snprintf semantics: output truncated if >= nSize)
+ */
+size_t cerror_frames_render(char* pszBuffer, size_t nSize);
+
+#ifdef __cplusplus
+}
+#endif
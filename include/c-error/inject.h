@@ -0,0 +1,154 @@
+/** @file inject.h
+ *  @brief Fault Injection for Error Path Testing
+ *
+ *  Call sites wrapped in CERROR_INJECT_POINT(code) fail on demand: the macro
+ *  sets the last error to the given code and evaluates to 1 when a rule
+ *  selects the call. Rules match codes by software/component/status and fail
+ *  calls with a probability, on every Nth call, or within a schedule window
+ *  (skip the first calls, stop after a number of injections). Rules can be
+ *  loaded from a config file.
+ *
+ *  While injection is disabled a point costs one load of a read-mostly global
+ *  and a not-taken branch. Define CERROR_NO_INJECT to compile points out.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include "lasterror.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of rules */
+#define CERROR_INJECT_MAX_RULES     16
+
+/** Maximum number of distinct injection points (per-point counters) */
+#define CERROR_INJECT_MAX_POINTS    256
+
+/**
+ * @brief Injection rule
+ *
+ * A call is a candidate if (code & ullMask) == ullMatch and its point has been
+ * reached more than uSkip times. Candidates fail every uEveryNth call (if
+ * non-zero), otherwise with dProbability. A rule stops after uLimit
+ * injections (0: unlimited).
+ */
+typedef struct CErrorInjectRule
+{
+    uint64_t ullMask;       /**< Code bits compared (see cerror_inject_select()) */
+    uint64_t ullMatch;      /**< Expected value of the compared bits */
+    double   dProbability;  /**< Failure probability in [0, 1] (when uEveryNth is 0) */
+    uint32_t uEveryNth;     /**< Fail every Nth candidate call of a point (0: use dProbability) */
+    uint32_t uSkip;         /**< Calls of a point left alone before injection starts */
+    uint32_t uLimit;        /**< Injections after which the rule stops (0: unlimited) */
+} CErrorInjectRule;
+
+/**
+ * @brief Counters of one injection point
+ */
+typedef struct CErrorInjectPointStats
+{
+    const char* pszFile;
+    int         nLine;
+    uint64_t    ullError;       /**< Code the point fails with */
+    uint64_t    ullCalls;       /**< Calls while injection was enabled */
+    uint64_t    ullInjected;    /**< Calls that were failed */
+} CErrorInjectPointStats;
+
+/** uValue is non-zero while injection is enabled (read by CERROR_INJECT_POINT()) */
+extern CErrorFlagLine g_CErrorInjectActive;
+
+/**
+ * @brief Decide whether the point fails, and set the last error if it does
+ *
+ * Internal: called by CERROR_INJECT_POINT() while injection is enabled.
+ *
+ * @return 1 if the call must fail, 0 otherwise
+ */
+int cerror_inject_check(uint64_t ullError, const char* pszFile, int nLine);
+
+#if defined(CERROR_NO_INJECT)
+    #define CERROR_INJECT_POINT(ullError) 0
+#elif defined(__GNUC__) || defined(__clang__)
+    #define CERROR_INJECT_POINT(ullError) \
+        (__builtin_expect(0 != __atomic_load_n(&g_CErrorInjectActive.uValue, __ATOMIC_RELAXED), 0) && \
+         cerror_inject_check((ullError), __FILE__, __LINE__))
+#else
+    #define CERROR_INJECT_POINT(ullError) \
+        (0 != *(volatile uint32_t*)&g_CErrorInjectActive.uValue && cerror_inject_check((ullError), __FILE__, __LINE__))
+#endif
+
+/**
+ * @brief Fill mask and match of a rule from error fields
+ *
+ * @param nSoftwareId Software ID to match, or -1 for any
+ * @param nComponentId Component ID to match, or -1 for any
+ * @param nStatus Status to match, or -1 for any
+ */
+void cerror_inject_select(CErrorInjectRule* pRule, int nSoftwareId, int nComponentId, int nStatus);
+
+/**
+ * @brief Add a rule (configure before enabling injection)
+ *
+ * @return 1 on success, 0 if the rule table is full or the rule is invalid
+ */
+int cerror_inject_add_rule(const CErrorInjectRule* pRule);
+
+/**
+ * @brief Remove all rules (injection must be disabled)
+ */
+void cerror_inject_clear_rules(void);
+
+/**
+ * @brief Parse one config line into a rule
+ *
+ * Format: whitespace-separated key=value pairs, e.g.
+ * "component=0x20 status=14 probability=0.01 skip=100 limit=5".
+ * Keys: software, component, status (selection, default any), probability,
+ * every, skip, limit. Numbers may be decimal or 0x-prefixed hex.
+ *
+ * @return 1 on success, 0 on a syntax error
+ */
+int cerror_inject_parse_rule(const char* pszLine, CErrorInjectRule* pRule);
+
+/**
+ * @brief Load rules from a config file (one rule per line, '#' starts a comment)
+ *
+ * @return Number of rules added, or -1 if the file cannot be read or a line is invalid
+ */
+int cerror_inject_load_config(const char* pszPath);
+
+/**
+ * @brief Enable or disable injection (process-wide)
+ */
+void cerror_inject_enable(int bEnable);
+
+/**
+ * @brief Seed the per-thread random generators
+ *
+ * Applies to all threads: each rederives its stream on its next probability
+ * draw from the seed and its number, threads being numbered from 0 in the
+ * order of their first draw after this call. A run is reproducible when the
+ * seed is set before the threads start drawing and they first draw in the
+ * same order (e.g. a single thread, or threads started one by one).
+ */
+void cerror_inject_seed(uint64_t ullSeed);
+
+/**
+ * @brief Copy the counters of the points reached so far
+ *
+ * @return Number of points (may exceed uMax; only uMax are copied)
+ */
+uint32_t cerror_inject_get_points(CErrorInjectPointStats* aStats, uint32_t uMax);
+
+/**
+ * @brief Zero the counters of all points and rules
+ */
+void cerror_inject_reset_counters(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,6 +23,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include "probes.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -100,101 +102,1080 @@ extern "C" {
  * ============================================================================ */
 
 /**
- * @brief Extract error code field (16 bits, Part A)
+ * @brief Extract error code field (16 bits, Part A)
+ */
+#define GET_ERROR_CODE(ullError) \
+    ((uint16_t)(((ullError) & ERROR_CODE_MASK) >> ERROR_CODE_BIT_POS))
+
+/**
+ * @brief Extract status field (5 bits, Part B)
+ */
+#define GET_STATUS(ullError) \
+    ((uint8_t)(((ullError) & STATUS_MASK) >> STATUS_BIT_POS))
+
+/**
+ * @brief Extract component ID field (11 bits, Part C-3)
+ */
+#define GET_COMPONENT_ID(ullError) \
+    ((uint16_t)(((ullError) & COMPONENT_MASK) >> COMPONENT_BIT_POS))
+
+/**
+ * @brief Extract software ID field (8 bits, Part C-2)
+ */
+#define GET_SOFTWARE_ID(ullError) \
+    ((uint8_t)(((ullError) & SOFTWARE_ID_MASK) >> SOFTWARE_ID_BIT_POS))
+
+/* ============================================================================
+ * Error Code Testing Macros
+ * ============================================================================ */
+
+/**
+ * @brief Check if error code is within valid 53-bit range
+ */
+#define IS_VALID_ERROR_CODE(ullError) \
+    (((ullError) & ~VALID_ERROR_MASK) == 0ULL)
+
+/* ============================================================================
+ * Context Flags (stored in the upper 11 bits of ullLastError)
+ * ============================================================================ */
+
+/** Flags live above the 53-bit code and are never returned by cerror_get_last() */
+#define CERROR_FLAGS_MASK           (~VALID_ERROR_MASK)
+
+/** Context holds an error or info (set by every setter, so a clear context is exactly 0) */
+#define CERROR_FLAG_DIRTY           (1ULL << 63)
+
+/** Info string was cut short (out of memory or capacity limit) */
+#define CERROR_FLAG_INFO_TRUNCATED  (1ULL << 53)
+
+/** Structured payload (see payload.h) belongs to the current error */
+#define CERROR_FLAG_HAS_PAYLOAD     (1ULL << 54)
+
+/** Context holds a reference to a CErrorSharedInfo (released when the error is replaced) */
+#define CERROR_FLAG_SHARED_INFO     (1ULL << 55)
+
+/** Error code field holds an errno value; info is rendered with strerror_r on first read */
+#define CERROR_FLAG_FROM_ERRNO      (1ULL << 56)
+
+/** Error was set by cerror_wrap_last(): aCauses[0 .. uCauseCount - 1] hold its causes */
+#define CERROR_FLAG_HAS_CAUSES      (1ULL << 57)
+
+/** Annotation frames (see frames.h) were active when the error was set */
+#define CERROR_FLAG_HAS_FRAMES      (1ULL << 58)
+
+/** ullTimestamp holds the time the error was set (clock source other than CERROR_CLOCK_NONE) */
+#define CERROR_FLAG_HAS_TIMESTAMP   (1ULL << 59)
+
+/* ============================================================================
+ * Thread-local Storage Structures
+ * ============================================================================ */
+
+/** Cache line alignment for the hot fields of the error context */
+#if defined(__cplusplus)
+    #define CERROR_ALIGN_CACHELINE alignas(64)
+#elif defined(_MSC_VER)
+    #define CERROR_ALIGN_CACHELINE __declspec(align(64))
+#elif defined(__GNUC__) || defined(__clang__)
+    #define CERROR_ALIGN_CACHELINE __attribute__((aligned(64)))
+#else
+    #define CERROR_ALIGN_CACHELINE _Alignas(64)
+#endif
+
+/**
+ * @brief Read-mostly flag on a cache line of its own
+ *
+ * The member alignment pads the struct to 64 bytes, so no other variable can
+ * share the line and invalidate it for the readers.
+ */
+typedef struct CErrorFlagLine
+{
+    CERROR_ALIGN_CACHELINE uint32_t uValue;
+} CErrorFlagLine;
+
+/** Persistent context state (uModeFlags): buffer is above the shrink threshold, release on clear */
+#define CERROR_MODE_OVERSIZED       (1u << 0)
+
+/** Persistent context state (uModeFlags): sticky first-error mode, later sets only count */
+#define CERROR_MODE_STICKY_FIRST    (1u << 1)
+
+/** Persistent context state (uModeFlags): the latest set was suppressed by sticky mode */
+#define CERROR_MODE_SUPPRESSED      (1u << 2)
+
+/** Observers are running on this context (their sets and clears are ignored) */
+#define CERROR_MODE_NOTIFYING       (1u << 3)
+
+/** uModeFlags bits that route cerror_clear_last() through the slow path */
+#define CERROR_MODE_CLEAR_MASK      (CERROR_MODE_OVERSIZED | CERROR_MODE_STICKY_FIRST | CERROR_MODE_NOTIFYING)
+
+/** Persistent context state (uModeFlags): annotation frames are pushed (uFrameDepth > 0) */
+#define CERROR_MODE_FRAMES          (1u << 4)
+
+/** uModeFlags bits that route the setters through cerror_set_last_slow() */
+#define CERROR_MODE_SET_MASK        (CERROR_MODE_STICKY_FIRST | CERROR_MODE_NOTIFYING)
+
+/** uModeFlags bits that keep cerror_try_set_last() off its inline store (frames are captured out of line) */
+#define CERROR_MODE_SET_SLOW_MASK   (CERROR_MODE_SET_MASK | CERROR_MODE_FRAMES)
+
+/** Process-wide set hook (g_CErrorSetHooks): a clock source is selected, sets record timestamps */
+#define CERROR_HOOK_TIMESTAMP       (1u << 0)
+
+/** Process-wide set hook (g_CErrorSetHooks): at least one observer is registered */
+#define CERROR_HOOK_OBSERVERS       (1u << 1)
+
+/** Initial buffer capacity for dynamic allocation (lazy initialization) */
+#define ERROR_INFO_INITIAL_CAPACITY 128
+
+/**
+ * Capacity of the in-context info buffer: the low-memory emergency buffer and
+ * the storage of fixed-capacity (never-allocating) mode. Override at compile time.
+ */
+#ifndef ERROR_INFO_INLINE_CAPACITY
+#define ERROR_INFO_INLINE_CAPACITY 64
+#endif
+
+/** Size of the in-context area of the structured payload (spills to the heap beyond) */
+#ifndef CERROR_PAYLOAD_INLINE_CAPACITY
+#define CERROR_PAYLOAD_INLINE_CAPACITY 64
+#endif
+
+/** Number of causes kept inline per thread (deeper chains keep the root and the nearest causes) */
+#ifndef CERROR_MAX_CAUSE_DEPTH
+#define CERROR_MAX_CAUSE_DEPTH 4
+#endif
+
+#if CERROR_MAX_CAUSE_DEPTH < 1
+#error "CERROR_MAX_CAUSE_DEPTH must be at least 1"
+#endif
+
+/** Depth of the per-thread annotation frame stack (deeper frames are counted, not recorded) */
+#ifndef CERROR_MAX_FRAMES
+#define CERROR_MAX_FRAMES 8
+#endif
+
+/** Info bytes a CErrorSavedState holds without allocating (longer info is copied to the heap) */
+#ifndef CERROR_SAVED_INFO_CAPACITY
+#define CERROR_SAVED_INFO_CAPACITY 64
+#endif
+
+/** Heap bytes a thread allocates or frees before the process-wide count is updated */
+#ifndef CERROR_MEMORY_PUBLISH_BYTES
+#define CERROR_MEMORY_PUBLISH_BYTES 16384
+#endif
+
+/** Policy value meaning "no limit" (max capacity) or "never shrink" (shrink threshold) */
+#define CERROR_CAPACITY_UNLIMITED ((size_t)-1)
+
+/**
+ * @brief Growth policy of the dynamic info buffer (process-wide)
+ *
+ * Capacities are rounded up to the next power of 2, clamped to
+ * [nInitialCapacity, nMaxCapacity]. Messages longer than nMaxCapacity - 1 are
+ * truncated. A buffer larger than nShrinkThreshold is released on the next
+ * message whose rounded capacity fits below the threshold, or on
+ * cerror_clear_last(). nShrinkThreshold must not be below nInitialCapacity.
+ */
+typedef struct CErrorCapacityPolicy
+{
+    size_t nInitialCapacity;    /**< Minimum capacity of the first allocation (default ERROR_INFO_INITIAL_CAPACITY) */
+    size_t nMaxCapacity;        /**< Hard capacity limit, longer messages are truncated (default unlimited) */
+    size_t nShrinkThreshold;    /**< High-water mark above which the buffer is released again (default never) */
+} CErrorCapacityPolicy;
+
+/**
+ * @brief Allocation hook: realloc semantics with the old size passed in
+ *
+ * Called with pBlock == NULL to allocate. Returns NULL on failure (old block untouched).
+ */
+typedef void* (*CErrorReallocFn)(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData);
+
+/**
+ * @brief Deallocation hook: receives the size the block was allocated with
+ */
+typedef void (*CErrorFreeFn)(void* pBlock, size_t nSize, void* pUserData);
+
+/**
+ * @brief Allocator used for the info buffer (NULL functions mean "use the default")
+ */
+typedef struct CErrorAllocator
+{
+    CErrorReallocFn pfnRealloc;     /**< Allocate / reallocate */
+    CErrorFreeFn    pfnFree;        /**< Free */
+    void*           pUserData;      /**< Passed to both functions (e.g. an arena handle) */
+} CErrorAllocator;
+
+/**
+ * @brief Release callback of a shared info blob (called once, by the last reference)
+ */
+typedef void (*CErrorReleaseFn)(const char* pszInfo, void* pUserData);
+
+/**
+ * @brief Reference-counted external info string (opaque)
+ *
+ * Lets a large, already allocated diagnostic blob be attached to the error
+ * context and handed to other threads without copying.
+ */
+typedef struct CErrorSharedInfo CErrorSharedInfo;
+
+/**
+ * @brief Caller-provided arena for per-request info storage
+ *
+ * While bound to a thread, copied info strings are bump-allocated from the
+ * arena and stay valid until the arena is reset, so a request can retain
+ * several errors without per-message malloc/free.
+ */
+typedef struct CErrorArena
+{
+    char*  pBase;       /**< Arena memory (owned by the caller) */
+    size_t nCapacity;   /**< Size of the arena memory in bytes */
+    size_t nUsed;       /**< Bytes handed out since the last reset */
+} CErrorArena;
+
+/**
+ * @brief One link of a cause chain (code and info of a wrapped error)
+ */
+typedef struct CErrorCause
+{
+    uint64_t    ullError;               /**< 53-bit error code of the cause */
+    const char* pszInfo;                /**< Info of the cause (never NULL) */
+} CErrorCause;
+
+/**
+ * @brief Clock source of error timestamps (process-wide)
+ */
+typedef enum CErrorClockSource {
+    CERROR_CLOCK_NONE   = 0,    /**< No timestamps (default) */
+    CERROR_CLOCK_COARSE = 1,    /**< CLOCK_MONOTONIC_COARSE (tick resolution, vDSO read) */
+    CERROR_CLOCK_TSC    = 2     /**< Invariant TSC, converted with a calibrated rate (x86 only) */
+} CErrorClockSource;
+
+/**
+ * @brief Source location of a set call (see CERROR_SET_LAST())
+ */
+typedef struct CErrorCallsite
+{
+    const char* pszFile;
+    const char* pszFunction;
+    int         nLine;
+} CErrorCallsite;
+
+/**
+ * @brief Observer of stored errors
+ *
+ * @param ullError 53-bit error code
+ * @param pszInfo Info string (never NULL)
+ * @param pSite Source location, or NULL if the error was set without one
+ * @param pUserData Value passed at registration
+ */
+typedef void (*CErrorObserverFn)(uint64_t ullError, const char* pszInfo, const CErrorCallsite* pSite, void* pUserData);
+
+/**
+ * @brief Annotation frame: static format plus up to two integer arguments (see frames.h)
+ */
+typedef struct CErrorFrame
+{
+    const char* pszFormat;              /**< Static printf format using %lld for the arguments */
+    int64_t     llArg0;                 /**< First argument */
+    int64_t     llArg1;                 /**< Second argument */
+} CErrorFrame;
+
+/**
+ * @brief Saved error state (plain struct, see cerror_save())
+ *
+ * Info owned by the context is copied into szInfo (or the heap when longer),
+ * external info is kept by pointer and shared info by reference.
+ */
+typedef struct CErrorSavedState
+{
+    uint64_t          ullError;         /**< Saved code and flags (0 = no error) */
+    const char*       pszInfo;          /**< Saved info (external, szInfo or pHeapInfo) */
+    char*             pHeapInfo;        /**< Heap copy of a long info (NULL if none) */
+    size_t            nHeapSize;        /**< Size of pHeapInfo */
+    CErrorSharedInfo* pSharedInfo;      /**< Retained shared info (NULL if none) */
+    uint64_t          ullTimestamp;     /**< Saved set time (raw clock value) */
+    uint32_t          uErrorCount;      /**< Saved sticky-mode error count */
+    uint32_t          uModeFlags;       /**< Saved per-error mode bits (CERROR_MODE_SUPPRESSED) */
+    char              szInfo[CERROR_SAVED_INFO_CAPACITY]; /**< Inline copy of a short info */
+} CErrorSavedState;
+
+/**
+ * @brief Error context structure with dynamic error info buffer
+ *
+ * The buffer is lazily allocated (starts as NULL) and grows by 2x when needed.
+ * If growing fails, the message is truncated into the existing buffer or, when
+ * there is none, into the in-context buffer. In fixed-capacity mode the
+ * in-context buffer is the only storage and no allocation ever happens.
+ *
+ * Define CERROR_NO_HEAP to put every thread in fixed-capacity mode.
+ *
+ * Everything the set/clear fast paths touch sits in the first cache line.
+ * ullLastError doubles as the dirty word: it is 0 exactly when the context is
+ * clear, so clearing a clear context is one load and a branch.
+ */
+typedef struct ErrorContext
+{
+    CERROR_ALIGN_CACHELINE
+    uint64_t    ullLastError;           /**< 53-bit error code + flags (0 = clear) */
+    const char* pszLastErrorInfo;       /**< Pointer to error info string (may point to external, internal static, or internal dynamic buffer) */
+    char*       pszLastErrorInfoBuffer; /**< Dynamically allocated buffer for copied strings (NULL initially) */
+    size_t      nBufferCapacity;        /**< Current capacity of the dynamic buffer (0 initially) */
+    size_t      nCopyLimit;             /**< Capacity usable by the inline copy path (0 while the buffer is above the shrink threshold) */
+    uint32_t    uModeFlags;             /**< Persistent state bits (CERROR_MODE_*) */
+    uint32_t    uFrameDepth;            /**< Pushed annotation frames (may exceed CERROR_MAX_FRAMES) */
+    uint64_t    ullTimestamp;           /**< Raw clock value at set time (valid only with CERROR_FLAG_HAS_TIMESTAMP) */
+    uint64_t    ullBytesCopied;         /**< Info bytes copied since the last fold (see CErrorMemoryStats) */
+    CErrorAllocator stAllocator;        /**< Thread allocator for the buffer (zero = process-wide allocator) */
+    CErrorArena*    pArena;             /**< Bound arena for copied info (NULL = use the buffer) */
+    CErrorSharedInfo* pSharedInfo;      /**< Referenced shared info (valid only with CERROR_FLAG_SHARED_INFO) */
+    unsigned char* pPayload;            /**< Structured payload bytes (in-context area or heap spill, NULL initially) */
+    size_t      nPayloadSize;           /**< Bytes used in pPayload (valid only with CERROR_FLAG_HAS_PAYLOAD) */
+    size_t      nPayloadCapacity;       /**< Capacity of pPayload */
+    char        szInlineInfo[ERROR_INFO_INLINE_CAPACITY]; /**< In-context storage: low-memory fallback and fixed-capacity mode */
+    unsigned char aPayloadInline[CERROR_PAYLOAD_INLINE_CAPACITY]; /**< In-context payload area */
+    uint32_t    uErrorCount;            /**< Errors set since the last clear (counted in sticky first-error mode) */
+    uint32_t    uCauseCount;            /**< Entries used in aCauses (valid only with CERROR_FLAG_HAS_CAUSES) */
+    CErrorCause aCauses[CERROR_MAX_CAUSE_DEPTH]; /**< Cause chain, root first */
+    uint32_t    uFramesCaptured;        /**< Frames of the last error (valid only with CERROR_FLAG_HAS_FRAMES) */
+    uint32_t    uFramesPinned;          /**< Stack entries the last error still refers to (0 once copied to aFrameSnapshot) */
+    CErrorFrame aFrames[CERROR_MAX_FRAMES];       /**< Annotation frame stack, outermost first */
+    CErrorFrame aFrameSnapshot[CERROR_MAX_FRAMES]; /**< Frames of the last error once the stack moved on */
+    size_t      nHeapBytes;             /**< Heap bytes held by the info buffer and payload spill */
+    size_t      nPeakHeapBytes;         /**< Highest nHeapBytes since the last fold */
+    size_t      nPublishedHeapBytes;    /**< Part of nHeapBytes included in the process-wide count */
+    uint64_t    ullGrowEvents;          /**< Info buffer and payload growths since the last fold */
+} ErrorContext;
+
+/* ============================================================================
+ * Thread-local Storage Declaration
+ * ============================================================================ */
+/**
+ * @brief Thread-local error context variable and request-scoped binding
+ *
+ * Uses compiler-specific thread-local storage keywords for zero-overhead access.
+ * Access the context through cerror_ctx(), which honours the binding.
+ * The buffer (pszLastErrorInfoBuffer) is lazily allocated and must be manually
+ * freed before thread exit by calling cerror_cleanup_thread_local_buffer().
+ *
+ * The binding pointer exists only with CERROR_ENABLE_CONTEXT_BINDING; a
+ * translation unit built with the define does not link against a library
+ * built without it.
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__) 
+    /* C11 standard thread-local storage */
+    extern _Thread_local ErrorContext g_LastErrorCtx;
+    #if defined(CERROR_ENABLE_CONTEXT_BINDING)
+        extern _Thread_local ErrorContext* g_pBoundErrorCtx;
+    #endif
+#elif defined(_MSC_VER)
+    /* Microsoft Visual C++ */
+    extern __declspec(thread) ErrorContext g_LastErrorCtx;
+    #if defined(CERROR_ENABLE_CONTEXT_BINDING)
+        extern __declspec(thread) ErrorContext* g_pBoundErrorCtx;
+    #endif
+#elif defined(__GNUC__) || defined(__clang__)
+    /* GCC and Clang */
+    extern __thread ErrorContext g_LastErrorCtx;
+    #if defined(CERROR_ENABLE_CONTEXT_BINDING)
+        extern __thread ErrorContext* g_pBoundErrorCtx;
+    #endif
+#else
+    #error "Thread-local storage not supported on this compiler"
+#endif
+
+/* ============================================================================
+ * Request-scoped Contexts
+ * ============================================================================ */
+/*
+ * Binding is compiled in with CERROR_ENABLE_CONTEXT_BINDING (define it for
+ * every translation unit: the accessors are inline). It costs a thread-local
+ * pointer load and a branch on every inline path; without the define
+ * cerror_ctx() is the address of g_LastErrorCtx and the binding API below
+ * does not exist.
+ */
+
+/**
+ * @brief Get the current error context of the calling thread
+ *
+ * The context bound with cerror_bind_context(), or the thread's own
+ * g_LastErrorCtx if none is bound. Every API call operates on this context.
+ */
+static inline ErrorContext* cerror_ctx(void)
+{
+#if defined(CERROR_ENABLE_CONTEXT_BINDING)
+    ErrorContext* const pBound = g_pBoundErrorCtx;
+    return (NULL != pBound) ? pBound : &g_LastErrorCtx;
+#else
+    return &g_LastErrorCtx;
+#endif
+}
+
+#if defined(CERROR_ENABLE_CONTEXT_BINDING)
+
+/**
+ * @brief Bind a request-owned context as the current context of the calling thread
+ *
+ * Lets an event loop keep the error state of each request apart while it
+ * interleaves many requests on one thread: bind the request's context before
+ * running its callback and restore the previous binding afterwards. The swap
+ * itself is two thread-local accesses; the main cost is the check that every
+ * other call makes in cerror_ctx().
+ *
+ * @param pCtx Context initialized with cerror_context_init(), or NULL for the thread's own context
+ * @return Previous binding (NULL: the thread's own context), to be passed back afterwards
+ */
+static inline ErrorContext* cerror_bind_context(ErrorContext* pCtx)
+{
+    ErrorContext* const pPrevious = g_pBoundErrorCtx;
+    g_pBoundErrorCtx = pCtx;
+    return pPrevious;
+}
+
+/**
+ * @brief Return the calling thread to its own context
+ */
+static inline void cerror_unbind_context(void)
+{
+    g_pBoundErrorCtx = NULL;
+}
+
+/**
+ * @brief Initialize a request-owned context (no error, no buffers)
+ *
+ * The context must be 64-byte aligned like ErrorContext itself: a static or
+ * automatic object, aligned_alloc(), or a member of such a struct.
+ */
+void cerror_context_init(ErrorContext* pCtx);
+
+/**
+ * @brief Free the buffers of a request-owned context
+ *
+ * Equivalent to cerror_cleanup_thread_local_buffer() on a bound context. The
+ * context must not be bound on any thread; it may be re-initialized afterwards.
+ */
+void cerror_context_destroy(ErrorContext* pCtx);
+#endif /* CERROR_ENABLE_CONTEXT_BINDING */
+
+/**
+ * @brief Cleanup the dynamic buffer in thread-local error context
+ *
+ * Call this function before thread exit to free the dynamically allocated buffer.
+ * Failure to call this function will result in memory leak (buffer only, not the context).
+ */
+void cerror_cleanup_thread_local_buffer(void);
+
+/**
+ * @brief Slow path of cerror_set_last_info_copy() (buffer growth and low-memory fallback)
+ *
+ * Internal: called only when the message does not fit into the current buffer.
+ * The error code must already be stored.
+ */
+void cerror_set_last_info_copy_slow(const char* pszErrorInfo, size_t nLength);
+
+/**
+ * @brief Drop the context's reference to its shared info
+ *
+ * Internal: called by the setters when CERROR_FLAG_SHARED_INFO is set.
+ */
+void cerror_drop_shared_info(void);
+
+/**
+ * @brief Slow path of cerror_clear_last() (shared info, oversized buffer, sticky mode, observers)
+ */
+void cerror_clear_last_slow(void);
+
+/**
+ * @brief Slow path of the setters (shared info, sticky first-error mode, observers, frames, timestamps)
+ *
+ * Internal: called by cerror_try_set_last().
+ *
+ * @return 1 if the error was stored, 0 if sticky mode kept the first error or observers are running
+ */
+int cerror_set_last_slow(const uint64_t ullError);
+
+/**
+ * @brief Slow path of cerror_set_last_at(): cerror_set_last_slow(), then the probe and the observers
+ */
+void cerror_set_last_at_slow(const uint64_t ullError, const CErrorCallsite* pSite);
+
+/**
+ * @brief CERROR_HOOK_* bits of the process-wide features that act on every set
+ *
+ * Set by cerror_set_clock_source() and the observer registry, read by every
+ * set: a full cache line of its own, away from written data.
+ */
+extern CErrorFlagLine g_CErrorSetHooks;
+
+/**
+ * @brief Load g_CErrorSetHooks
+ *
+ * Internal: a relaxed load (a plain mov). The observer snapshot and the
+ * clock state are loaded with their own ordering once a hook is taken.
+ */
+static inline uint32_t cerror_load_set_hooks(void)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(&g_CErrorSetHooks.uValue, __ATOMIC_RELAXED);
+#else
+    return *(volatile uint32_t*)&g_CErrorSetHooks.uValue;
+#endif
+}
+
+/**
+ * @brief Process-wide clock source (read by every set, written by cerror_set_clock_source())
+ */
+extern CErrorClockSource g_CErrorClockSource;
+
+/**
+ * @brief Read the configured clock (raw ticks for TSC, nanoseconds otherwise)
+ *
+ * Internal: called by the setters when timestamps are enabled.
+ */
+uint64_t cerror_clock_read(void);
+
+/**
+ * @brief Render deferred info text (strerror_r for errno-based errors) into the buffer
+ *
+ * Internal: called by cerror_get_last_info() on first read.
+ */
+const char* cerror_render_lazy_info(void);
+
+/**
+ * @brief Add the time since ullStartTicks to the calling thread's histogram of the error's component
+ *
+ * Internal: called by the set-with-info setters when compiled with
+ * CERROR_ENABLE_LATENCY_HISTOGRAM (see latency.h).
+ */
+void cerror_latency_record(uint64_t ullError, uint64_t ullStartTicks);
+
+/* ============================================================================
+ * Reference-counted Shared Info
+ * ============================================================================ */
+
+/**
+ * @brief Wrap an external info string in a reference-counted holder
+ *
+ * @param pszInfo Null-terminated info (ownership passes to the holder)
+ * @param pfnRelease Called with (pszInfo, pUserData) when the last reference goes (NULL allowed)
+ * @param pUserData Passed to pfnRelease
+ * @return Holder with one reference owned by the caller, or NULL on allocation failure
+ */
+CErrorSharedInfo* cerror_shared_info_create(const char* pszInfo, CErrorReleaseFn pfnRelease, void* pUserData);
+
+/**
+ * @brief Add a reference (thread-safe)
+ */
+void cerror_shared_info_retain(CErrorSharedInfo* pShared);
+
+/**
+ * @brief Drop a reference; the last one calls the release callback (thread-safe)
+ */
+void cerror_shared_info_release(CErrorSharedInfo* pShared);
+
+/**
+ * @brief Get the info string of a shared holder
+ */
+const char* cerror_shared_info_get(const CErrorSharedInfo* pShared);
+
+/**
+ * @brief Set error code with shared info (no copy)
+ *
+ * The context takes its own reference and drops it when the error is replaced,
+ * cleared or cleaned up. The caller keeps its reference.
+ */
+void cerror_set_last_info_shared(const uint64_t ullError, CErrorSharedInfo* pShared);
+
+/**
+ * @brief Get a new reference to the shared info of the last error
+ *
+ * @return Retained holder (release with cerror_shared_info_release()), or NULL
+ *         if the last error has no shared info
+ */
+CErrorSharedInfo* cerror_get_last_info_shared(void);
+
+/**
+ * @brief Set the process-wide growth policy of the info buffer
+ *
+ * Call at startup, before other threads set errors. Threads pick up the new
+ * policy on their next buffer growth, shrink or clear.
+ *
+ * @param pPolicy New policy (NULL restores the defaults)
+ * @return 1 on success, 0 if the policy is invalid (initial capacity 0 or above max,
+ *         shrink threshold below the initial capacity)
+ */
+int cerror_set_capacity_policy(const CErrorCapacityPolicy* pPolicy);
+
+/**
+ * @brief Get the process-wide growth policy of the info buffer
+ */
+void cerror_get_capacity_policy(CErrorCapacityPolicy* pPolicy);
+
+/**
+ * @brief Release the dynamic buffer if it is above the shrink threshold
+ *
+ * Called by cerror_clear_last() after a spike. Must not be called while the
+ * current info points into the buffer.
+ */
+void cerror_trim_thread_local_buffer(void);
+
+/**
+ * @brief Switch the calling thread to fixed-capacity (never-allocating) mode
+ *
+ * Copied info goes into the in-context buffer of ERROR_INFO_INLINE_CAPACITY
+ * bytes; longer messages are truncated on a UTF-8 boundary and flagged with
+ * CERROR_FLAG_INFO_TRUNCATED. While enabled, no API path calls the allocator.
+ * Enabling releases the thread's heap buffer, so call it before entering the
+ * real-time section. With CERROR_ENABLE_LATENCY_HISTOGRAM, enabling also
+ * allocates the thread's latency histograms (cerror_latency_prepare_thread()).
+ * Has no other effect when compiled with CERROR_NO_HEAP.
+ *
+ * @param bEnable Non-zero to enable, zero to return to the dynamic buffer
+ */
+void cerror_set_fixed_info_mode(int bEnable);
+
+/**
+ * @brief Check whether the calling thread is in fixed-capacity mode
+ */
+int cerror_is_fixed_info_mode(void);
+
+/**
+ * @brief Switch the calling thread to sticky first-error mode
+ *
+ * While enabled, the first error since the last clear is kept: later setters
+ * leave the code, info and payload untouched and only increase the error
+ * count, so call sites need no check-before-set. Toggling the mode clears
+ * the last error.
+ *
+ * @param bEnable Non-zero to keep the first error, zero to return to last-error semantics
+ */
+void cerror_set_sticky_first_mode(int bEnable);
+
+/**
+ * @brief Check whether the calling thread is in sticky first-error mode
+ */
+int cerror_is_sticky_first_mode(void);
+
+/**
+ * @brief Select the clock used to timestamp every set error
+ *
+ * Call at startup, before other threads set errors. The first selection of
+ * CERROR_CLOCK_TSC calibrates the TSC against CLOCK_MONOTONIC (about 10 ms).
+ *
+ * @return 1 on success, 0 if the source is not available (TSC missing or not invariant)
+ */
+int cerror_set_clock_source(CErrorClockSource eSource);
+
+/**
+ * @brief Get the configured clock source
+ */
+CErrorClockSource cerror_get_clock_source(void);
+
+/**
+ * @brief Get the current time in the base of error timestamps (CLOCK_MONOTONIC nanoseconds)
+ */
+uint64_t cerror_clock_now_ns(void);
+
+/**
+ * @brief Get the time the last error was set, in CLOCK_MONOTONIC nanoseconds
+ *
+ * @return Timestamp, or 0 if the error was set without a clock source
+ */
+uint64_t cerror_get_last_timestamp_ns(void);
+
+/**
+ * @brief Get the number of errors set since the last clear (sticky first-error mode only, else 0)
+ */
+static inline uint32_t cerror_get_error_count(void)
+{
+    return cerror_ctx()->uErrorCount;
+}
+
+/* ============================================================================
+ * Arena-backed Info Storage
+ * ============================================================================ */
+
+/**
+ * @brief Initialize an arena over caller-owned memory
+ */
+void cerror_arena_init(CErrorArena* pArena, void* pMemory, size_t nCapacity);
+
+/**
+ * @brief Release all messages of the arena at once (O(1))
+ *
+ * Info strings previously handed out from the arena become invalid. If the
+ * calling thread's current info lives in the arena, it is cleared.
+ */
+void cerror_arena_reset(CErrorArena* pArena);
+
+/**
+ * @brief Bind an arena to the calling thread (NULL unbinds)
+ *
+ * While bound, cerror_set_last_info_copy() bump-allocates from the arena. A
+ * message that does not fit is truncated into the remaining space; once the
+ * arena is exhausted, the thread's buffer is used as usual.
+ */
+void cerror_bind_arena(CErrorArena* pArena);
+
+/**
+ * @brief Get the arena bound to the calling thread (NULL if none)
+ */
+CErrorArena* cerror_get_bound_arena(void);
+
+/* ============================================================================
+ * Allocator Hooks
+ * ============================================================================ */
+
+/**
+ * @brief Set the process-wide allocator for info buffers
+ *
+ * Call at startup, before any thread allocates a buffer. Cached pool buffers
+ * are released to the previous allocator. Both functions NULL restores libc.
+ * The switch is refused while blocks of the previous allocator are live
+ * (info buffers, payload spills, shared info, observer tables, latency
+ * histograms): they would be freed through the new one. Clean up the
+ * threads that hold them first.
+ *
+ * @return 1 on success, 0 if only one of the functions is NULL or blocks are still live
+ */
+int cerror_set_allocator(CErrorReallocFn pfnRealloc, CErrorFreeFn pfnFree, void* pUserData);
+
+/**
+ * @brief Set the allocator for the calling thread's info buffer
+ *
+ * The thread's current buffer is freed with the allocator that provided it.
+ * Thread-allocated buffers bypass the pool. Both functions NULL reverts the
+ * thread to the process-wide allocator.
+ *
+ * @return 1 on success, 0 if only one of the functions is NULL
+ */
+int cerror_set_thread_allocator(CErrorReallocFn pfnRealloc, CErrorFreeFn pfnFree, void* pUserData);
+
+/* ============================================================================
+ * Info Buffer Pool (opt-in, process-wide)
+ * ============================================================================ */
+
+/** Smallest pooled size class: 2^4 = 16 bytes */
+#define CERROR_POOL_MIN_CLASS_SHIFT 4u
+/** Largest pooled size class: 2^16 = 64 KiB (larger buffers bypass the pool) */
+#define CERROR_POOL_MAX_CLASS_SHIFT 16u
+
+/**
+ * @brief Info buffer pool statistics
+ *
+ * Hit rate is ullHits / (ullHits + ullMisses).
+ */
+typedef struct CErrorPoolStats
+{
+    uint64_t ullHits;           /**< Allocations served from a free list */
+    uint64_t ullMisses;         /**< Pooled-class allocations that fell back to malloc */
+    uint64_t ullReturned;       /**< Buffers put back on a free list */
+    uint64_t ullDiscarded;      /**< Buffers freed because the pool was full */
+    uint64_t ullBytesHeld;      /**< Bytes currently cached in the pool */
+    uint64_t ullBuffersHeld;    /**< Buffers currently cached in the pool */
+} CErrorPoolStats;
+
+/**
+ * @brief Enable recycling of info buffers across threads
+ *
+ * Buffers released by buffer growth, trimming or cerror_cleanup_thread_local_buffer()
+ * are kept on per-size-class free lists (O(1) push/pop under a short spin
+ * lock) and reused by other threads.
+ * Only buffers of the process-wide allocator are pooled.
+ *
+ * @param nMaxBytesHeld Upper bound of bytes cached in the pool (excess buffers are freed)
+ */
+void cerror_pool_enable(size_t nMaxBytesHeld);
+
+/**
+ * @brief Disable the pool and free all cached buffers
+ */
+void cerror_pool_disable(void);
+
+/**
+ * @brief Get pool statistics (hit rate, bytes held)
+ */
+void cerror_pool_get_stats(CErrorPoolStats* pStats);
+
+/* ============================================================================
+ * Memory Accounting
+ * ============================================================================ */
+/**
+ * Each context counts the heap bytes held by its info buffer and payload
+ * spill, their peak, growth events and info bytes copied. Growth and bytes
+ * copied are folded into process-wide totals when the context is cleaned up
+ * (cerror_cleanup_thread_local_buffer() or cerror_context_destroy()); bytes
+ * held are tracked process-wide on every allocation and free.
+ */
+
+/**
+ * @brief Memory footprint counters
+ */
+typedef struct CErrorMemoryStats
+{
+    uint64_t ullCurrentBytes;   /**< Heap bytes held now (info buffers and payload spills) */
+    uint64_t ullPeakBytes;      /**< Highest ullCurrentBytes */
+    uint64_t ullGrowEvents;     /**< Info buffer and payload growths (first allocation included) */
+    uint64_t ullBytesCopied;    /**< Info bytes passed to cerror_set_last_info_copy() */
+} CErrorMemoryStats;
+
+/**
+ * @brief Memory exporter, called with the process-wide counters
+ */
+typedef void (*CErrorMemoryExporterFn)(const CErrorMemoryStats* pStats, void* pUserData);
+
+/**
+ * @brief Get the counters of the current context (since its last cleanup)
+ */
+void cerror_get_thread_memory_stats(CErrorMemoryStats* pStats);
+
+/**
+ * @brief Get the process-wide counters
+ *
+ * Each live thread publishes its bytes held once they moved by
+ * CERROR_MEMORY_PUBLISH_BYTES, so bytes held lag every live thread by less
+ * than that; the peak includes each thread's peak at its publishes. Growth
+ * events and bytes copied cover contexts cleaned up so far. Live threads are
+ * folded in completely when they call cerror_cleanup_thread_local_buffer().
+ */
+void cerror_get_memory_stats(CErrorMemoryStats* pStats);
+
+/**
+ * @brief Set the memory exporter (call at startup; NULL removes it)
+ *
+ * The exporter receives the process-wide counters from
+ * cerror_export_memory_stats() and after every thread's cleanup.
+ */
+void cerror_set_memory_exporter(CErrorMemoryExporterFn pfnExporter, void* pUserData);
+
+/**
+ * @brief Pass the process-wide counters to the exporter (if set)
+ */
+void cerror_export_memory_stats(void);
+
+/* ============================================================================
+ * Observer Hooks
+ * ============================================================================ */
+/**
+ * Observers (metrics, tracing, logging) see every error stored by a set call,
+ * after its info is in place. While none is registered, a set costs one load
+ * of a read-mostly global and a not-taken branch.
+ *
+ * The observer list is an immutable snapshot replaced on registration
+ * (RCU-style), so notification takes no lock. Replaced snapshots are retired
+ * rather than freed; cerror_reclaim_observers() frees them once no thread can
+ * still be notifying. An observer cannot change the error it is notified of:
+ * sets, clears and restores made from inside it are ignored, so the info
+ * passed to the next observer stays valid.
+ */
+
+/**
+ * @brief Notify all observers of the error just stored
+ *
+ * Internal: called by the setters when observers are registered.
+ */
+void cerror_notify_observers(const CErrorCallsite* pSite);
+
+/**
+ * @brief Register an observer (thread-safe, may be called at any time)
+ *
+ * @return 1 on success, 0 on allocation failure
+ */
+int cerror_add_observer(CErrorObserverFn pfnObserver, void* pUserData);
+
+/**
+ * @brief Unregister an observer (thread-safe)
+ *
+ * Threads that are notifying right now may still call it once.
+ *
+ * @return 1 if it was registered, 0 otherwise
+ */
+int cerror_remove_observer(CErrorObserverFn pfnObserver, void* pUserData);
+
+/**
+ * @brief Free retired observer snapshots
+ *
+ * Call only at a quiescent point: no thread may be inside a set call (e.g.
+ * after joining workers, or at shutdown).
  */
-#define GET_ERROR_CODE(ullError) \
-    ((uint16_t)(((ullError) & ERROR_CODE_MASK) >> ERROR_CODE_BIT_POS))
+void cerror_reclaim_observers(void);
 
 /**
- * @brief Extract status field (5 bits, Part B)
+ * @brief Set the last error and report it to observers with the callsite
  */
-#define GET_STATUS(ullError) \
-    ((uint8_t)(((ullError) & STATUS_MASK) >> STATUS_BIT_POS))
+#define CERROR_SET_LAST(ullError) \
+    do { \
+        static const CErrorCallsite cerror_site_ = { __FILE__, __func__, __LINE__ }; \
+        cerror_set_last_at((ullError), &cerror_site_); \
+    } while (0)
 
 /**
- * @brief Extract component ID field (11 bits, Part C-3)
+ * @brief cerror_set_last_info() with the callsite
  */
-#define GET_COMPONENT_ID(ullError) \
-    ((uint16_t)(((ullError) & COMPONENT_MASK) >> COMPONENT_BIT_POS))
+#define CERROR_SET_LAST_INFO(ullError, pszErrorInfo) \
+    do { \
+        static const CErrorCallsite cerror_site_ = { __FILE__, __func__, __LINE__ }; \
+        cerror_set_last_info_at((ullError), (pszErrorInfo), &cerror_site_); \
+    } while (0)
 
 /**
- * @brief Extract software ID field (8 bits, Part C-2)
+ * @brief cerror_set_last_info_copy() with the callsite
  */
-#define GET_SOFTWARE_ID(ullError) \
-    ((uint8_t)(((ullError) & SOFTWARE_ID_MASK) >> SOFTWARE_ID_BIT_POS))
+#define CERROR_SET_LAST_INFO_COPY(ullError, pszErrorInfo) \
+    do { \
+        static const CErrorCallsite cerror_site_ = { __FILE__, __func__, __LINE__ }; \
+        cerror_set_last_info_copy_at((ullError), (pszErrorInfo), &cerror_site_); \
+    } while (0)
 
 /* ============================================================================
- * Error Code Testing Macros
+ * Inline Function Implementations (New C-Style API)
  * ============================================================================ */
 
 /**
- * @brief Check if error code is within valid 53-bit range
+ * @brief Attach the active annotation frames to the error being stored
+ *
+ * Internal: pCtx is the current context. Only the depth is recorded. The
+ * frames stay on the stack until a push would overwrite one of them (see
+ * cerror_frame_push()).
+ *
+ * @return Flag bits to store with the error (CERROR_FLAG_HAS_FRAMES or 0)
  */
-#define IS_VALID_ERROR_CODE(ullError) \
-    (((ullError) & ~VALID_ERROR_MASK) == 0ULL)
+static inline uint64_t cerror_capture_frames(ErrorContext* pCtx)
+{
+    const uint32_t uDepth = pCtx->uFrameDepth;
+    const uint32_t uCount = (uDepth < CERROR_MAX_FRAMES) ? uDepth : CERROR_MAX_FRAMES;
 
-/* ============================================================================
- * Thread-local Storage Structures
- * ============================================================================ */
+    if (0u == uDepth)
+    {
+        return 0ULL;
+    }
+    pCtx->uFramesCaptured = uCount;
+    pCtx->uFramesPinned = uCount;
+    return CERROR_FLAG_HAS_FRAMES;
+}
 
-/** Initial buffer capacity for dynamic allocation (lazy initialization) */
-#define ERROR_INFO_INITIAL_CAPACITY 128
+/**
+ * @brief Record the set time of the error being stored
+ *
+ * Internal: pCtx is the current context. One load and a branch while
+ * timestamps are disabled (the inline setters skip it through
+ * CERROR_HOOK_TIMESTAMP).
+ *
+ * @return Flag bits to store with the error (CERROR_FLAG_HAS_TIMESTAMP or 0)
+ */
+static inline uint64_t cerror_capture_timestamp(ErrorContext* pCtx)
+{
+    if (CERROR_CLOCK_NONE == g_CErrorClockSource)
+    {
+        return 0ULL;
+    }
+    pCtx->ullTimestamp = cerror_clock_read();
+    return CERROR_FLAG_HAS_TIMESTAMP;
+}
 
 /**
- * @brief Error context structure with dynamic error info buffer
+ * @brief Report the error just stored to the observers
  *
- * The buffer is lazily allocated (starts as NULL) and grows by 2x when needed.
+ * Internal: one load and a branch while no observer is registered.
  */
-typedef struct ErrorContext
+static inline void cerror_observe(const CErrorCallsite* pSite)
 {
-    uint64_t    ullLastError;           /**< 53-bit error code + flags */
-    const char* pszLastErrorInfo;       /**< Pointer to error info string (may point to external, internal static, or internal dynamic buffer) */
-    char*       pszLastErrorInfoBuffer; /**< Dynamically allocated buffer for copied strings (NULL initially) */
-    size_t      nBufferCapacity;        /**< Current capacity of the dynamic buffer (0 initially) */
-} ErrorContext;
+    if (0 != (cerror_load_set_hooks() & CERROR_HOOK_OBSERVERS))
+    {
+        cerror_notify_observers(pSite);
+    }
+}
+
+/** Clocks of the latency histograms */
+#define CERROR_LATENCY_CLOCK_UNKNOWN    0u  /**< Not chosen yet */
+#define CERROR_LATENCY_CLOCK_TSC        1u  /**< Invariant TSC ticks */
+#define CERROR_LATENCY_CLOCK_MONOTONIC  2u  /**< CLOCK_MONOTONIC nanoseconds */
+
+/** uValue is the CERROR_LATENCY_CLOCK_* read by cerror_latency_ticks() */
+extern CErrorFlagLine g_CErrorLatencyClock;
 
-/* ============================================================================
- * Thread-local Storage Declaration
- * ============================================================================ */
 /**
- * @brief Thread-local error context variable
+ * @brief Choose the clock of the latency histograms (checks the TSC for invariance once)
  *
- * Uses compiler-specific thread-local storage keywords for zero-overhead access.
- * The buffer (pszLastErrorInfoBuffer) is lazily allocated and must be manually
- * freed before thread exit by calling cerror_cleanup_thread_local_buffer().
+ * Internal: called by cerror_latency_ticks() on first use.
+ *
+ * @return CERROR_LATENCY_CLOCK_TSC or CERROR_LATENCY_CLOCK_MONOTONIC
  */
-#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__) 
-    /* C11 standard thread-local storage */
-    extern _Thread_local ErrorContext g_LastErrorCtx;
-#elif defined(_MSC_VER)
-    /* Microsoft Visual C++ */
-    extern __declspec(thread) ErrorContext g_LastErrorCtx;
-#elif defined(__GNUC__) || defined(__clang__)
-    /* GCC and Clang */
-    extern __thread ErrorContext g_LastErrorCtx;
+uint32_t cerror_latency_clock_init(void);
+
+/**
+ * @brief Read the clock of the latency histograms
+ *
+ * Internal: TSC ticks on x86 with GCC or Clang when the TSC is invariant (a
+ * few cycles), CLOCK_MONOTONIC nanoseconds otherwise.
+ */
+static inline uint64_t cerror_latency_ticks(void)
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    uint32_t uClock = __atomic_load_n(&g_CErrorLatencyClock.uValue, __ATOMIC_RELAXED);
+
+    if (__builtin_expect(CERROR_LATENCY_CLOCK_UNKNOWN == uClock, 0))
+    {
+        uClock = cerror_latency_clock_init();
+    }
+    if (__builtin_expect(CERROR_LATENCY_CLOCK_TSC == uClock, 1))
+    {
+        return __builtin_ia32_rdtsc();
+    }
+#endif
+    return cerror_clock_now_ns();
+}
+
+/** Time a set-with-info call (compiled out unless CERROR_ENABLE_LATENCY_HISTOGRAM is defined) */
+#if defined(CERROR_ENABLE_LATENCY_HISTOGRAM)
+    #define CERROR_LATENCY_BEGIN()          const uint64_t ullLatencyStart_ = cerror_latency_ticks()
+    #define CERROR_LATENCY_END(ullError)    cerror_latency_record((ullError), ullLatencyStart_)
 #else
-    #error "Thread-local storage not supported on this compiler"
+    #define CERROR_LATENCY_BEGIN()          ((void)0)
+    #define CERROR_LATENCY_END(ullError)    ((void)0)
 #endif
 
 /**
- * @brief Cleanup the dynamic buffer in thread-local error context
+ * @brief Set the thread-local last error code, reporting whether it was stored
  *
- * Call this function before thread exit to free the dynamically allocated buffer.
- * Failure to call this function will result in memory leak (buffer only, not the context).
+ * @return 1 if stored, 0 if sticky first-error mode kept an earlier error
  */
-void cerror_cleanup_thread_local_buffer(void);
+static inline int cerror_try_set_last(const uint64_t ullError)
+{
+    ErrorContext* const pCtx = cerror_ctx();
 
-/* ============================================================================
- * Inline Function Implementations (New C-Style API)
- * ============================================================================ */
+    /* One branch: shared info, sticky mode, frames and timestamps are handled out of line */
+    if (0 != ((pCtx->ullLastError & CERROR_FLAG_SHARED_INFO) | (pCtx->uModeFlags & CERROR_MODE_SET_SLOW_MASK) |
+              (cerror_load_set_hooks() & CERROR_HOOK_TIMESTAMP)))
+    {
+        return cerror_set_last_slow(ullError);
+    }
+    /* Store only valid 53-bit error code (mask off upper 11 bits, clears flags) */
+    pCtx->ullLastError = (ullError & VALID_ERROR_MASK) | CERROR_FLAG_DIRTY;
+    return 1;
+}
+
+/**
+ * @brief Set the thread-local last error code, reporting pSite to observers (see CERROR_SET_LAST())
+ */
+static inline void cerror_set_last_at(const uint64_t ullError, const CErrorCallsite* pSite)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    /* One branch: everything but the plain store (observers included) is handled out of line */
+    if (0 != ((pCtx->ullLastError & CERROR_FLAG_SHARED_INFO) | (pCtx->uModeFlags & CERROR_MODE_SET_SLOW_MASK) |
+              cerror_load_set_hooks()))
+    {
+        cerror_set_last_at_slow(ullError, pSite);
+        return;
+    }
+    pCtx->ullLastError = (ullError & VALID_ERROR_MASK) | CERROR_FLAG_DIRTY;
+    CERROR_PROBE2(set, ullError, NULL);
+}
 
 /**
  * @brief Set the thread-local last error code
  */
 static inline void cerror_set_last(const uint64_t ullError)
 {
-    /* Store only valid 53-bit error code (mask off upper 11 bits) */
-    g_LastErrorCtx.ullLastError = ullError & VALID_ERROR_MASK;
+    cerror_set_last_at(ullError, NULL);
 }
 
 /**
@@ -202,7 +1183,7 @@ static inline void cerror_set_last(const uint64_t ullError)
  */
 static inline uint64_t cerror_get_last(void)
 {
-    return g_LastErrorCtx.ullLastError;
+    return cerror_ctx()->ullLastError & VALID_ERROR_MASK;
 }
 
 /**
@@ -210,13 +1191,25 @@ static inline uint64_t cerror_get_last(void)
  */
 static inline void cerror_clear_last(void)
 {
-    g_LastErrorCtx.ullLastError = 0ULL;
-    g_LastErrorCtx.pszLastErrorInfo = NULL;
-    /* Clear buffer to prevent info leakage */
-    if (NULL != g_LastErrorCtx.pszLastErrorInfoBuffer)
+    ErrorContext* const pCtx = cerror_ctx();
+    const uint64_t ullState = pCtx->ullLastError;
+
+    /* Already clear: one load and a branch */
+    if (0ULL == ullState)
+    {
+        return;
+    }
+
+    CERROR_PROBE2(clear, ullState & VALID_ERROR_MASK, pCtx->pszLastErrorInfo);
+    if (0 != ((ullState & CERROR_FLAG_SHARED_INFO) | (pCtx->uModeFlags & CERROR_MODE_CLEAR_MASK)))
     {
-        g_LastErrorCtx.pszLastErrorInfoBuffer[0] = '\0';
+        cerror_clear_last_slow();
+        return;
     }
+
+    /* Dirty: two stores into the first cache line (info reads as "" from now on) */
+    pCtx->ullLastError = 0ULL;
+    pCtx->pszLastErrorInfo = NULL;
 }
 
 /**
@@ -224,7 +1217,7 @@ static inline void cerror_clear_last(void)
  */
 static inline uint16_t cerror_get_last_code(void)
 {
-    return GET_ERROR_CODE(g_LastErrorCtx.ullLastError);
+    return GET_ERROR_CODE(cerror_ctx()->ullLastError);
 }
 
 /**
@@ -232,7 +1225,7 @@ static inline uint16_t cerror_get_last_code(void)
  */
 static inline uint8_t cerror_get_last_status(void)
 {
-    return GET_STATUS(g_LastErrorCtx.ullLastError);
+    return GET_STATUS(cerror_ctx()->ullLastError);
 }
 
 /**
@@ -240,7 +1233,7 @@ static inline uint8_t cerror_get_last_status(void)
  */
 static inline uint16_t cerror_get_last_component_id(void)
 {
-    return GET_COMPONENT_ID(g_LastErrorCtx.ullLastError);
+    return GET_COMPONENT_ID(cerror_ctx()->ullLastError);
 }
 
 /**
@@ -248,7 +1241,25 @@ static inline uint16_t cerror_get_last_component_id(void)
  */
 static inline uint8_t cerror_get_last_software_id(void)
 {
-    return GET_SOFTWARE_ID(g_LastErrorCtx.ullLastError);
+    return GET_SOFTWARE_ID(cerror_ctx()->ullLastError);
+}
+
+/**
+ * @brief cerror_set_last_info() reporting pSite to observers (see CERROR_SET_LAST_INFO())
+ */
+static inline void cerror_set_last_info_at(const uint64_t ullError, const char* pszErrorInfo, const CErrorCallsite* pSite)
+{
+    CERROR_LATENCY_BEGIN();
+
+    if (!cerror_try_set_last(ullError))
+    {
+        return;
+    }
+    /* Store pointer to constant string (no copy, NULL allowed) */
+    cerror_ctx()->pszLastErrorInfo = pszErrorInfo;
+    CERROR_LATENCY_END(ullError);
+    CERROR_PROBE2(set_info, ullError, pszErrorInfo);
+    cerror_observe(pSite);
 }
 
 /**
@@ -256,70 +1267,76 @@ static inline uint8_t cerror_get_last_software_id(void)
  */
 static inline void cerror_set_last_info(const uint64_t ullError, const char* pszErrorInfo)
 {
-    cerror_set_last(ullError);
-    /* Store pointer to constant string (no copy, NULL allowed) */
-    g_LastErrorCtx.pszLastErrorInfo = pszErrorInfo;
+    cerror_set_last_info_at(ullError, pszErrorInfo, NULL);
 }
 
 /**
  * @brief Set thread-local error code with info string (copy string content)
  *
- * Uses Small String Optimization (SSO) to avoid allocation for short strings.
- * For longer strings, uses lazy-allocated dynamic buffer with 2x growth strategy.
+ * Copies into the lazy-allocated dynamic buffer (2x growth strategy, see
+ * CErrorCapacityPolicy), the bound arena, or, in fixed-capacity mode, the
+ * in-context buffer. Growth and shrinking are handled out of line; if the
+ * buffer cannot hold the message (allocation failure or max capacity), it is
+ * truncated and CERROR_FLAG_INFO_TRUNCATED is set. The stored info therefore
+ * always belongs to the stored code. pSite is reported to observers (see
+ * CERROR_SET_LAST_INFO_COPY()).
  */
-static inline void cerror_set_last_info_copy(const uint64_t ullError, const char* pszErrorInfo)
+static inline void cerror_set_last_info_copy_at(const uint64_t ullError, const char* pszErrorInfo, const CErrorCallsite* pSite)
 {
+    ErrorContext* const pCtx = cerror_ctx();
+    CERROR_LATENCY_BEGIN();
+
     if (NULL == pszErrorInfo)
     {
         assert(NULL != pszErrorInfo);
         return;
     }
 
-    cerror_set_last(ullError);
+    if (!cerror_try_set_last(ullError))
+    {
+        return;
+    }
 
     /* Calculate required capacity (including null terminator) */
     const size_t nLength = strlen(pszErrorInfo);
 
-    /* Fallback: Dynamic allocation for longer strings */
-    const size_t nRequiredCapacity = nLength + 1;
-
-    /* Lazy allocation or reallocation if needed */
-    if (nRequiredCapacity > g_LastErrorCtx.nBufferCapacity)
+    pCtx->ullBytesCopied += nLength;
+    if (nLength >= pCtx->nCopyLimit)
+    {
+        cerror_set_last_info_copy_slow(pszErrorInfo, nLength);
+    }
+    else
     {
-        size_t n = nRequiredCapacity;
-        // 32-bit hack to round up to next power of 2
-        n--; 
-        n |= n >> 1;
-        n |= n >> 2;
-        n |= n >> 4;
-        n |= n >> 8;
-        n |= n >> 16;
-        n++;
-
-        size_t nNewCapacity = (n > ERROR_INFO_INITIAL_CAPACITY) ? n : ERROR_INFO_INITIAL_CAPACITY;
-        
-        char* pNewBuffer = (char*)realloc(g_LastErrorCtx.pszLastErrorInfoBuffer, nNewCapacity);
-        assert(pNewBuffer != NULL);
-
-        if (pNewBuffer != NULL)
-        {
-            g_LastErrorCtx.pszLastErrorInfoBuffer = pNewBuffer;
-            g_LastErrorCtx.nBufferCapacity = nNewCapacity;
-        }
-        else
-        {
-            /* Allocation failed: keep old buffer (if any), but can't store new message */
-            /* In a real system, we might set a fallback "Out of memory" error here */
-            return;
-        }
+        /* Copy string to buffer with null termination */
+        memcpy(pCtx->pszLastErrorInfoBuffer, pszErrorInfo, nLength);
+        pCtx->pszLastErrorInfoBuffer[nLength] = '\0';
+
+        /* Point to the buffer */
+        pCtx->pszLastErrorInfo = pCtx->pszLastErrorInfoBuffer;
     }
+    CERROR_LATENCY_END(ullError);
+    CERROR_PROBE2(set_info_copy, ullError, pszErrorInfo);
+    cerror_observe(pSite);
+}
 
-    /* Copy string to buffer with null termination */
-    memcpy(g_LastErrorCtx.pszLastErrorInfoBuffer, pszErrorInfo, nLength);
-    g_LastErrorCtx.pszLastErrorInfoBuffer[nLength] = '\0';
+/**
+ * @brief Set thread-local error code with info string (copy string content)
+ *
+ * See cerror_set_last_info_copy_at().
+ */
+static inline void cerror_set_last_info_copy(const uint64_t ullError, const char* pszErrorInfo)
+{
+    cerror_set_last_info_copy_at(ullError, pszErrorInfo, NULL);
+}
 
-    /* Point to the buffer */
-    g_LastErrorCtx.pszLastErrorInfo = g_LastErrorCtx.pszLastErrorInfoBuffer;
+/**
+ * @brief Check whether the last copied info string was truncated
+ *
+ * @return Non-zero if the info was cut short (allocation failure or max capacity)
+ */
+static inline int cerror_is_last_info_truncated(void)
+{
+    return 0 != (cerror_ctx()->ullLastError & CERROR_FLAG_INFO_TRUNCATED);
 }
 
 /**
@@ -327,8 +1344,180 @@ static inline void cerror_set_last_info_copy(const uint64_t ullError, const char
  */
 static inline const char* cerror_get_last_info(void)
 {
+    ErrorContext* const pCtx = cerror_ctx();
+
     /* Return pointer directly (NULL if no info) */ 
-    return NULL == g_LastErrorCtx.pszLastErrorInfo ? "" : g_LastErrorCtx.pszLastErrorInfo;
+    if (NULL == pCtx->pszLastErrorInfo)
+    {
+        /* errno-based errors produce their text only when somebody reads it */
+        return (0 != (pCtx->ullLastError & CERROR_FLAG_FROM_ERRNO)) ? cerror_render_lazy_info() : "";
+    }
+    return pCtx->pszLastErrorInfo;
+}
+
+/* ============================================================================
+ * Save / Restore
+ * ============================================================================ */
+
+/**
+ * @brief Slow path of cerror_save() (the context holds an error)
+ */
+void cerror_save_slow(CErrorSavedState* pSaved);
+
+/**
+ * @brief Slow path of cerror_restore() (the slot holds an error)
+ */
+void cerror_restore_slow(CErrorSavedState* pSaved);
+
+/**
+ * @brief Release a saved state without restoring it
+ */
+void cerror_discard_saved(CErrorSavedState* pSaved);
+
+/**
+ * @brief Save the last error so cleanup code cannot clobber it
+ *
+ * Saves the code, info, truncation/errno flags, timestamp and sticky-mode
+ * count. Payload, causes and annotation frames are not saved. Info up to
+ * CERROR_SAVED_INFO_CAPACITY - 1 bytes is copied without allocating. Every
+ * save must be paired with cerror_restore() or cerror_discard_saved().
+ */
+static inline void cerror_save(CErrorSavedState* pSaved)
+{
+    if (0ULL == cerror_ctx()->ullLastError)
+    {
+        pSaved->ullError = 0ULL;
+        return;
+    }
+    cerror_save_slow(pSaved);
+}
+
+/**
+ * @brief Make the saved error the last error again (consumes the slot)
+ *
+ * Replaces whatever error cleanup code left behind; a slot saved from a clear
+ * context clears it.
+ */
+static inline void cerror_restore(CErrorSavedState* pSaved)
+{
+    if (0ULL == pSaved->ullError)
+    {
+        cerror_clear_last();
+        return;
+    }
+    cerror_restore_slow(pSaved);
+}
+
+/* ============================================================================
+ * Cause Chains
+ * ============================================================================ */
+
+/**
+ * @brief Set a new error that keeps the current one as its cause
+ *
+ * The current (code, info) is pushed onto the thread's inline cause chain and
+ * ullError becomes the last error, with constant info (no copy, NULL allowed).
+ * Copied info of the causes stays valid because wrapping never touches the
+ * info buffer. The chain lives until the next set or clear. When it is full,
+ * the root is kept and the nearest cause replaces the previous one. Without a
+ * current error this is cerror_set_last_info().
+ */
+static inline void cerror_wrap_last(const uint64_t ullError, const char* pszErrorInfo)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    const uint64_t ullPrevious = pCtx->ullLastError;
+    uint32_t uDepth;
+    CERROR_LATENCY_BEGIN();
+
+    if (0ULL == (ullPrevious & VALID_ERROR_MASK))
+    {
+        cerror_set_last_info(ullError, pszErrorInfo);
+        return;
+    }
+
+    /* Sticky first-error mode keeps the current error (and only counts this one), so do observers */
+    if (0 != (pCtx->uModeFlags & CERROR_MODE_SET_MASK))
+    {
+        (void)cerror_set_last_slow(ullError);
+        return;
+    }
+
+    uDepth = (0 != (ullPrevious & CERROR_FLAG_HAS_CAUSES)) ? pCtx->uCauseCount : 0u;
+    if (uDepth >= CERROR_MAX_CAUSE_DEPTH)
+    {
+        uDepth = CERROR_MAX_CAUSE_DEPTH - 1;
+    }
+
+    /* cerror_get_last_info() also renders deferred errno text before the code is replaced */
+    pCtx->aCauses[uDepth].pszInfo = cerror_get_last_info();
+    pCtx->aCauses[uDepth].ullError = ullPrevious & VALID_ERROR_MASK;
+    pCtx->uCauseCount = uDepth + 1u;
+
+    /* A shared info reference moves to the chain and is dropped by the next set or clear */
+    pCtx->ullLastError = (ullError & VALID_ERROR_MASK) | CERROR_FLAG_DIRTY | CERROR_FLAG_HAS_CAUSES |
+                         (ullPrevious & CERROR_FLAG_SHARED_INFO) | cerror_capture_frames(pCtx) |
+                         cerror_capture_timestamp(pCtx);
+    pCtx->pszLastErrorInfo = pszErrorInfo;
+    CERROR_LATENCY_END(ullError);
+    CERROR_PROBE2(set_info, ullError, pszErrorInfo);
+    cerror_observe(NULL);
+}
+
+/**
+ * @brief Get the number of causes of the last error (0 if it was not wrapped)
+ */
+static inline uint32_t cerror_get_cause_count(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    return (0 != (pCtx->ullLastError & CERROR_FLAG_HAS_CAUSES)) ? pCtx->uCauseCount : 0u;
+}
+
+/**
+ * @brief Get an error code of the cause chain
+ *
+ * @param uDepth 0 = the last error, 1 = its direct cause, ... cerror_get_cause_count() = root
+ * @return Error code, or 0 if uDepth is beyond the chain
+ */
+static inline uint64_t cerror_get_cause(const uint32_t uDepth)
+{
+    const uint32_t uCount = cerror_get_cause_count();
+
+    if (0u == uDepth)
+    {
+        return cerror_get_last();
+    }
+    return (uDepth <= uCount) ? cerror_ctx()->aCauses[uCount - uDepth].ullError : 0ULL;
+}
+
+/**
+ * @brief Get the info string of an error of the cause chain ("" if uDepth is beyond the chain)
+ */
+static inline const char* cerror_get_cause_info(const uint32_t uDepth)
+{
+    const uint32_t uCount = cerror_get_cause_count();
+
+    if (0u == uDepth)
+    {
+        return cerror_get_last_info();
+    }
+    return (uDepth <= uCount) ? cerror_ctx()->aCauses[uCount - uDepth].pszInfo : "";
+}
+
+/**
+ * @brief Get the root cause of the last error (the last error itself if it was not wrapped)
+ */
+static inline uint64_t cerror_get_root_cause(void)
+{
+    return cerror_get_cause(cerror_get_cause_count());
+}
+
+/**
+ * @brief Get the info string of the root cause
+ */
+static inline const char* cerror_get_root_cause_info(void)
+{
+    return cerror_get_cause_info(cerror_get_cause_count());
 }
 
 // ============================================================================
@@ -433,6 +1622,59 @@ static inline int errorCodeToHttpStatus(const uint64_t ullError) {
     return cerror_code_to_http_status(ullError);
 }
 
+// ============================================================================
+// errno Integration
+// ============================================================================
+
+/**
+ * @brief Map an errno value to a gRPC-style status code
+ */
+CErrorStatusCode cerror_errno_to_status(const int errnum);
+
+/**
+ * @brief Map a gRPC-style status code to a representative errno value (0 for OK)
+ */
+int cerror_status_to_errno(const CErrorStatusCode status);
+
+/**
+ * @brief Set the last error from an errno value
+ *
+ * The status is derived from errnum, the 16-bit error code field holds errnum
+ * itself. The strerror_r text is only produced when cerror_get_last_info() is
+ * called.
+ */
+static inline void cerror_set_from_errno(const uint8_t softwareId, const uint16_t componentId, const int errnum)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    const uint64_t ullError = MAKE_ERROR_CODE(softwareId, componentId, cerror_errno_to_status(errnum), (uint16_t)errnum);
+
+    if (!cerror_try_set_last(ullError))
+    {
+        return;
+    }
+    pCtx->ullLastError |= CERROR_FLAG_FROM_ERRNO;
+    pCtx->pszLastErrorInfo = NULL;
+
+    /* No info is stored at set time (strerror text is rendered on read): a plain set, not timed */
+    CERROR_PROBE2(set, ullError, NULL);
+    cerror_observe(NULL);
+}
+
+/**
+ * @brief Get the last error as an errno value (for APIs that keep errno semantics)
+ *
+ * Returns the original errnum if the error was set by cerror_set_from_errno(),
+ * otherwise a representative errno for its status (0 if there is no error).
+ */
+static inline int cerror_get_last_errno(void)
+{
+    if (0 != (cerror_ctx()->ullLastError & CERROR_FLAG_FROM_ERRNO))
+    {
+        return (int)cerror_get_last_code();
+    }
+    return (0 == cerror_get_last()) ? 0 : cerror_status_to_errno((CErrorStatusCode)cerror_get_last_status());
+}
+
 
 #ifdef __cplusplus
 }
@@ -1,4 +1,22 @@
+#pragma once
+
 #include "lasterror.h"
+#include "frames.h"
+#include "payload.h"
+#include "reduce.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define CERROR_HAS_PMR 1
+#endif
+#endif
 
 namespace Chameleon
 {
@@ -49,8 +67,153 @@ namespace Chameleon
     // C++ Wrapper: Set thread-local error code with info string (copy) Ensures cleanup helper is initialized to free the allocated buffer.
     inline void setLastErrorInfoCopy(const uint64_t ullError, const char* pszErrorInfo) {d::gc(); cerror_set_last_info_copy(ullError, pszErrorInfo);}
 
+    // C++ Wrapper: Set thread-local error code with shared (reference-counted, no copy) info. Ensures cleanup helper is initialized to drop the reference.
+    inline void setLastErrorInfoShared(const uint64_t ullError, CErrorSharedInfo* pShared) {d::gc(); cerror_set_last_info_shared(ullError, pShared);}
+
     // C++ Wrapper: Get the thread-local error info string
     inline const char* getLastErrorInfo() {return cerror_get_last_info();}
+
+    // C++ Wrapper: Set a new error (constant info) that keeps the current one as its cause
+    inline void wrapLastError(const uint64_t ullError, const char* pszErrorInfo) {d::gc(); cerror_wrap_last(ullError, pszErrorInfo);}
+
+    // C++ Wrapper: Get the root cause of the last error (the last error itself if it was not wrapped)
+    inline uint64_t getRootCause() {return cerror_get_root_cause();}
+
+#ifdef CERROR_HAS_PMR
+    namespace d {
+        // CErrorReallocFn adapter over a std::pmr::memory_resource (user data)
+        inline void* pmrRealloc(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData)
+        {
+            std::pmr::memory_resource* pResource = static_cast<std::pmr::memory_resource*>(pUserData);
+            void* pNew = nullptr;
+            if (nNewSize > 0) {
+                try { pNew = pResource->allocate(nNewSize, alignof(std::max_align_t)); }
+                catch (...) { return nullptr; }
+            }
+            if (pBlock != nullptr) {
+                if (pNew != nullptr) std::memcpy(pNew, pBlock, nOldSize < nNewSize ? nOldSize : nNewSize);
+                if (pNew != nullptr || nNewSize == 0) pResource->deallocate(pBlock, nOldSize, alignof(std::max_align_t));
+            }
+            return pNew;
+        }
+        // CErrorFreeFn adapter over a std::pmr::memory_resource (user data)
+        inline void pmrFree(void* pBlock, size_t nSize, void* pUserData)
+        {
+            static_cast<std::pmr::memory_resource*>(pUserData)->deallocate(pBlock, nSize, alignof(std::max_align_t));
+        }
+    }
+
+    // Use a memory resource for all info buffers (call at startup, false while blocks are live; the resource must outlive all threads)
+    inline bool setErrorMemoryResource(std::pmr::memory_resource* pResource) {
+        return 0 != (pResource ? cerror_set_allocator(d::pmrRealloc, d::pmrFree, pResource) : cerror_set_allocator(nullptr, nullptr, nullptr));
+    }
+
+    // Use a memory resource for this thread's info buffer (nullptr reverts to the process-wide allocator)
+    inline bool setThreadErrorMemoryResource(std::pmr::memory_resource* pResource) {
+        return 0 != (pResource ? cerror_set_thread_allocator(d::pmrRealloc, d::pmrFree, pResource) : cerror_set_thread_allocator(nullptr, nullptr, nullptr));
+    }
+#endif
+
+    // C++ Wrapper: Attach typed fields to the current error (rendered to text/JSON only on read)
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    inline bool addErrorField(const char* pszKey, T value) {return 0 != cerror_payload_add_int(pszKey, static_cast<int64_t>(value));}
+    inline bool addErrorField(const char* pszKey, double dValue) {return 0 != cerror_payload_add_double(pszKey, dValue);}
+    inline bool addErrorField(const char* pszKey, const char* pszValue) {return 0 != cerror_payload_add_string(pszKey, pszValue);}
+    inline bool addErrorField(const char* pszKey, const std::string& value) {return 0 != cerror_payload_add_string(pszKey, value.c_str());}
+
+    // C++ Wrapper: Render the payload of the last error as JSON
+    inline std::string getLastErrorPayloadJson() {
+        std::string json(cerror_payload_render_json(nullptr, 0), '\0');
+        cerror_payload_render_json(&json[0], json.size() + 1);
+        return json;
+    }
+
+    // C++ Wrapper: Check whether the copied info string was truncated (low-memory mode or max capacity)
+    inline bool isLastErrorInfoTruncated() {return 0 != cerror_is_last_info_truncated();}
+
+    // RAII annotation frame: pushes a static format and up to two integers, pops on scope exit
+    class ErrorFrame
+    {
+    public:
+        explicit ErrorFrame(const char* pszFormat, int64_t llArg0 = 0, int64_t llArg1 = 0) {cerror_frame_push(pszFormat, llArg0, llArg1);}
+        ~ErrorFrame() {cerror_frame_pop();}
+        ErrorFrame(const ErrorFrame&) = delete;
+        ErrorFrame& operator=(const ErrorFrame&) = delete;
+    };
+
+    // RAII save/restore: cleanup code in this scope cannot clobber the error being returned
+    class ErrorStateGuard
+    {
+    public:
+        ErrorStateGuard() {cerror_save(&m_state);}
+        ~ErrorStateGuard() {if (m_bActive) cerror_restore(&m_state);}
+        // Keep whatever error the scope set instead of restoring
+        void dismiss() {if (m_bActive) {cerror_discard_saved(&m_state); m_bActive = false;}}
+        ErrorStateGuard(const ErrorStateGuard&) = delete;
+        ErrorStateGuard& operator=(const ErrorStateGuard&) = delete;
+    private:
+        CErrorSavedState m_state;
+        bool m_bActive = true;
+    };
+
+#if defined(CERROR_ENABLE_CONTEXT_BINDING)
+    // Binds a request-owned context for the scope and restores the previous binding afterwards
+    class ErrorContextBinding
+    {
+    public:
+        explicit ErrorContextBinding(ErrorContext* pCtx) : m_pPrevious(cerror_bind_context(pCtx)) {}
+        ~ErrorContextBinding() {(void)cerror_bind_context(m_pPrevious);}
+        ErrorContextBinding(const ErrorContextBinding&) = delete;
+        ErrorContextBinding& operator=(const ErrorContextBinding&) = delete;
+    private:
+        ErrorContext* m_pPrevious;
+    };
+#endif
+
+    // Fork-join error reduction: workers call contribute(index), the joining thread calls finish()
+    class ErrorReducer
+    {
+    public:
+        ErrorReducer(CErrorReducePolicy ePolicy, size_t nMaxEntries) : m_entries(nMaxEntries) {
+            cerror_reducer_init(&m_reducer, ePolicy, m_entries.data(), static_cast<uint32_t>(nMaxEntries));
+        }
+        // Thread-safe; no-op if the calling thread has no error
+        bool contribute(uint64_t ullIndex) {return 0 != cerror_reducer_contribute(&m_reducer, ullIndex);}
+        // Result lands in the calling thread's context; returns the number of errors
+        uint32_t finish() {d::gc(); return cerror_reducer_finish(&m_reducer);}
+        uint32_t size() const {return cerror_reducer_entry_count(&m_reducer);}
+        const CErrorReduceEntry& operator[](uint32_t uEntry) const {return *cerror_reducer_entry(&m_reducer, uEntry);}
+        // COLLECT_ALL errors that did not fit into nMaxEntries
+        uint32_t dropped() const {return cerror_reducer_dropped(&m_reducer);}
+        ErrorReducer(const ErrorReducer&) = delete;
+        ErrorReducer& operator=(const ErrorReducer&) = delete;
+    private:
+        std::vector<CErrorReduceEntry> m_entries;
+        CErrorReducer m_reducer;
+    };
+
+    // Run fn(i) for i in [0, nCount) (OpenMP parallel when enabled) and reduce the errors into this thread
+    template <typename Fn>
+    inline uint32_t forEachIndexReduceErrors(CErrorReducePolicy ePolicy, int64_t nCount, Fn&& fn, size_t nMaxEntries = 64)
+    {
+        ErrorReducer reducer(ePolicy, nMaxEntries);
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for (int64_t i = 0; i < nCount; ++i) {
+            cerror_clear_last();
+            fn(i);
+            reducer.contribute(static_cast<uint64_t>(i));
+        }
+        return reducer.finish();
+    }
+
+    // C++ Wrapper: Render the annotation frames of the last error ("tenant 42 / shard 7")
+    inline std::string getLastErrorFrames() {
+        std::string text(cerror_frames_render(nullptr, 0), '\0');
+        cerror_frames_render(&text[0], text.size() + 1);
+        return text;
+    }
 }
 
 /* ============================================================================
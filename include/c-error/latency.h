@@ -0,0 +1,121 @@
+/** @file latency.h
+ *  @brief Latency Histograms of Error Handling per Component
+ *
+ *  Compiled with CERROR_ENABLE_LATENCY_HISTOGRAM (define it for every
+ *  translation unit: the setters are inline), cerror_set_last_info(),
+ *  cerror_set_last_info_copy() and cerror_wrap_last() time themselves from
+ *  entry until the info is stored (observers excluded) and add the duration to a per-thread histogram
+ *  of the error's component. Without the define nothing is timed or recorded.
+ *
+ *  Histograms are log-linear (HDR-style): values below
+ *  CERROR_LATENCY_SUB_BUCKETS clock units get a bucket each, every power of
+ *  two above is split into CERROR_LATENCY_SUB_BUCKETS linear buckets (about
+ *  6% resolution). Durations are kept in raw clock units (TSC ticks on x86
+ *  with GCC/Clang when the TSC is invariant, CLOCK_MONOTONIC nanoseconds
+ *  otherwise) and converted when read; the first read calibrates the TSC.
+ *
+ *  The recording thread is the only writer of its histograms, so recording
+ *  takes no lock and does no atomic read-modify-write. cerror_latency_snapshot()
+ *  merges all live threads with the totals of threads that called
+ *  cerror_cleanup_thread_local_buffer() before exiting.
+ *
+ *  A thread in fixed-capacity mode never allocates on the setter path: its
+ *  histograms are allocated by cerror_set_fixed_info_mode(1) (or
+ *  cerror_latency_prepare_thread() under CERROR_NO_HEAP), and samples of an
+ *  unprepared fixed-capacity thread are dropped.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include "lasterror.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Linear buckets per power of two (log2) */
+#define CERROR_LATENCY_SUB_BUCKET_BITS  4u
+#define CERROR_LATENCY_SUB_BUCKETS      (1u << CERROR_LATENCY_SUB_BUCKET_BITS)
+
+/** Durations of 2^CERROR_LATENCY_MAX_EXPONENT clock units and more share the last bucket */
+#define CERROR_LATENCY_MAX_EXPONENT     32u
+
+/** Buckets per histogram */
+#define CERROR_LATENCY_BUCKETS \
+    ((CERROR_LATENCY_MAX_EXPONENT - CERROR_LATENCY_SUB_BUCKET_BITS + 1u) * CERROR_LATENCY_SUB_BUCKETS)
+
+/** Components tracked per thread; further components are recorded as CERROR_LATENCY_OTHER */
+#define CERROR_LATENCY_MAX_COMPONENTS   16u
+
+/** Components kept in the static totals of exited threads; further ones are added to CERROR_LATENCY_OTHER */
+#ifndef CERROR_LATENCY_MAX_TOTALS
+    #define CERROR_LATENCY_MAX_TOTALS   64u
+#endif
+
+/** uComponentId of the histogram collecting components beyond a thread's limit */
+#define CERROR_LATENCY_OTHER            0xFFFFu
+
+/**
+ * @brief Latency histogram of one component
+ */
+typedef struct CErrorLatencyHistogram
+{
+    uint32_t uComponentId;                      /**< Component ID, or CERROR_LATENCY_OTHER */
+    uint32_t uReserved;
+    double   dNsPerTick;                        /**< Nanoseconds per clock unit (set by cerror_latency_snapshot()) */
+    uint64_t ullCount;                          /**< Recorded calls */
+    uint64_t ullSumTicks;                       /**< Sum of durations (clock units) */
+    uint64_t ullMaxTicks;                       /**< Longest duration (clock units) */
+    uint64_t aBuckets[CERROR_LATENCY_BUCKETS];  /**< Calls per bucket */
+} CErrorLatencyHistogram;
+
+/**
+ * @brief Merge the histograms of all threads, one entry per component
+ *
+ * Only components with recorded calls are listed, sorted by component ID.
+ * Counts of threads that are recording concurrently may be slightly behind.
+ *
+ * @param aHistograms Output entries (may be NULL if uMax is 0)
+ * @param uMax Number of entries
+ * @return Number of components recorded (may exceed uMax; only uMax are filled)
+ */
+uint32_t cerror_latency_snapshot(CErrorLatencyHistogram* aHistograms, uint32_t uMax);
+
+/**
+ * @brief Add the counts of pFrom to pInto (same component or not, e.g. to total a snapshot)
+ */
+void cerror_latency_merge(CErrorLatencyHistogram* pInto, const CErrorLatencyHistogram* pFrom);
+
+/**
+ * @brief Duration at a percentile, in nanoseconds
+ *
+ * Returns the upper bound of the bucket holding the percentile, capped at
+ * the recorded maximum.
+ *
+ * @param dPercentile Percentile in [0, 100], e.g. 99.9
+ * @return Duration in nanoseconds, or 0 if the histogram is empty
+ */
+uint64_t cerror_latency_percentile_ns(const CErrorLatencyHistogram* pHistogram, double dPercentile);
+
+/**
+ * @brief Allocate the calling thread's histograms for all CERROR_LATENCY_MAX_COMPONENTS components now
+ *
+ * Called by cerror_set_fixed_info_mode(1). Threads in fixed-capacity mode
+ * record only into prepared histograms; call it before such a thread's
+ * first set when the mode is forced with CERROR_NO_HEAP. The histograms are
+ * freed by cerror_cleanup_thread_local_buffer().
+ *
+ * @return 1 on success, 0 if the allocator failed
+ */
+int cerror_latency_prepare_thread(void);
+
+/**
+ * @brief Discard all recorded durations (threads drop their counts on their next record)
+ */
+void cerror_latency_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,155 @@
+/** @file payload.h
+ *  @brief Structured Key/Value Payload Attached to the Last Error
+ *
+ *  Typed fields are appended to the current error as compact TLV records, so
+ *  values need no snprintf on set and no parsing downstream. Text or JSON is
+ *  rendered only when the payload is read.
+ *
+ *  Record layout (unaligned, little-endian length):
+ *  | Bytes | Field     | Description                      |
+ *  |:----- |:--------- |:-------------------------------- |
+ *  | 1     | Type      | CErrorPayloadType                |
+ *  | 1     | Key len   | 0-255                            |
+ *  | 2     | Value len | 0-65535                          |
+ *  | n     | Key       | Not null-terminated              |
+ *  | m     | Value     | int64/double (8 bytes) or raw    |
+ *
+ *  Records are stored in an in-context area of CERROR_PAYLOAD_INLINE_CAPACITY
+ *  bytes and spill to a heap buffer beyond that (never in fixed-capacity mode).
+ *  The payload belongs to the current error: any cerror_set_last*() call
+ *  discards it at no cost (the presence flag lives in the code's flag bits).
+ *  Fields need a current error: without one, and in sticky first-error mode
+ *  for a suppressed error, they are rejected (0). A NULL key is stored as an
+ *  empty key.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include "lasterror.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Size of a record header (type, key length, value length) */
+#define CERROR_PAYLOAD_HEADER_SIZE  4u
+/** Maximum key length in bytes */
+#define CERROR_PAYLOAD_MAX_KEY      0xFFu
+/** Maximum value length in bytes */
+#define CERROR_PAYLOAD_MAX_VALUE    0xFFFFu
+
+/**
+ * @brief Payload field types
+ */
+typedef enum CErrorPayloadType {
+    CERROR_PAYLOAD_INT      = 1,    /**< int64_t */
+    CERROR_PAYLOAD_DOUBLE   = 2,    /**< double */
+    CERROR_PAYLOAD_STRING   = 3,    /**< UTF-8 text (not null-terminated) */
+    CERROR_PAYLOAD_BYTES    = 4     /**< Opaque byte blob */
+} CErrorPayloadType;
+
+/**
+ * @brief A decoded payload field (points into the payload storage)
+ */
+typedef struct CErrorPayloadField
+{
+    CErrorPayloadType eType;        /**< Field type */
+    const char*       pKey;         /**< Key bytes (not null-terminated) */
+    size_t            nKeyLength;   /**< Key length */
+    const void*       pValue;       /**< Value bytes (possibly unaligned) */
+    size_t            nValueLength; /**< Value length */
+} CErrorPayloadField;
+
+/**
+ * @brief Iterator over the payload of the last error
+ */
+typedef struct CErrorPayloadIter
+{
+    const unsigned char* pCur;      /**< Next record */
+    const unsigned char* pEnd;      /**< End of payload */
+} CErrorPayloadIter;
+
+/* ============================================================================
+ * Typed Setters (append to the payload of the current error)
+ * ============================================================================ */
+
+/**
+ * @brief Append an integer field
+ * @return 1 on success, 0 if the key is too long, storage is exhausted or no error is set
+ */
+int cerror_payload_add_int(const char* pszKey, int64_t llValue);
+
+/**
+ * @brief Append a floating-point field
+ * @return 1 on success, 0 if the key is too long, storage is exhausted or no error is set
+ */
+int cerror_payload_add_double(const char* pszKey, double dValue);
+
+/**
+ * @brief Append a string field (copied, up to CERROR_PAYLOAD_MAX_VALUE bytes)
+ * @return 1 on success, 0 if the key/value is too long, storage is exhausted or no error is set
+ */
+int cerror_payload_add_string(const char* pszKey, const char* pszValue);
+
+/**
+ * @brief Append a byte blob field (copied, up to CERROR_PAYLOAD_MAX_VALUE bytes)
+ * @return 1 on success, 0 if the key/value is too long, storage is exhausted or no error is set
+ */
+int cerror_payload_add_bytes(const char* pszKey, const void* pData, size_t nLength);
+
+/* ============================================================================
+ * Reading
+ * ============================================================================ */
+
+/**
+ * @brief Check whether the last error carries a payload
+ */
+static inline int cerror_has_payload(void)
+{
+    return 0 != (cerror_ctx()->ullLastError & CERROR_FLAG_HAS_PAYLOAD);
+}
+
+/**
+ * @brief Start iterating over the payload of the last error
+ */
+void cerror_payload_iter_init(CErrorPayloadIter* pIter);
+
+/**
+ * @brief Decode the next field
+ * @return 1 if a field was returned, 0 at the end
+ */
+int cerror_payload_next(CErrorPayloadIter* pIter, CErrorPayloadField* pField);
+
+/**
+ * @brief Read an integer field value
+ */
+int64_t cerror_payload_field_int(const CErrorPayloadField* pField);
+
+/**
+ * @brief Read a floating-point field value
+ */
+double cerror_payload_field_double(const CErrorPayloadField* pField);
+
+/**
+ * @brief Render the payload as "key=value key=value" text
+ *
+ * Strings are written verbatim, byte blobs as hex.
+ *
+ * @return Length of the full rendering (snprintf semantics: output truncated if >= nSize)
+ */
+size_t cerror_payload_render_text(char* pszBuffer, size_t nSize);
+
+/**
+ * @brief Render the payload as a JSON object
+ *
+ * Byte blobs are rendered as hex strings, non-finite doubles as null.
+ *
+ * @return Length of the full rendering (snprintf semantics: output truncated if >= nSize)
+ */
+size_t cerror_payload_render_json(char* pszBuffer, size_t nSize);
+
+#ifdef __cplusplus
+}
+#endif
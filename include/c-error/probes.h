@@ -0,0 +1,86 @@
+/** @file probes.h
+ *  @brief USDT (SystemTap/DTrace-style) Static Tracepoints
+ *
+ *  Probes of provider "cerror" on the error path, for live tracing with perf,
+ *  bpftrace or SystemTap without rebuilding:
+ *
+ *  | Probe         | Arguments                          | Fired by                              |
+ *  |:------------- |:---------------------------------- |:------------------------------------- |
+ *  | set           | code, info (NULL)                  | cerror_set_last(), cerror_set_from_errno() |
+ *  | set_info      | code, info                         | cerror_set_last_info(), cerror_wrap_last() |
+ *  | set_info_copy | code, info (source string)         | cerror_set_last_info_copy()           |
+ *  | info_grow     | code, info, new buffer capacity    | buffer growth in the copy slow path   |
+ *  | clear         | code, info                         | cerror_clear_last() of a set error    |
+ *
+ *  Probes are compiled in with CERROR_ENABLE_PROBES (define it for every
+ *  translation unit: the setters are inline). Each probe is a nop plus an ELF
+ *  note; the tracer patches the nop when it attaches. <sys/sdt.h> is used
+ *  when available, otherwise an equivalent note is emitted directly on
+ *  x86-64 and AArch64 ELF targets with GCC or Clang. Elsewhere probes
+ *  compile to nothing.
+ *
+ *  Example: bpftrace -e 'usdt:./app:cerror:set_info_copy { @[str(arg1)] = count(); }'
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include <stdint.h>
+
+#if defined(CERROR_ENABLE_PROBES) && defined(__has_include)
+    #if __has_include(<sys/sdt.h>)
+        #include <sys/sdt.h>
+        #define CERROR_PROBES_SYS_SDT 1
+    #endif
+#endif
+
+#if !defined(CERROR_ENABLE_PROBES)
+    #define CERROR_PROBE2(name, a1, a2)         ((void)0)
+    #define CERROR_PROBE3(name, a1, a2, a3)     ((void)0)
+#elif defined(CERROR_PROBES_SYS_SDT)
+    #define CERROR_PROBE2(name, a1, a2)         STAP_PROBE2(cerror, name, a1, a2)
+    #define CERROR_PROBE3(name, a1, a2, a3)     STAP_PROBE3(cerror, name, a1, a2, a3)
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__))
+    /*
+     * Bundled fallback: the .note.stapsdt layout of <sys/sdt.h> (note type 3)
+     * for 8-byte arguments. Arguments are described as "8@<operand>" and may
+     * live in a register, memory or be an immediate.
+     */
+    #define CERROR_SDT_NOTE(name, args)                                           \
+        "990: nop\n"                                                              \
+        ".pushsection .note.stapsdt,\"?\",\"note\"\n"                             \
+        ".balign 4\n"                                                             \
+        ".4byte 992f-991f, 994f-993f, 3\n"                                        \
+        "991: .asciz \"stapsdt\"\n"                                               \
+        "992: .balign 4\n"                                                        \
+        "993: .8byte 990b\n"                                                      \
+        ".8byte _.stapsdt.base\n"                                                 \
+        ".8byte 0\n"                                                              \
+        ".asciz \"cerror\"\n"                                                     \
+        ".asciz \"" #name "\"\n"                                                  \
+        ".asciz \"" args "\"\n"                                                   \
+        "994: .balign 4\n"                                                        \
+        ".popsection\n"                                                           \
+        ".ifndef _.stapsdt.base\n"                                                \
+        ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"   \
+        ".weak _.stapsdt.base\n"                                                  \
+        ".hidden _.stapsdt.base\n"                                                \
+        "_.stapsdt.base: .space 1\n"                                              \
+        ".size _.stapsdt.base, 1\n"                                               \
+        ".popsection\n"                                                           \
+        ".endif\n"
+
+    #define CERROR_SDT_ARG(a) ((uint64_t)(uintptr_t)(a))
+
+    #define CERROR_PROBE2(name, a1, a2)                                           \
+        __asm__ __volatile__(CERROR_SDT_NOTE(name, "8@%[arg1] 8@%[arg2]")         \
+                             : : [arg1] "nor"(CERROR_SDT_ARG(a1)), [arg2] "nor"(CERROR_SDT_ARG(a2)))
+    #define CERROR_PROBE3(name, a1, a2, a3)                                       \
+        __asm__ __volatile__(CERROR_SDT_NOTE(name, "8@%[arg1] 8@%[arg2] 8@%[arg3]") \
+                             : : [arg1] "nor"(CERROR_SDT_ARG(a1)), [arg2] "nor"(CERROR_SDT_ARG(a2)), \
+                                 [arg3] "nor"(CERROR_SDT_ARG(a3)))
+#else
+    #define CERROR_PROBE2(name, a1, a2)         ((void)0)
+    #define CERROR_PROBE3(name, a1, a2, a3)     ((void)0)
+#endif
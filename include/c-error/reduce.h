@@ -0,0 +1,157 @@
+/** @file reduce.h
+ *  @brief Parallel Error Reduction for Fork-Join Workloads
+ *
+ *  Each worker of a parallel loop contributes the error of its own thread
+ *  context to a shared reducer; the joining thread then receives the result
+ *  in its context. FIRST_BY_INDEX and MOST_SEVERE keep the current winner in
+ *  a fixed slot of the reducer: contributions that cannot win are rejected by
+ *  one atomic load, a new winner replaces the slot under a spin lock held for
+ *  the copy of one entry. COLLECT_ALL claims an entry with one fetch-add.
+ *
+ *  Policies:
+ *  | Policy                         | Result in the joining context          |
+ *  |:------------------------------ |:-------------------------------------- |
+ *  | CERROR_REDUCE_FIRST_BY_INDEX   | Error of the lowest work item index    |
+ *  | CERROR_REDUCE_MOST_SEVERE      | Most severe status, lowest index on tie|
+ *  | CERROR_REDUCE_COLLECT_ALL      | All errors kept, sorted by index       |
+ *
+ *  COLLECT_ALL entries are caller-provided storage. Info strings are copied (truncated to
+ *  CERROR_REDUCE_INFO_CAPACITY - 1 bytes); payload, causes and frames are not
+ *  carried over.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include "lasterror.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Info bytes kept per reduced error */
+#ifndef CERROR_REDUCE_INFO_CAPACITY
+#define CERROR_REDUCE_INFO_CAPACITY 64
+#endif
+
+/** ullBestRank value while no error has been published */
+#define CERROR_REDUCE_NO_RANK 0xFFFFFFFFFFFFFFFFULL
+
+/**
+ * @brief How contributions are combined
+ */
+typedef enum CErrorReducePolicy {
+    CERROR_REDUCE_FIRST_BY_INDEX = 0,   /**< Keep the error of the lowest index */
+    CERROR_REDUCE_MOST_SEVERE    = 1,   /**< Keep the most severe status (cerror_status_severity()) */
+    CERROR_REDUCE_COLLECT_ALL    = 2    /**< Keep every error (up to the entry capacity) */
+} CErrorReducePolicy;
+
+/**
+ * @brief One contributed error
+ */
+typedef struct CErrorReduceEntry
+{
+    uint64_t ullError;                              /**< 53-bit error code */
+    uint64_t ullIndex;                              /**< Work item index given by the contributor */
+    char     szInfo[CERROR_REDUCE_INFO_CAPACITY];   /**< Copied info (UTF-8 safe truncation) */
+} CErrorReduceEntry;
+
+/**
+ * @brief Shared reducer (initialize with cerror_reducer_init(), do not copy while in use)
+ */
+typedef struct CErrorReducer
+{
+    CErrorReducePolicy ePolicy;         /**< Combine policy */
+    CErrorReduceEntry* pEntries;        /**< Caller-provided entry storage (COLLECT_ALL) */
+    uint32_t           uCapacity;       /**< Number of entries */
+    uint32_t           uClaimed;        /**< Entries claimed by contributors (atomic, may exceed capacity) */
+    uint32_t           uErrors;         /**< Errors contributed, including dropped ones (atomic) */
+    uint32_t           uBestLock;       /**< Held while stBest is replaced */
+    uint64_t           ullBestRank;     /**< Rank of stBest, lower wins (atomic, CERROR_REDUCE_NO_RANK if none) */
+    CErrorReduceEntry  stBest;          /**< Winner of FIRST_BY_INDEX / MOST_SEVERE (ullError 0 if none) */
+} CErrorReducer;
+
+/**
+ * @brief Rank a status for CERROR_REDUCE_MOST_SEVERE (higher is more severe, OK is 0)
+ *
+ * Data loss and internal failures outrank transient conditions, which outrank
+ * caller mistakes; CANCELLED is the least severe error.
+ */
+static inline uint32_t cerror_status_severity(const CErrorStatusCode status)
+{
+    static const uint8_t aSeverity[CERROR_STATUS_MAX + 1] = {
+        0,  /* OK */
+        1,  /* CANCELLED */
+        14, /* UNKNOWN */
+        4,  /* INVALID_ARGUMENT */
+        10, /* DEADLINE_EXCEEDED */
+        2,  /* NOT_FOUND */
+        3,  /* ALREADY_EXISTS */
+        7,  /* PERMISSION_DENIED */
+        11, /* RESOURCE_EXHAUSTED */
+        8,  /* FAILED_PRECONDITION */
+        9,  /* ABORTED */
+        5,  /* OUT_OF_RANGE */
+        6,  /* UNIMPLEMENTED */
+        15, /* INTERNAL */
+        12, /* UNAVAILABLE */
+        16, /* DATA_LOSS */
+        13  /* UNAUTHENTICATED */
+    };
+    /* Statuses outside the gRPC set rank like UNKNOWN */
+    return ((uint32_t)status <= CERROR_STATUS_MAX) ? aSeverity[status] : aSeverity[CERROR_UNKNOWN];
+}
+
+/**
+ * @brief Initialize a reducer over caller-provided entries
+ *
+ * FIRST_BY_INDEX and MOST_SEVERE keep their winner inside the reducer and
+ * use no entries (pEntries may be NULL). COLLECT_ALL needs one entry per
+ * error to keep; errors beyond the capacity are only counted (see
+ * cerror_reducer_dropped()).
+ */
+void cerror_reducer_init(CErrorReducer* pReducer, CErrorReducePolicy ePolicy,
+                         CErrorReduceEntry* pEntries, uint32_t uCapacity);
+
+/**
+ * @brief Contribute the calling thread's last error (thread-safe)
+ *
+ * Does nothing if the thread has no error. Otherwise the error is combined
+ * into the reducer and cleared from the thread's context.
+ *
+ * @param ullIndex Work item index (ordering key for FIRST_BY_INDEX and ties)
+ * @return 1 if the thread had an error, 0 otherwise
+ */
+int cerror_reducer_contribute(CErrorReducer* pReducer, uint64_t ullIndex);
+
+/**
+ * @brief Deliver the result to the calling (joining) thread's context
+ *
+ * Call after all workers have joined. Sets the winning error (COLLECT_ALL:
+ * the lowest index) with its info, or clears the context if no worker failed.
+ *
+ * @return Number of errors contributed (including ones that were not stored)
+ */
+uint32_t cerror_reducer_finish(CErrorReducer* pReducer);
+
+/**
+ * @brief Number of COLLECT_ALL errors that did not fit into the entries (0 for the other policies)
+ */
+uint32_t cerror_reducer_dropped(const CErrorReducer* pReducer);
+
+/**
+ * @brief Number of stored entries (after finish: COLLECT_ALL entries are sorted by index)
+ *
+ * FIRST_BY_INDEX and MOST_SEVERE store one entry, the winner, if any worker failed.
+ */
+uint32_t cerror_reducer_entry_count(const CErrorReducer* pReducer);
+
+/**
+ * @brief Get a stored entry (NULL if out of range)
+ */
+const CErrorReduceEntry* cerror_reducer_entry(const CErrorReducer* pReducer, uint32_t uEntry);
+
+#ifdef __cplusplus
+}
+#endif
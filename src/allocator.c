@@ -0,0 +1,302 @@
+/** @file allocator.c
+ *  @brief Pluggable Allocator for Info Buffers
+ *
+ *  Routes info buffer allocations to the thread allocator (if set), the
+ *  size-class pool (if enabled) or the process-wide allocator (libc by default).
+ *  Allocator calls only happen on buffer growth, trim and cleanup, never on
+ *  the inline fast paths, which is also where heap bytes are accounted.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "cerror_internal.h"
+#include "cerror_atomic.h"
+
+/* ============================================================================
+ * Default (libc) Allocator
+ * ============================================================================ */
+
+static void* cerror_libc_realloc(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData)
+{
+    (void)nOldSize;
+    (void)pUserData;
+    return realloc(pBlock, nNewSize);
+}
+
+static void cerror_libc_free(void* pBlock, size_t nSize, void* pUserData)
+{
+    (void)nSize;
+    (void)pUserData;
+    free(pBlock);
+}
+
+/** Process-wide allocator (set at startup, read on growth events only) */
+static CErrorAllocator g_CErrorAllocator = { cerror_libc_realloc, cerror_libc_free, NULL };
+
+/** Blocks of the process-wide allocator not yet freed (pool cache included) */
+static uint64_t g_ullProcessBlocks = 0;
+
+/* ============================================================================
+ * Memory Accounting State
+ * ============================================================================ */
+
+/** Heap bytes published by all contexts and their peak (see cerror_account_publish()) */
+static uint64_t g_ullHeapBytes = 0;
+static uint64_t g_ullPeakHeapBytes = 0;
+
+/** Counters folded from cleaned-up contexts */
+static uint64_t g_ullFoldedGrowEvents = 0;
+static uint64_t g_ullFoldedBytesCopied = 0;
+
+/** Memory exporter (set at startup) */
+static CErrorMemoryExporterFn g_pfnMemoryExporter = NULL;
+static void*                  g_pMemoryExporterData = NULL;
+
+/**
+ * @brief Add the unpublished bytes of pCtx to the process-wide count
+ *
+ * The peak is raised to the new count plus the context's excess of its peak
+ * over its current bytes, an upper bound of the process peak in between.
+ */
+static void cerror_account_publish(ErrorContext* pCtx)
+{
+    uint64_t ullHeld;
+    uint64_t ullPeak;
+
+    if (pCtx->nHeapBytes >= pCtx->nPublishedHeapBytes)
+    {
+        const uint64_t ullDelta = pCtx->nHeapBytes - pCtx->nPublishedHeapBytes;
+        ullHeld = CERROR_ATOMIC_ADD_U64(&g_ullHeapBytes, ullDelta) + ullDelta;
+    }
+    else
+    {
+        const uint64_t ullDelta = pCtx->nPublishedHeapBytes - pCtx->nHeapBytes;
+        ullHeld = CERROR_ATOMIC_SUB_U64(&g_ullHeapBytes, ullDelta) - ullDelta;
+    }
+    pCtx->nPublishedHeapBytes = pCtx->nHeapBytes;
+
+    ullHeld += pCtx->nPeakHeapBytes - pCtx->nHeapBytes;
+    ullPeak = CERROR_ATOMIC_LOAD_U64(&g_ullPeakHeapBytes);
+    while (ullHeld > ullPeak && !CERROR_ATOMIC_CAS_U64(&g_ullPeakHeapBytes, ullPeak, ullHeld))
+    {
+        ullPeak = CERROR_ATOMIC_LOAD_U64(&g_ullPeakHeapBytes);
+    }
+}
+
+/**
+ * @brief Account a buffer taken by the current context
+ */
+static void cerror_account_alloc(size_t nCapacity)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    pCtx->nHeapBytes += nCapacity;
+    if (pCtx->nHeapBytes > pCtx->nPeakHeapBytes)
+    {
+        pCtx->nPeakHeapBytes = pCtx->nHeapBytes;
+    }
+    if (pCtx->nHeapBytes > pCtx->nPublishedHeapBytes &&
+        pCtx->nHeapBytes - pCtx->nPublishedHeapBytes >= CERROR_MEMORY_PUBLISH_BYTES)
+    {
+        cerror_account_publish(pCtx);
+    }
+}
+
+/**
+ * @brief Account a buffer released by the current context
+ */
+static void cerror_account_free(size_t nCapacity)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    pCtx->nHeapBytes -= nCapacity;
+    if (pCtx->nPublishedHeapBytes > pCtx->nHeapBytes &&
+        pCtx->nPublishedHeapBytes - pCtx->nHeapBytes >= CERROR_MEMORY_PUBLISH_BYTES)
+    {
+        cerror_account_publish(pCtx);
+    }
+}
+
+/* ============================================================================
+ * Internal Allocation Interface
+ * ============================================================================ */
+
+void* cerror_process_alloc(size_t nSize)
+{
+    void* const pBlock = g_CErrorAllocator.pfnRealloc(NULL, 0, nSize, g_CErrorAllocator.pUserData);
+
+    if (NULL != pBlock)
+    {
+        (void)CERROR_ATOMIC_ADD_U64(&g_ullProcessBlocks, 1u);
+    }
+    return pBlock;
+}
+
+void cerror_process_free(void* pBlock, size_t nSize)
+{
+    if (NULL != pBlock)
+    {
+        g_CErrorAllocator.pfnFree(pBlock, nSize, g_CErrorAllocator.pUserData);
+        (void)CERROR_ATOMIC_SUB_U64(&g_ullProcessBlocks, 1u);
+    }
+}
+
+char* cerror_buffer_alloc(size_t nCapacity)
+{
+    const CErrorAllocator* pAllocator = &cerror_ctx()->stAllocator;
+    char*                  pBuffer;
+
+    if (NULL != pAllocator->pfnRealloc)
+    {
+        pBuffer = (char*)pAllocator->pfnRealloc(NULL, 0, nCapacity, pAllocator->pUserData);
+    }
+    else
+    {
+        pBuffer = cerror_pool_take(nCapacity);
+        if (NULL == pBuffer)
+        {
+            pBuffer = (char*)cerror_process_alloc(nCapacity);
+        }
+    }
+
+    if (NULL != pBuffer)
+    {
+        cerror_account_alloc(nCapacity);
+    }
+    return pBuffer;
+}
+
+void cerror_buffer_free(char* pBuffer, size_t nCapacity)
+{
+    const CErrorAllocator* pAllocator = &cerror_ctx()->stAllocator;
+
+    if (NULL == pBuffer)
+    {
+        return;
+    }
+    cerror_account_free(nCapacity);
+
+    if (NULL != pAllocator->pfnRealloc)
+    {
+        pAllocator->pfnFree(pBuffer, nCapacity, pAllocator->pUserData);
+        return;
+    }
+
+    if (!cerror_pool_put(pBuffer, nCapacity))
+    {
+        cerror_process_free(pBuffer, nCapacity);
+    }
+}
+
+/* ============================================================================
+ * Public Allocator API
+ * ============================================================================ */
+
+int cerror_set_allocator(CErrorReallocFn pfnRealloc, CErrorFreeFn pfnFree, void* pUserData)
+{
+    if ((NULL == pfnRealloc) != (NULL == pfnFree))
+    {
+        return 0;
+    }
+
+    /* Cached buffers belong to the previous allocator */
+    cerror_pool_drain();
+
+    /* A live block would later be freed through the new allocator */
+    if (0u != CERROR_ATOMIC_LOAD_U64(&g_ullProcessBlocks))
+    {
+        return 0;
+    }
+
+    if (NULL == pfnRealloc)
+    {
+        g_CErrorAllocator.pfnRealloc = cerror_libc_realloc;
+        g_CErrorAllocator.pfnFree = cerror_libc_free;
+        g_CErrorAllocator.pUserData = NULL;
+    }
+    else
+    {
+        g_CErrorAllocator.pfnRealloc = pfnRealloc;
+        g_CErrorAllocator.pfnFree = pfnFree;
+        g_CErrorAllocator.pUserData = pUserData;
+    }
+    return 1;
+}
+
+int cerror_set_thread_allocator(CErrorReallocFn pfnRealloc, CErrorFreeFn pfnFree, void* pUserData)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if ((NULL == pfnRealloc) != (NULL == pfnFree))
+    {
+        return 0;
+    }
+
+    /* Current buffers must go back to the allocator that provided them */
+    cerror_release_info_buffer();
+    cerror_payload_release();
+
+    pCtx->stAllocator.pfnRealloc = pfnRealloc;
+    pCtx->stAllocator.pfnFree = pfnFree;
+    pCtx->stAllocator.pUserData = pUserData;
+    return 1;
+}
+
+/* ============================================================================
+ * Memory Accounting
+ * ============================================================================ */
+
+void cerror_memory_fold(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    cerror_account_publish(pCtx);
+    if (0 != pCtx->ullGrowEvents)
+    {
+        (void)CERROR_ATOMIC_ADD_U64(&g_ullFoldedGrowEvents, pCtx->ullGrowEvents);
+    }
+    if (0 != pCtx->ullBytesCopied)
+    {
+        (void)CERROR_ATOMIC_ADD_U64(&g_ullFoldedBytesCopied, pCtx->ullBytesCopied);
+    }
+    pCtx->ullGrowEvents = 0;
+    pCtx->ullBytesCopied = 0;
+    pCtx->nPeakHeapBytes = pCtx->nHeapBytes;
+}
+
+void cerror_get_thread_memory_stats(CErrorMemoryStats* pStats)
+{
+    const ErrorContext* const pCtx = cerror_ctx();
+
+    pStats->ullCurrentBytes = pCtx->nHeapBytes;
+    pStats->ullPeakBytes = pCtx->nPeakHeapBytes;
+    pStats->ullGrowEvents = pCtx->ullGrowEvents;
+    pStats->ullBytesCopied = pCtx->ullBytesCopied;
+}
+
+void cerror_get_memory_stats(CErrorMemoryStats* pStats)
+{
+    pStats->ullCurrentBytes = CERROR_ATOMIC_LOAD_U64(&g_ullHeapBytes);
+    pStats->ullPeakBytes = CERROR_ATOMIC_LOAD_U64(&g_ullPeakHeapBytes);
+    pStats->ullGrowEvents = CERROR_ATOMIC_LOAD_U64(&g_ullFoldedGrowEvents);
+    pStats->ullBytesCopied = CERROR_ATOMIC_LOAD_U64(&g_ullFoldedBytesCopied);
+}
+
+void cerror_set_memory_exporter(CErrorMemoryExporterFn pfnExporter, void* pUserData)
+{
+    g_pfnMemoryExporter = pfnExporter;
+    g_pMemoryExporterData = pUserData;
+}
+
+void cerror_export_memory_stats(void)
+{
+    CErrorMemoryStats stStats;
+
+    if (NULL == g_pfnMemoryExporter)
+    {
+        return;
+    }
+    cerror_get_memory_stats(&stStats);
+    g_pfnMemoryExporter(&stStats, g_pMemoryExporterData);
+}
@@ -0,0 +1,262 @@
+/** @file bufferpool.c
+ *  @brief Global Size-class Pool for Info Buffers (opt-in)
+ *
+ *  Buffers released by one thread (growth, trim, thread-exit cleanup) are kept
+ *  on per-size-class free lists and handed to the next thread that needs a
+ *  buffer of that class, avoiding malloc/free churn in thread pools.
+ *
+ *  Size classes are the powers of 2 used by the buffer growth policy, from
+ *  2^CERROR_POOL_MIN_CLASS_SHIFT to 2^CERROR_POOL_MAX_CLASS_SHIFT bytes.
+ *  Other capacities bypass the pool.
+ *
+ *  Each free list is an intrusive stack guarded by a spin lock held for a
+ *  push or pop of one node (a few instructions, O(1)); waiters back off with
+ *  pause hints. A lock-free stack
+ *  would need a versioned head against ABA, and its pop would still read the
+ *  next pointer of a node that cerror_pool_drain() may have freed meanwhile.
+ *  Each class sits on its own cache line. Only buffers of the process-wide
+ *  allocator are pooled.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "cerror_internal.h"
+#include "cerror_atomic.h"
+
+/* ============================================================================
+ * Pool State
+ * ============================================================================ */
+
+#define CERROR_POOL_CLASS_COUNT (CERROR_POOL_MAX_CLASS_SHIFT - CERROR_POOL_MIN_CLASS_SHIFT + 1)
+
+/** Free list node, stored in the first bytes of a cached buffer */
+typedef struct CErrorPoolNode
+{
+    struct CErrorPoolNode* pNext;
+} CErrorPoolNode;
+
+/** Free list of one size class */
+typedef struct CErrorPoolClass
+{
+    CERROR_ALIGN_CACHELINE
+    CErrorPoolNode* pHead;
+    uint32_t        uLock;
+} CErrorPoolClass;
+
+static CErrorPoolClass g_aPoolClasses[CERROR_POOL_CLASS_COUNT];
+
+static uint32_t g_uPoolEnabled = 0;
+static uint64_t g_ullPoolMaxBytesHeld = 0;
+
+static uint64_t g_ullPoolHits = 0;
+static uint64_t g_ullPoolMisses = 0;
+static uint64_t g_ullPoolReturned = 0;
+static uint64_t g_ullPoolDiscarded = 0;
+static uint64_t g_ullPoolBytesHeld = 0;
+static uint64_t g_ullPoolBuffersHeld = 0;
+
+/**
+ * @brief Size-class index of a capacity, or -1 if it is not pooled
+ */
+static int cerror_pool_class_of(size_t nCapacity)
+{
+    unsigned nShift;
+
+    if (0 != (nCapacity & (nCapacity - 1)))
+    {
+        return -1;
+    }
+    for (nShift = CERROR_POOL_MIN_CLASS_SHIFT; nShift <= CERROR_POOL_MAX_CLASS_SHIFT; ++nShift)
+    {
+        if (((size_t)1 << nShift) == nCapacity)
+        {
+            return (int)(nShift - CERROR_POOL_MIN_CLASS_SHIFT);
+        }
+    }
+    return -1;
+}
+
+/** Upper bound of the pause count between two lock attempts */
+#define CERROR_POOL_MAX_BACKOFF 64u
+
+static void cerror_pool_lock(CErrorPoolClass* pClass)
+{
+    uint32_t uBackoff = 1u;
+
+    while (!CERROR_ATOMIC_CAS_U32(&pClass->uLock, 0u, 1u))
+    {
+        /* Wait on plain loads so waiters do not bounce the line with failed CAS */
+        do
+        {
+            uint32_t i;
+            for (i = 0; i < uBackoff; ++i)
+            {
+                CERROR_ATOMIC_PAUSE();
+            }
+            if (uBackoff < CERROR_POOL_MAX_BACKOFF)
+            {
+                uBackoff <<= 1;
+            }
+        } while (0u != CERROR_ATOMIC_LOAD_U32(&pClass->uLock));
+    }
+}
+
+static void cerror_pool_unlock(CErrorPoolClass* pClass)
+{
+    CERROR_ATOMIC_STORE_U32(&pClass->uLock, 0u);
+}
+
+/**
+ * @brief Push one node onto a free list
+ *
+ * The enabled flag is checked again under the lock: cerror_pool_disable()
+ * clears it before draining, so a push racing with the drain either lands
+ * before the class is drained or is refused.
+ *
+ * @return 1 if the node was cached, 0 if the pool was disabled meanwhile
+ */
+static int cerror_pool_push(CErrorPoolClass* pClass, CErrorPoolNode* pNode)
+{
+    int bPushed = 0;
+
+    cerror_pool_lock(pClass);
+    if (0 != CERROR_ATOMIC_LOAD_U32(&g_uPoolEnabled))
+    {
+        pNode->pNext = pClass->pHead;
+        CERROR_ATOMIC_STORE_PTR(&pClass->pHead, pNode);
+        bPushed = 1;
+    }
+    cerror_pool_unlock(pClass);
+    return bPushed;
+}
+
+/**
+ * @brief Pop one node from a free list (NULL if empty)
+ */
+static CErrorPoolNode* cerror_pool_pop(CErrorPoolClass* pClass)
+{
+    CErrorPoolNode* pNode;
+
+    /* Unlocked peek: an empty class misses without touching the lock (head is stored atomically) */
+    if (NULL == CERROR_ATOMIC_LOAD_PTR(&pClass->pHead))
+    {
+        return NULL;
+    }
+
+    cerror_pool_lock(pClass);
+    pNode = pClass->pHead;
+    if (NULL != pNode)
+    {
+        CERROR_ATOMIC_STORE_PTR(&pClass->pHead, pNode->pNext);
+    }
+    cerror_pool_unlock(pClass);
+    return pNode;
+}
+
+/* ============================================================================
+ * Internal Pool Interface
+ * ============================================================================ */
+
+char* cerror_pool_take(size_t nCapacity)
+{
+    if (0 != CERROR_ATOMIC_LOAD_U32(&g_uPoolEnabled))
+    {
+        const int nClass = cerror_pool_class_of(nCapacity);
+        if (nClass >= 0)
+        {
+            CErrorPoolNode* pNode = cerror_pool_pop(&g_aPoolClasses[nClass]);
+            if (NULL != pNode)
+            {
+                CERROR_ATOMIC_SUB_U64(&g_ullPoolBytesHeld, (uint64_t)nCapacity);
+                CERROR_ATOMIC_SUB_U64(&g_ullPoolBuffersHeld, 1u);
+                CERROR_ATOMIC_ADD_U64(&g_ullPoolHits, 1u);
+                return (char*)pNode;
+            }
+            CERROR_ATOMIC_ADD_U64(&g_ullPoolMisses, 1u);
+        }
+    }
+    return NULL;
+}
+
+int cerror_pool_put(char* pBuffer, size_t nCapacity)
+{
+    if (0 != CERROR_ATOMIC_LOAD_U32(&g_uPoolEnabled))
+    {
+        const int nClass = cerror_pool_class_of(nCapacity);
+        if (nClass >= 0)
+        {
+            const uint64_t ullHeld = CERROR_ATOMIC_ADD_U64(&g_ullPoolBytesHeld, (uint64_t)nCapacity) + nCapacity;
+            if (ullHeld <= CERROR_ATOMIC_LOAD_U64(&g_ullPoolMaxBytesHeld) &&
+                cerror_pool_push(&g_aPoolClasses[nClass], (CErrorPoolNode*)(void*)pBuffer))
+            {
+                CERROR_ATOMIC_ADD_U64(&g_ullPoolBuffersHeld, 1u);
+                CERROR_ATOMIC_ADD_U64(&g_ullPoolReturned, 1u);
+                return 1;
+            }
+            /* Pool full or disabled meanwhile: give the bytes back, caller frees */
+            CERROR_ATOMIC_SUB_U64(&g_ullPoolBytesHeld, (uint64_t)nCapacity);
+            CERROR_ATOMIC_ADD_U64(&g_ullPoolDiscarded, 1u);
+        }
+    }
+    return 0;
+}
+
+void cerror_pool_drain(void)
+{
+    unsigned nClass;
+
+    for (nClass = 0; nClass < CERROR_POOL_CLASS_COUNT; ++nClass)
+    {
+        const size_t     nCapacity = (size_t)1 << (nClass + CERROR_POOL_MIN_CLASS_SHIFT);
+        CErrorPoolClass* pClass = &g_aPoolClasses[nClass];
+        CErrorPoolNode*  pNode;
+
+        /* Detach the whole list, free it outside the lock */
+        cerror_pool_lock(pClass);
+        pNode = pClass->pHead;
+        CERROR_ATOMIC_STORE_PTR(&pClass->pHead, (CErrorPoolNode*)NULL);
+        cerror_pool_unlock(pClass);
+
+        while (NULL != pNode)
+        {
+            CErrorPoolNode* pNext = pNode->pNext;
+            cerror_process_free(pNode, nCapacity);
+            CERROR_ATOMIC_SUB_U64(&g_ullPoolBytesHeld, (uint64_t)nCapacity);
+            CERROR_ATOMIC_SUB_U64(&g_ullPoolBuffersHeld, 1u);
+            pNode = pNext;
+        }
+    }
+}
+
+/* ============================================================================
+ * Public Pool API
+ * ============================================================================ */
+
+void cerror_pool_enable(size_t nMaxBytesHeld)
+{
+    CERROR_ATOMIC_STORE_U64(&g_ullPoolMaxBytesHeld, (uint64_t)nMaxBytesHeld);
+    CERROR_ATOMIC_STORE_U32(&g_uPoolEnabled, 1u);
+}
+
+void cerror_pool_disable(void)
+{
+    CERROR_ATOMIC_STORE_U32(&g_uPoolEnabled, 0u);
+
+    /* Buffers released from now on go straight to the allocator */
+    cerror_pool_drain();
+}
+
+void cerror_pool_get_stats(CErrorPoolStats* pStats)
+{
+    if (NULL == pStats)
+    {
+        return;
+    }
+    pStats->ullHits = CERROR_ATOMIC_LOAD_U64(&g_ullPoolHits);
+    pStats->ullMisses = CERROR_ATOMIC_LOAD_U64(&g_ullPoolMisses);
+    pStats->ullReturned = CERROR_ATOMIC_LOAD_U64(&g_ullPoolReturned);
+    pStats->ullDiscarded = CERROR_ATOMIC_LOAD_U64(&g_ullPoolDiscarded);
+    pStats->ullBytesHeld = CERROR_ATOMIC_LOAD_U64(&g_ullPoolBytesHeld);
+    pStats->ullBuffersHeld = CERROR_ATOMIC_LOAD_U64(&g_ullPoolBuffersHeld);
+}
@@ -0,0 +1,79 @@
+/** @file cerror_atomic.h
+ *  @brief Minimal atomic operations shim (internal, not installed)
+ *
+ *  Maps onto GCC/Clang __atomic builtins or MSVC Interlocked intrinsics so the
+ *  library does not depend on C11 <stdatomic.h> support.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+
+    #define CERROR_ATOMIC_LOAD_PTR(pp)              (*(void* volatile*)(pp))
+    #define CERROR_ATOMIC_STORE_PTR(pp, v)          ((void)_InterlockedExchangePointer((void* volatile*)(pp), (void*)(v)))
+    #define CERROR_ATOMIC_EXCHANGE_PTR(pp, v)       _InterlockedExchangePointer((void* volatile*)(pp), (void*)(v))
+    #define CERROR_ATOMIC_CAS_PTR(pp, expected, v) \
+        (_InterlockedCompareExchangePointer((void* volatile*)(pp), (void*)(v), (void*)(expected)) == (void*)(expected))
+
+    #define CERROR_ATOMIC_LOAD_U64(p)               ((uint64_t)_InterlockedCompareExchange64((volatile __int64*)(p), 0, 0))
+    #define CERROR_ATOMIC_STORE_U64(p, v)           ((void)_InterlockedExchange64((volatile __int64*)(p), (__int64)(v)))
+    #define CERROR_ATOMIC_ADD_U64(p, v)             ((uint64_t)_InterlockedExchangeAdd64((volatile __int64*)(p), (__int64)(v)))
+    #define CERROR_ATOMIC_SUB_U64(p, v)             ((uint64_t)_InterlockedExchangeAdd64((volatile __int64*)(p), -(__int64)(v)))
+    #define CERROR_ATOMIC_CAS_U64(p, expected, v) \
+        ((uint64_t)_InterlockedCompareExchange64((volatile __int64*)(p), (__int64)(v), (__int64)(expected)) == (uint64_t)(expected))
+
+    #define CERROR_ATOMIC_LOAD_U32(p)               ((uint32_t)_InterlockedCompareExchange((volatile long*)(p), 0, 0))
+    #define CERROR_ATOMIC_STORE_U32(p, v)           ((void)_InterlockedExchange((volatile long*)(p), (long)(v)))
+    #define CERROR_ATOMIC_ADD_U32(p, v)             ((uint32_t)_InterlockedExchangeAdd((volatile long*)(p), (long)(v)))
+    #define CERROR_ATOMIC_SUB_U32(p, v)             ((uint32_t)_InterlockedExchangeAdd((volatile long*)(p), -(long)(v)))
+    #define CERROR_ATOMIC_OR_U32(p, v)              ((uint32_t)_InterlockedOr((volatile long*)(p), (long)(v)))
+    #define CERROR_ATOMIC_AND_U32(p, v)             ((uint32_t)_InterlockedAnd((volatile long*)(p), (long)(v)))
+    #define CERROR_ATOMIC_CAS_U32(p, expected, v) \
+        ((uint32_t)_InterlockedCompareExchange((volatile long*)(p), (long)(v), (long)(expected)) == (uint32_t)(expected))
+#elif defined(__GNUC__) || defined(__clang__)
+    #define CERROR_ATOMIC_LOAD_PTR(pp)              __atomic_load_n((pp), __ATOMIC_ACQUIRE)
+    #define CERROR_ATOMIC_STORE_PTR(pp, v)          __atomic_store_n((pp), (v), __ATOMIC_RELEASE)
+    #define CERROR_ATOMIC_EXCHANGE_PTR(pp, v)       __atomic_exchange_n((pp), (v), __ATOMIC_ACQ_REL)
+    #define CERROR_ATOMIC_CAS_PTR(pp, expected, v) \
+        __extension__ ({ __typeof__(*(pp)) cerror_expected_ = (expected); \
+            __atomic_compare_exchange_n((pp), &cerror_expected_, (v), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); })
+
+    #define CERROR_ATOMIC_LOAD_U64(p)               __atomic_load_n((p), __ATOMIC_RELAXED)
+    #define CERROR_ATOMIC_STORE_U64(p, v)           __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+    #define CERROR_ATOMIC_ADD_U64(p, v)             __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+    #define CERROR_ATOMIC_SUB_U64(p, v)             __atomic_fetch_sub((p), (v), __ATOMIC_RELAXED)
+    #define CERROR_ATOMIC_CAS_U64(p, expected, v) \
+        __extension__ ({ uint64_t cerror_expected_ = (expected); \
+            __atomic_compare_exchange_n((p), &cerror_expected_, (v), 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED); })
+
+    #define CERROR_ATOMIC_LOAD_U32(p)               __atomic_load_n((p), __ATOMIC_ACQUIRE)
+    #define CERROR_ATOMIC_STORE_U32(p, v)           __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+    #define CERROR_ATOMIC_ADD_U32(p, v)             __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+    #define CERROR_ATOMIC_SUB_U32(p, v)             __atomic_fetch_sub((p), (v), __ATOMIC_ACQ_REL)
+    #define CERROR_ATOMIC_OR_U32(p, v)              __atomic_fetch_or((p), (v), __ATOMIC_ACQ_REL)
+    #define CERROR_ATOMIC_AND_U32(p, v)             __atomic_fetch_and((p), (v), __ATOMIC_ACQ_REL)
+    #define CERROR_ATOMIC_CAS_U32(p, expected, v) \
+        __extension__ ({ uint32_t cerror_expected_ = (expected); \
+            __atomic_compare_exchange_n((p), &cerror_expected_, (v), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); })
+#else
+    #error "Atomic operations not supported on this compiler"
+#endif
+
+/* Spin-wait hint: lets the sibling hyperthread run and saves power while a lock is held */
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+    #define CERROR_ATOMIC_PAUSE()                   _mm_pause()
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_ARM64)
+    #define CERROR_ATOMIC_PAUSE()                   __yield()
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define CERROR_ATOMIC_PAUSE()                   __builtin_ia32_pause()
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__aarch64__) || defined(__arm__))
+    #define CERROR_ATOMIC_PAUSE()                   __asm__ __volatile__("yield" ::: "memory")
+#else
+    #define CERROR_ATOMIC_PAUSE()                   ((void)0)
+#endif
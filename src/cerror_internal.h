@@ -0,0 +1,115 @@
+/** @file cerror_internal.h
+ *  @brief Internal helpers shared between c-error translation units (not installed)
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+#pragma once
+
+#include "c-error/lasterror.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * Context Buffer Management (lasterror.c)
+ * ============================================================================ */
+
+/**
+ * @brief Free the calling thread's heap info buffer (no-op for the in-context buffer)
+ *
+ * Clears the info pointer if it referred to the released buffer.
+ */
+void cerror_release_info_buffer(void);
+
+/* ============================================================================
+ * Clock Sources (clock.c)
+ * ============================================================================ */
+
+/**
+ * @brief Nanoseconds per TSC tick, calibrating once on first use (1.0 without an invariant TSC)
+ */
+double cerror_clock_tsc_ns_per_tick(void);
+
+/* ============================================================================
+ * Latency Histograms (latency.c)
+ * ============================================================================ */
+
+/**
+ * @brief Fold the calling thread's latency histograms into the process totals and free them
+ */
+void cerror_latency_release(void);
+
+/* ============================================================================
+ * Structured Payload (payload.c)
+ * ============================================================================ */
+
+/**
+ * @brief Free the calling thread's payload spill buffer (if any)
+ */
+void cerror_payload_release(void);
+
+/* ============================================================================
+ * Info Buffer Allocation (allocator.c)
+ * ============================================================================ */
+
+/**
+ * @brief Allocate an info buffer for the current thread
+ *
+ * Uses the thread allocator if one is set, otherwise the size-class pool (when
+ * enabled) and then the process-wide allocator.
+ *
+ * @return Buffer of at least nCapacity bytes, or NULL on failure
+ */
+char* cerror_buffer_alloc(size_t nCapacity);
+
+/**
+ * @brief Release an info buffer of the current thread
+ *
+ * @param pBuffer Buffer returned by cerror_buffer_alloc() (NULL allowed)
+ * @param nCapacity Capacity the buffer was allocated with
+ */
+void cerror_buffer_free(char* pBuffer, size_t nCapacity);
+
+/**
+ * @brief Allocate from the process-wide allocator (bypasses pool and thread allocator)
+ */
+void* cerror_process_alloc(size_t nSize);
+
+/**
+ * @brief Free to the process-wide allocator (bypasses pool and thread allocator)
+ */
+void cerror_process_free(void* pBlock, size_t nSize);
+
+/**
+ * @brief Add the current context's growth and copy counters to the process totals and reset them
+ */
+void cerror_memory_fold(void);
+
+/* ============================================================================
+ * Size-class Pool (bufferpool.c)
+ * ============================================================================ */
+
+/**
+ * @brief Take a cached buffer of exactly nCapacity bytes
+ *
+ * @return Cached buffer, or NULL if the pool is disabled, empty or the size is not pooled
+ */
+char* cerror_pool_take(size_t nCapacity);
+
+/**
+ * @brief Offer a buffer (allocated by the process-wide allocator) to the pool
+ *
+ * @return 1 if the pool kept the buffer, 0 if the caller must free it
+ */
+int cerror_pool_put(char* pBuffer, size_t nCapacity);
+
+/**
+ * @brief Free all cached buffers to the process-wide allocator
+ */
+void cerror_pool_drain(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,309 @@
+/** @file clock.c
+ *  @brief Clock Sources for Error Timestamps
+ *
+ *  Timestamps are stored raw on set (TSC ticks or nanoseconds) and converted
+ *  to CLOCK_MONOTONIC nanoseconds only when read. The TSC is only used when
+ *  invariant; its rate is calibrated against CLOCK_MONOTONIC once per process,
+ *  under a once-flag whose release store publishes the conversion.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+/* clock_gettime */
+#if !defined(_WIN32) && !defined(_GNU_SOURCE) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "c-error/lasterror.h"
+#include "cerror_internal.h"
+#include "cerror_atomic.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define CERROR_HAVE_TSC 1
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+        #include <x86intrin.h>
+    #endif
+#endif
+
+/** Calibration interval of the TSC rate */
+#define CERROR_TSC_CALIBRATION_NS 10000000ULL
+
+/** Once-flag states */
+#define CERROR_ONCE_PENDING 0u
+#define CERROR_ONCE_RUNNING 1u
+#define CERROR_ONCE_DONE    2u
+
+CErrorClockSource g_CErrorClockSource = CERROR_CLOCK_NONE;
+
+/** Clock of the latency histograms (CERROR_LATENCY_CLOCK_*), chosen on first use */
+CErrorFlagLine g_CErrorLatencyClock = { CERROR_LATENCY_CLOCK_UNKNOWN };
+
+#if defined(CERROR_HAVE_TSC)
+/** Invariance check result (valid once g_uTscInvariantOnce is done) */
+static uint32_t g_uTscInvariantOnce = CERROR_ONCE_PENDING;
+static int      g_bTscInvariant = 0;
+
+/**
+ * TSC -> CLOCK_MONOTONIC conversion: ns = ullTscBaseNs + (ticks - ullTscBaseTicks) * dTscNsPerTick
+ * (written once, valid once g_uTscCalibrationOnce is done)
+ */
+static uint32_t g_uTscCalibrationOnce = CERROR_ONCE_PENDING;
+static uint64_t g_ullTscBaseTicks = 0;
+static uint64_t g_ullTscBaseNs = 0;
+static double   g_dTscNsPerTick = 0.0;
+
+/**
+ * @brief Enter a once-flag
+ *
+ * @return 1 if the caller must run the initialization and call
+ *         cerror_once_end(), 0 once it is done (waits while another thread runs it)
+ */
+static int cerror_once_begin(uint32_t* puOnce)
+{
+    if (CERROR_ONCE_DONE == CERROR_ATOMIC_LOAD_U32(puOnce))
+    {
+        return 0;
+    }
+    if (CERROR_ATOMIC_CAS_U32(puOnce, CERROR_ONCE_PENDING, CERROR_ONCE_RUNNING))
+    {
+        return 1;
+    }
+    while (CERROR_ONCE_DONE != CERROR_ATOMIC_LOAD_U32(puOnce))
+    {
+    }
+    return 0;
+}
+
+/**
+ * @brief Publish the results of an initialization (release)
+ */
+static void cerror_once_end(uint32_t* puOnce)
+{
+    CERROR_ATOMIC_STORE_U32(puOnce, CERROR_ONCE_DONE);
+}
+#endif
+
+/* ============================================================================
+ * Platform Clocks
+ * ============================================================================ */
+
+uint64_t cerror_clock_now_ns(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Coarse monotonic time (same base as cerror_clock_now_ns(), tick resolution)
+ */
+static uint64_t cerror_clock_coarse_ns(void)
+{
+#if defined(_WIN32)
+    return (uint64_t)GetTickCount64() * 1000000ULL;
+#elif defined(CLOCK_MONOTONIC_COARSE)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+    return cerror_clock_now_ns();
+#endif
+}
+
+#if defined(CERROR_HAVE_TSC)
+/**
+ * @brief Check for an invariant TSC (constant rate across P-/C-states and cores)
+ */
+static int cerror_tsc_is_invariant(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int aRegs[4];
+    __cpuid(aRegs, 0x80000000);
+    if ((unsigned int)aRegs[0] < 0x80000007u)
+    {
+        return 0;
+    }
+    __cpuid(aRegs, 0x80000007);
+    return 0 != (aRegs[3] & (1 << 8));
+#else
+    unsigned int uEax, uEbx, uEcx, uEdx;
+    if (!__get_cpuid(0x80000007u, &uEax, &uEbx, &uEcx, &uEdx))
+    {
+        return 0;
+    }
+    return 0 != (uEdx & (1u << 8));
+#endif
+}
+
+/**
+ * @brief Check the TSC for invariance once per process
+ */
+static int cerror_tsc_available(void)
+{
+    if (cerror_once_begin(&g_uTscInvariantOnce))
+    {
+        g_bTscInvariant = cerror_tsc_is_invariant();
+        cerror_once_end(&g_uTscInvariantOnce);
+    }
+    return g_bTscInvariant;
+}
+
+/**
+ * @brief Measure the TSC rate against CLOCK_MONOTONIC
+ */
+static void cerror_tsc_calibrate(void)
+{
+    const uint64_t ullStartNs = cerror_clock_now_ns();
+    const uint64_t ullStartTicks = __rdtsc();
+    uint64_t       ullEndNs;
+    uint64_t       ullEndTicks;
+
+    do
+    {
+        ullEndNs = cerror_clock_now_ns();
+        ullEndTicks = __rdtsc();
+    } while (ullEndNs - ullStartNs < CERROR_TSC_CALIBRATION_NS);
+
+    g_dTscNsPerTick = (double)(ullEndNs - ullStartNs) / (double)(ullEndTicks - ullStartTicks);
+    g_ullTscBaseTicks = ullEndTicks;
+    g_ullTscBaseNs = ullEndNs;
+}
+
+/**
+ * @brief Calibrate an invariant TSC once per process (about 10 ms, concurrent callers wait)
+ *
+ * @return 1 if the conversion is published, 0 if the TSC is not invariant
+ */
+static int cerror_tsc_calibrated(void)
+{
+    if (!cerror_tsc_available())
+    {
+        return 0;
+    }
+    if (cerror_once_begin(&g_uTscCalibrationOnce))
+    {
+        cerror_tsc_calibrate();
+        cerror_once_end(&g_uTscCalibrationOnce);
+    }
+    return 1;
+}
+#endif
+
+/* ============================================================================
+ * Clock Source Selection
+ * ============================================================================ */
+
+int cerror_set_clock_source(CErrorClockSource eSource)
+{
+    switch (eSource)
+    {
+        case CERROR_CLOCK_NONE:
+        case CERROR_CLOCK_COARSE:
+            break;
+        case CERROR_CLOCK_TSC:
+#if defined(CERROR_HAVE_TSC)
+            if (!cerror_tsc_calibrated())
+            {
+                return 0;
+            }
+            break;
+#else
+            return 0;
+#endif
+        default:
+            return 0;
+    }
+
+    g_CErrorClockSource = eSource;
+    if (CERROR_CLOCK_NONE != eSource)
+    {
+        (void)CERROR_ATOMIC_OR_U32(&g_CErrorSetHooks.uValue, CERROR_HOOK_TIMESTAMP);
+    }
+    else
+    {
+        (void)CERROR_ATOMIC_AND_U32(&g_CErrorSetHooks.uValue, ~CERROR_HOOK_TIMESTAMP);
+    }
+    return 1;
+}
+
+CErrorClockSource cerror_get_clock_source(void)
+{
+    return g_CErrorClockSource;
+}
+
+uint64_t cerror_clock_read(void)
+{
+#if defined(CERROR_HAVE_TSC)
+    if (CERROR_CLOCK_TSC == g_CErrorClockSource)
+    {
+        return __rdtsc();
+    }
+#endif
+    return cerror_clock_coarse_ns();
+}
+
+double cerror_clock_tsc_ns_per_tick(void)
+{
+#if defined(CERROR_HAVE_TSC)
+    if (cerror_tsc_calibrated())
+    {
+        return g_dTscNsPerTick;
+    }
+#endif
+    return 1.0;
+}
+
+uint32_t cerror_latency_clock_init(void)
+{
+    uint32_t uClock = CERROR_LATENCY_CLOCK_MONOTONIC;
+
+#if defined(CERROR_HAVE_TSC) && (defined(__GNUC__) || defined(__clang__))
+    /* cerror_latency_ticks() reads the TSC only where it has the builtin */
+    if (cerror_tsc_available())
+    {
+        uClock = CERROR_LATENCY_CLOCK_TSC;
+    }
+#endif
+    CERROR_ATOMIC_STORE_U32(&g_CErrorLatencyClock.uValue, uClock);
+    return uClock;
+}
+
+uint64_t cerror_get_last_timestamp_ns(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    const uint64_t ullRaw = pCtx->ullTimestamp;
+
+    if (0 == (pCtx->ullLastError & CERROR_FLAG_HAS_TIMESTAMP))
+    {
+        return 0ULL;
+    }
+
+#if defined(CERROR_HAVE_TSC)
+    /* The source is only TSC after calibration; the check acquires the conversion */
+    if (CERROR_CLOCK_TSC == g_CErrorClockSource && cerror_tsc_calibrated())
+    {
+        /* Signed delta: the error may predate the calibration base */
+        const double dDeltaNs = (double)(int64_t)(ullRaw - g_ullTscBaseTicks) * g_dTscNsPerTick;
+        return (uint64_t)((int64_t)g_ullTscBaseNs + (int64_t)dDeltaNs);
+    }
+#endif
+    return ullRaw;
+}
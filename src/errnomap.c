@@ -0,0 +1,234 @@
+/** @file errnomap.c
+ *  @brief errno <-> Status Mapping and Lazy strerror Rendering
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+/* XSI strerror_r (unless the build already selected the GNU variant) */
+#if !defined(_WIN32) && !defined(_GNU_SOURCE) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "cerror_internal.h"
+
+#include <errno.h>
+#include <stdio.h>
+
+/* ============================================================================
+ * errno -> Status Table
+ * ============================================================================ */
+
+/**
+ * @brief One errno mapping (follows the common errno-to-gRPC conventions)
+ */
+typedef struct CErrorErrnoMapping
+{
+    int              nErrno;
+    CErrorStatusCode eStatus;
+} CErrorErrnoMapping;
+
+static const CErrorErrnoMapping s_aErrnoMap[] = {
+    { EINVAL,        CERROR_INVALID_ARGUMENT },
+    { E2BIG,         CERROR_INVALID_ARGUMENT },
+    { EDOM,          CERROR_INVALID_ARGUMENT },
+    { EFAULT,        CERROR_INVALID_ARGUMENT },
+    { EILSEQ,        CERROR_INVALID_ARGUMENT },
+    { ENAMETOOLONG,  CERROR_INVALID_ARGUMENT },
+    { ENOTTY,        CERROR_INVALID_ARGUMENT },
+    { ESPIPE,        CERROR_INVALID_ARGUMENT },
+    { ETIMEDOUT,     CERROR_DEADLINE_EXCEEDED },
+    { ENOENT,        CERROR_NOT_FOUND },
+    { ENODEV,        CERROR_NOT_FOUND },
+    { ENXIO,         CERROR_NOT_FOUND },
+    { ESRCH,         CERROR_NOT_FOUND },
+    { EEXIST,        CERROR_ALREADY_EXISTS },
+    { EPERM,         CERROR_PERMISSION_DENIED },
+    { EACCES,        CERROR_PERMISSION_DENIED },
+    { EROFS,         CERROR_PERMISSION_DENIED },
+    { ENOTEMPTY,     CERROR_FAILED_PRECONDITION },
+    { EISDIR,        CERROR_FAILED_PRECONDITION },
+    { ENOTDIR,       CERROR_FAILED_PRECONDITION },
+    { EBADF,         CERROR_FAILED_PRECONDITION },
+    { EBUSY,         CERROR_FAILED_PRECONDITION },
+    { ECHILD,        CERROR_FAILED_PRECONDITION },
+    { EPIPE,         CERROR_FAILED_PRECONDITION },
+    { ENOSPC,        CERROR_RESOURCE_EXHAUSTED },
+    { EMFILE,        CERROR_RESOURCE_EXHAUSTED },
+    { EMLINK,        CERROR_RESOURCE_EXHAUSTED },
+    { ENFILE,        CERROR_RESOURCE_EXHAUSTED },
+    { ENOMEM,        CERROR_RESOURCE_EXHAUSTED },
+    { EFBIG,         CERROR_OUT_OF_RANGE },
+    { ERANGE,        CERROR_OUT_OF_RANGE },
+    { ENOSYS,        CERROR_UNIMPLEMENTED },
+    { EXDEV,         CERROR_UNIMPLEMENTED },
+    { EAGAIN,        CERROR_UNAVAILABLE },
+    { EINTR,         CERROR_UNAVAILABLE },
+    { EIO,           CERROR_UNAVAILABLE },
+    { EDEADLK,       CERROR_ABORTED },
+#ifdef ECANCELED
+    { ECANCELED,     CERROR_CANCELLED },
+#endif
+#ifdef EOVERFLOW
+    { EOVERFLOW,     CERROR_OUT_OF_RANGE },
+#endif
+#ifdef ENOTSUP
+    { ENOTSUP,       CERROR_UNIMPLEMENTED },
+#endif
+#ifdef EAFNOSUPPORT
+    { EAFNOSUPPORT,  CERROR_UNIMPLEMENTED },
+#endif
+#ifdef EPROTONOSUPPORT
+    { EPROTONOSUPPORT, CERROR_UNIMPLEMENTED },
+#endif
+#ifdef EADDRINUSE
+    { EADDRINUSE,    CERROR_FAILED_PRECONDITION },
+#endif
+#ifdef EADDRNOTAVAIL
+    { EADDRNOTAVAIL, CERROR_UNAVAILABLE },
+#endif
+#ifdef EALREADY
+    { EALREADY,      CERROR_FAILED_PRECONDITION },
+#endif
+#ifdef EISCONN
+    { EISCONN,       CERROR_FAILED_PRECONDITION },
+#endif
+#ifdef ENOTCONN
+    { ENOTCONN,      CERROR_FAILED_PRECONDITION },
+#endif
+#ifdef ENOBUFS
+    { ENOBUFS,       CERROR_RESOURCE_EXHAUSTED },
+#endif
+#ifdef EDQUOT
+    { EDQUOT,        CERROR_RESOURCE_EXHAUSTED },
+#endif
+#ifdef ECONNREFUSED
+    { ECONNREFUSED,  CERROR_UNAVAILABLE },
+#endif
+#ifdef ECONNABORTED
+    { ECONNABORTED,  CERROR_UNAVAILABLE },
+#endif
+#ifdef ECONNRESET
+    { ECONNRESET,    CERROR_UNAVAILABLE },
+#endif
+#ifdef EHOSTUNREACH
+    { EHOSTUNREACH,  CERROR_UNAVAILABLE },
+#endif
+#ifdef ENETDOWN
+    { ENETDOWN,      CERROR_UNAVAILABLE },
+#endif
+#ifdef ENETUNREACH
+    { ENETUNREACH,   CERROR_UNAVAILABLE },
+#endif
+#ifdef ENOLCK
+    { ENOLCK,        CERROR_UNAVAILABLE },
+#endif
+#ifdef ESTALE
+    { ESTALE,        CERROR_ABORTED },
+#endif
+};
+
+CErrorStatusCode cerror_errno_to_status(const int errnum)
+{
+    size_t i;
+
+    if (0 == errnum)
+    {
+        return CERROR_OK;
+    }
+    /* Aliases (EWOULDBLOCK == EAGAIN, EOPNOTSUPP == ENOTSUP on most platforms) match the first entry */
+    for (i = 0; i < sizeof(s_aErrnoMap) / sizeof(s_aErrnoMap[0]); ++i)
+    {
+        if (s_aErrnoMap[i].nErrno == errnum)
+        {
+            return s_aErrnoMap[i].eStatus;
+        }
+    }
+#if defined(EWOULDBLOCK)
+    if (EWOULDBLOCK == errnum)
+    {
+        return CERROR_UNAVAILABLE;
+    }
+#endif
+#if defined(EOPNOTSUPP)
+    if (EOPNOTSUPP == errnum)
+    {
+        return CERROR_UNIMPLEMENTED;
+    }
+#endif
+    return CERROR_UNKNOWN;
+}
+
+int cerror_status_to_errno(const CErrorStatusCode status)
+{
+    switch (status) {
+        case CERROR_OK:                  return 0;
+#ifdef ECANCELED
+        case CERROR_CANCELLED:           return ECANCELED;
+#else
+        case CERROR_CANCELLED:           return EINTR;
+#endif
+        case CERROR_INVALID_ARGUMENT:    return EINVAL;
+        case CERROR_DEADLINE_EXCEEDED:   return ETIMEDOUT;
+        case CERROR_NOT_FOUND:           return ENOENT;
+        case CERROR_ALREADY_EXISTS:      return EEXIST;
+        case CERROR_PERMISSION_DENIED:   return EACCES;
+        case CERROR_UNAUTHENTICATED:     return EPERM;
+        case CERROR_RESOURCE_EXHAUSTED:  return ENOMEM;
+        case CERROR_FAILED_PRECONDITION: return EINVAL;
+        case CERROR_ABORTED:             return EDEADLK;
+        case CERROR_OUT_OF_RANGE:        return ERANGE;
+        case CERROR_UNIMPLEMENTED:       return ENOSYS;
+        case CERROR_UNAVAILABLE:         return EAGAIN;
+        case CERROR_DATA_LOSS:           return EIO;
+        case CERROR_INTERNAL:            return EIO;
+        case CERROR_UNKNOWN:             return EIO;
+        default:                         return EIO;
+    }
+}
+
+/* ============================================================================
+ * Lazy Info Rendering
+ * ============================================================================ */
+
+/**
+ * @brief Thread-safe strerror into a caller buffer (platform variants)
+ */
+static void cerror_strerror(const int errnum, char* pszBuffer, size_t nSize)
+{
+#if defined(_WIN32)
+    if (0 != strerror_s(pszBuffer, nSize, errnum))
+    {
+        snprintf(pszBuffer, nSize, "errno %d", errnum);
+    }
+#elif defined(_GNU_SOURCE) && defined(__GLIBC__)
+    /* GNU variant returns the message (possibly a static string) */
+    const char* pszMessage = strerror_r(errnum, pszBuffer, nSize);
+    if (pszMessage != pszBuffer)
+    {
+        snprintf(pszBuffer, nSize, "%s", pszMessage);
+    }
+#else
+    if (0 != strerror_r(errnum, pszBuffer, nSize))
+    {
+        snprintf(pszBuffer, nSize, "errno %d", errnum);
+    }
+#endif
+}
+
+const char* cerror_render_lazy_info(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    char szMessage[128];
+
+    if (0 == (pCtx->ullLastError & CERROR_FLAG_FROM_ERRNO))
+    {
+        return "";
+    }
+
+    cerror_strerror((int)cerror_get_last_code(), szMessage, sizeof(szMessage));
+
+    /* Store like a copied info (keeps the code and its flags) */
+    cerror_set_last_info_copy_slow(szMessage, strlen(szMessage));
+    return (NULL != pCtx->pszLastErrorInfo) ? pCtx->pszLastErrorInfo : "";
+}
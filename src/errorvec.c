@@ -0,0 +1,257 @@
+/** @file errorvec.c
+ *  @brief Columnar Per-row Error Vector Implementation
+ *
+ *  Every operation walks the bitmap one 64-row word at a time. Inner loops
+ *  over the rows of a word are branch-free selects so they vectorize; words
+ *  without errors are skipped with a single test.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "c-error/errorvec.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+/* ============================================================================
+ * Bit Helpers
+ * ============================================================================ */
+
+/**
+ * @brief Number of set bits
+ */
+static inline size_t cerror_popcount64(uint64_t ullWord)
+{
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    return (size_t)__popcnt64(ullWord);
+#elif defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcountll(ullWord);
+#else
+    size_t nCount = 0;
+    while (0 != ullWord)
+    {
+        ullWord &= ullWord - 1;
+        nCount++;
+    }
+    return nCount;
+#endif
+}
+
+/**
+ * @brief Index of the lowest set bit (ullWord != 0)
+ */
+static inline unsigned cerror_ctz64(uint64_t ullWord)
+{
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    unsigned long uIndex;
+    _BitScanForward64(&uIndex, ullWord);
+    return (unsigned)uIndex;
+#elif defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(ullWord);
+#else
+    unsigned uIndex = 0;
+    while (0 == (ullWord & 1u))
+    {
+        ullWord >>= 1;
+        uIndex++;
+    }
+    return uIndex;
+#endif
+}
+
+/**
+ * @brief Mask of the first nRows rows in bitmap word nWord (the last word may be partial)
+ */
+static inline uint64_t cerror_vector_rows_mask(size_t nRows, size_t nWord)
+{
+    const size_t nRowsLeft = nRows - nWord * 64u;
+    return (nRowsLeft >= 64u) ? ~0ULL : ((1ULL << nRowsLeft) - 1u);
+}
+
+/**
+ * @brief Store ullError into the rows of word nWord whose bit is set in ullBits (branch-free)
+ */
+static inline void cerror_vector_fill_word(CErrorVector* pVector, size_t nWord, uint64_t ullBits, uint64_t ullError)
+{
+    uint64_t* const pCodes = pVector->pCodes + nWord * 64u;
+    const size_t    nRows = (pVector->nRows - nWord * 64u < 64u) ? pVector->nRows - nWord * 64u : 64u;
+    size_t          i;
+
+    for (i = 0; i < nRows; ++i)
+    {
+        const uint64_t ullSelect = 0ULL - ((ullBits >> i) & 1u);
+        pCodes[i] = (ullError & ullSelect) | (pCodes[i] & ~ullSelect);
+    }
+}
+
+/* ============================================================================
+ * Setup
+ * ============================================================================ */
+
+void cerror_vector_init(CErrorVector* pVector, uint64_t* pCodes, uint64_t* pValidity, size_t nRows)
+{
+    pVector->pCodes = pCodes;
+    pVector->pValidity = pValidity;
+    pVector->nRows = nRows;
+    cerror_vector_reset(pVector);
+}
+
+void cerror_vector_reset(CErrorVector* pVector)
+{
+    memset(pVector->pValidity, 0, CERROR_VECTOR_BITMAP_WORDS(pVector->nRows) * sizeof(uint64_t));
+}
+
+/* ============================================================================
+ * Bulk Operations
+ * ============================================================================ */
+
+void cerror_vector_set_flags(CErrorVector* pVector, const uint8_t* pFlags, uint64_t ullError)
+{
+    const size_t nWords = CERROR_VECTOR_BITMAP_WORDS(pVector->nRows);
+    size_t       w;
+
+    ullError &= VALID_ERROR_MASK;
+    for (w = 0; w < nWords; ++w)
+    {
+        const uint8_t* const pWordFlags = pFlags + w * 64u;
+        const size_t         nRows = (pVector->nRows - w * 64u < 64u) ? pVector->nRows - w * 64u : 64u;
+        uint64_t             ullBits = 0;
+        size_t               i;
+
+        /* Pack flag bytes into a bitmap word */
+        for (i = 0; i < nRows; ++i)
+        {
+            ullBits |= (uint64_t)(0 != pWordFlags[i]) << i;
+        }
+        if (0 != ullBits)
+        {
+            pVector->pValidity[w] |= ullBits;
+            cerror_vector_fill_word(pVector, w, ullBits, ullError);
+        }
+    }
+}
+
+void cerror_vector_set_mask(CErrorVector* pVector, const uint64_t* pMask, uint64_t ullError)
+{
+    const size_t nWords = CERROR_VECTOR_BITMAP_WORDS(pVector->nRows);
+    size_t       w;
+
+    ullError &= VALID_ERROR_MASK;
+    for (w = 0; w < nWords; ++w)
+    {
+        const uint64_t ullBits = pMask[w] & cerror_vector_rows_mask(pVector->nRows, w);
+
+        if (0 != ullBits)
+        {
+            pVector->pValidity[w] |= ullBits;
+            cerror_vector_fill_word(pVector, w, ullBits, ullError);
+        }
+    }
+}
+
+void cerror_vector_merge(CErrorVector* pTarget, const CErrorVector* pSource)
+{
+    const size_t nRows = (pTarget->nRows < pSource->nRows) ? pTarget->nRows : pSource->nRows;
+    const size_t nWords = CERROR_VECTOR_BITMAP_WORDS(nRows);
+    size_t       w;
+
+    for (w = 0; w < nWords; ++w)
+    {
+        /* Rows that failed in the source only, within both vectors */
+        const uint64_t ullNew = pSource->pValidity[w] & ~pTarget->pValidity[w] & cerror_vector_rows_mask(nRows, w);
+
+        if (0 != ullNew)
+        {
+            uint64_t* const       pDst = pTarget->pCodes + w * 64u;
+            const uint64_t* const pSrc = pSource->pCodes + w * 64u;
+            const size_t          nWordRows = (nRows - w * 64u < 64u) ? nRows - w * 64u : 64u;
+            size_t                i;
+
+            for (i = 0; i < nWordRows; ++i)
+            {
+                const uint64_t ullSelect = 0ULL - ((ullNew >> i) & 1u);
+                pDst[i] = (pSrc[i] & ullSelect) | (pDst[i] & ~ullSelect);
+            }
+            pTarget->pValidity[w] |= ullNew;
+        }
+    }
+}
+
+/* ============================================================================
+ * Queries
+ * ============================================================================ */
+
+int cerror_vector_any(const CErrorVector* pVector)
+{
+    const size_t nWords = CERROR_VECTOR_BITMAP_WORDS(pVector->nRows);
+    uint64_t     ullAny = 0;
+    size_t       w;
+
+    /* No early exit: a plain OR reduction vectorizes */
+    for (w = 0; w < nWords; ++w)
+    {
+        ullAny |= pVector->pValidity[w];
+    }
+    return 0 != ullAny;
+}
+
+size_t cerror_vector_first(const CErrorVector* pVector)
+{
+    const size_t nWords = CERROR_VECTOR_BITMAP_WORDS(pVector->nRows);
+    size_t       w;
+
+    for (w = 0; w < nWords; ++w)
+    {
+        if (0 != pVector->pValidity[w])
+        {
+            return w * 64u + cerror_ctz64(pVector->pValidity[w]);
+        }
+    }
+    return CERROR_VECTOR_NONE;
+}
+
+size_t cerror_vector_count(const CErrorVector* pVector)
+{
+    const size_t nWords = CERROR_VECTOR_BITMAP_WORDS(pVector->nRows);
+    size_t       nCount = 0;
+    size_t       w;
+
+    for (w = 0; w < nWords; ++w)
+    {
+        nCount += cerror_popcount64(pVector->pValidity[w]);
+    }
+    return nCount;
+}
+
+void cerror_vector_count_by_status(const CErrorVector* pVector, size_t aCounts[MAX_STATUS + 1])
+{
+    const size_t nWords = CERROR_VECTOR_BITMAP_WORDS(pVector->nRows);
+    size_t       w;
+
+    memset(aCounts, 0, (MAX_STATUS + 1) * sizeof(size_t));
+    for (w = 0; w < nWords; ++w)
+    {
+        uint64_t ullBits = pVector->pValidity[w];
+
+        /* Visit only the failed rows of the word */
+        while (0 != ullBits)
+        {
+            const size_t nRow = w * 64u + cerror_ctz64(ullBits);
+            aCounts[GET_STATUS(pVector->pCodes[nRow])]++;
+            ullBits &= ullBits - 1;
+        }
+    }
+}
+
+size_t cerror_vector_to_last(const CErrorVector* pVector)
+{
+    const size_t nRow = cerror_vector_first(pVector);
+
+    if (CERROR_VECTOR_NONE != nRow)
+    {
+        cerror_set_last(pVector->pCodes[nRow]);
+    }
+    return nRow;
+}
@@ -0,0 +1,62 @@
+/** @file frames.c
+ *  @brief Scoped Annotation Frames Implementation
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "c-error/frames.h"
+
+#include <stdio.h>
+
+void cerror_frames_detach(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (0 != (pCtx->ullLastError & CERROR_FLAG_HAS_FRAMES))
+    {
+        memcpy(pCtx->aFrameSnapshot, pCtx->aFrames, pCtx->uFramesPinned * sizeof(CErrorFrame));
+    }
+    pCtx->uFramesPinned = 0;
+}
+
+/**
+ * @brief snprintf at offset nLength of the output, advancing nLength by the full length
+ */
+static void cerror_frames_append(char* pszBuffer, size_t nSize, size_t* pnLength,
+                                 const char* pszFormat, const CErrorFrame* pFrame)
+{
+    char* const  pszOut = (*pnLength < nSize) ? pszBuffer + *pnLength : NULL;
+    const size_t nRemaining = (NULL != pszOut) ? nSize - *pnLength : 0;
+    const int    nWritten = (NULL != pFrame)
+                          ? snprintf(pszOut, nRemaining, pszFormat, (long long)pFrame->llArg0, (long long)pFrame->llArg1)
+                          : snprintf(pszOut, nRemaining, "%s", pszFormat);
+
+    if (nWritten > 0)
+    {
+        *pnLength += (size_t)nWritten;
+    }
+}
+
+size_t cerror_frames_render(char* pszBuffer, size_t nSize)
+{
+    const CErrorFrame* const pFrames = cerror_get_frames();
+    const uint32_t           uCount = cerror_get_frame_count();
+    size_t                   nLength = 0;
+    uint32_t                 i;
+
+    if (nSize > 0)
+    {
+        pszBuffer[0] = '\0';
+    }
+
+    for (i = 0; i < uCount; ++i)
+    {
+        if (i > 0)
+        {
+            cerror_frames_append(pszBuffer, nSize, &nLength, " / ", NULL);
+        }
+        cerror_frames_append(pszBuffer, nSize, &nLength, pFrames[i].pszFormat, &pFrames[i]);
+    }
+    return nLength;
+}
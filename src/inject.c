@@ -0,0 +1,480 @@
+/** @file inject.c
+ *  @brief Fault Injection Implementation
+ *
+ *  Points are registered on first use in a fixed open-addressing table keyed
+ *  by (file, line); a slot is claimed with a CAS and published once its key is
+ *  written. Counters are relaxed atomics. Rules are appended and published by
+ *  a release store of the rule count.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "c-error/inject.h"
+#include "cerror_atomic.h"
+
+#include <stdio.h>
+#include <ctype.h>
+
+/** Slot states */
+#define CERROR_INJECT_SLOT_FREE     0u
+#define CERROR_INJECT_SLOT_CLAIMED  1u
+#define CERROR_INJECT_SLOT_READY    2u
+
+/**
+ * @brief Injection point slot
+ */
+typedef struct CErrorInjectPoint
+{
+    uint32_t    uState;         /**< CERROR_INJECT_SLOT_* */
+    int         nLine;
+    const char* pszFile;
+    uint64_t    ullError;
+    uint64_t    ullCalls;
+    uint64_t    ullInjected;
+} CErrorInjectPoint;
+
+/**
+ * @brief Rule with its injection counter
+ */
+typedef struct CErrorInjectRuleSlot
+{
+    CErrorInjectRule stRule;
+    uint32_t         uInjected;
+} CErrorInjectRuleSlot;
+
+/** Read at every point: a full cache line of its own, away from the counters */
+CErrorFlagLine g_CErrorInjectActive = { 0 };
+
+static CErrorInjectRuleSlot g_aInjectRules[CERROR_INJECT_MAX_RULES];
+static uint32_t             g_uInjectRuleCount = 0;
+static CErrorInjectPoint    g_aInjectPoints[CERROR_INJECT_MAX_POINTS];
+static uint64_t             g_ullInjectSeed = 0x9E3779B97F4A7C15ULL;
+static uint64_t             g_ullInjectThreadCount = 0;
+
+/** Bumped (release) by cerror_inject_seed() after the seed and thread count are reset */
+static uint32_t             g_uInjectSeedGeneration = 1;
+
+/** Per-thread xorshift state and the seed generation it was derived from (0: none) */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+    static _Thread_local uint64_t g_ullInjectRandom = 0;
+    static _Thread_local uint32_t g_uInjectRandomGeneration = 0;
+#elif defined(_MSC_VER)
+    static __declspec(thread) uint64_t g_ullInjectRandom = 0;
+    static __declspec(thread) uint32_t g_uInjectRandomGeneration = 0;
+#else
+    static __thread uint64_t g_ullInjectRandom = 0;
+    static __thread uint32_t g_uInjectRandomGeneration = 0;
+#endif
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static uint64_t cerror_inject_mix(uint64_t ullValue)
+{
+    ullValue += 0x9E3779B97F4A7C15ULL;
+    ullValue = (ullValue ^ (ullValue >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    ullValue = (ullValue ^ (ullValue >> 27)) * 0x94D049BB133111EBULL;
+    return ullValue ^ (ullValue >> 31);
+}
+
+/**
+ * @brief Uniform random number in [0, 1) from the calling thread's generator
+ *
+ * A thread (re)derives its stream on its first draw after each seed, from the
+ * seed and its number in the order of those first draws.
+ */
+static double cerror_inject_random(void)
+{
+    const uint32_t uGeneration = CERROR_ATOMIC_LOAD_U32(&g_uInjectSeedGeneration);
+    uint64_t       ullState = g_ullInjectRandom;
+
+    if (uGeneration != g_uInjectRandomGeneration)
+    {
+        const uint64_t ullThread = CERROR_ATOMIC_ADD_U64(&g_ullInjectThreadCount, 1u);
+        ullState = cerror_inject_mix(CERROR_ATOMIC_LOAD_U64(&g_ullInjectSeed) ^ cerror_inject_mix(ullThread)) | 1u;
+        g_uInjectRandomGeneration = uGeneration;
+    }
+    ullState ^= ullState << 13;
+    ullState ^= ullState >> 7;
+    ullState ^= ullState << 17;
+    g_ullInjectRandom = ullState;
+    return (double)(ullState >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Find or register the point of (pszFile, nLine)
+ *
+ * @return Point, or NULL if the table is full
+ */
+static CErrorInjectPoint* cerror_inject_point(uint64_t ullError, const char* pszFile, int nLine)
+{
+    const uint64_t ullHash = cerror_inject_mix((uint64_t)(uintptr_t)pszFile ^ ((uint64_t)(uint32_t)nLine << 48));
+    uint32_t       uProbe;
+
+    for (uProbe = 0; uProbe < CERROR_INJECT_MAX_POINTS; ++uProbe)
+    {
+        CErrorInjectPoint* const pPoint = &g_aInjectPoints[(ullHash + uProbe) % CERROR_INJECT_MAX_POINTS];
+        uint32_t                 uState = CERROR_ATOMIC_LOAD_U32(&pPoint->uState);
+
+        if (CERROR_INJECT_SLOT_FREE == uState && CERROR_ATOMIC_CAS_U32(&pPoint->uState, CERROR_INJECT_SLOT_FREE, CERROR_INJECT_SLOT_CLAIMED))
+        {
+            pPoint->pszFile = pszFile;
+            pPoint->nLine = nLine;
+            pPoint->ullError = ullError & VALID_ERROR_MASK;
+            CERROR_ATOMIC_STORE_U32(&pPoint->uState, CERROR_INJECT_SLOT_READY);
+            return pPoint;
+        }
+
+        /* Another thread is writing the key of this slot */
+        while (CERROR_INJECT_SLOT_CLAIMED == (uState = CERROR_ATOMIC_LOAD_U32(&pPoint->uState)))
+        {
+        }
+        if (pPoint->pszFile == pszFile && pPoint->nLine == nLine)
+        {
+            return pPoint;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Consume one injection of a limited rule
+ *
+ * The count is only incremented while below the limit, so it never passes it.
+ *
+ * @return 1 if the rule may inject, 0 if its limit is reached
+ */
+static int cerror_inject_take_limit(CErrorInjectRuleSlot* pSlot)
+{
+    uint32_t uInjected = CERROR_ATOMIC_LOAD_U32(&pSlot->uInjected);
+
+    while (uInjected < pSlot->stRule.uLimit)
+    {
+        if (CERROR_ATOMIC_CAS_U32(&pSlot->uInjected, uInjected, uInjected + 1u))
+        {
+            return 1;
+        }
+        uInjected = CERROR_ATOMIC_LOAD_U32(&pSlot->uInjected);
+    }
+    return 0;
+}
+
+/**
+ * @brief Decide whether a rule fails call number ullCall of a point
+ */
+static int cerror_inject_rule_fires(CErrorInjectRuleSlot* pSlot, uint64_t ullError, uint64_t ullCall)
+{
+    const CErrorInjectRule* const pRule = &pSlot->stRule;
+
+    if ((ullError & pRule->ullMask) != pRule->ullMatch || ullCall <= pRule->uSkip)
+    {
+        return 0;
+    }
+
+    if (0u != pRule->uEveryNth)
+    {
+        if (0u != (ullCall - pRule->uSkip) % pRule->uEveryNth)
+        {
+            return 0;
+        }
+    }
+    else if (cerror_inject_random() >= pRule->dProbability)
+    {
+        return 0;
+    }
+
+    /* The limit is checked last so that only real injections consume it */
+    return 0u == pRule->uLimit || cerror_inject_take_limit(pSlot);
+}
+
+/* ============================================================================
+ * Injection Point
+ * ============================================================================ */
+
+int cerror_inject_check(uint64_t ullError, const char* pszFile, int nLine)
+{
+    CErrorInjectPoint* const pPoint = cerror_inject_point(ullError, pszFile, nLine);
+    const uint32_t           uRules = CERROR_ATOMIC_LOAD_U32(&g_uInjectRuleCount);
+    uint64_t                 ullCall;
+    uint32_t                 i;
+
+    if (NULL == pPoint)
+    {
+        return 0;
+    }
+
+    ullError &= VALID_ERROR_MASK;
+    ullCall = CERROR_ATOMIC_ADD_U64(&pPoint->ullCalls, 1u) + 1u;
+    for (i = 0; i < uRules; ++i)
+    {
+        if (cerror_inject_rule_fires(&g_aInjectRules[i], ullError, ullCall))
+        {
+            CERROR_ATOMIC_ADD_U64(&pPoint->ullInjected, 1u);
+            cerror_set_last_info(ullError, "injected fault");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Rules
+ * ============================================================================ */
+
+void cerror_inject_select(CErrorInjectRule* pRule, int nSoftwareId, int nComponentId, int nStatus)
+{
+    pRule->ullMask = 0;
+    pRule->ullMatch = 0;
+    if (nSoftwareId >= 0)
+    {
+        pRule->ullMask |= SOFTWARE_ID_MASK;
+        pRule->ullMatch |= ((uint64_t)nSoftwareId & MAX_SOFTWARE_ID) << SOFTWARE_ID_BIT_POS;
+    }
+    if (nComponentId >= 0)
+    {
+        pRule->ullMask |= COMPONENT_MASK;
+        pRule->ullMatch |= ((uint64_t)nComponentId & MAX_COMPONENT) << COMPONENT_BIT_POS;
+    }
+    if (nStatus >= 0)
+    {
+        pRule->ullMask |= STATUS_MASK;
+        pRule->ullMatch |= ((uint64_t)nStatus & MAX_STATUS) << STATUS_BIT_POS;
+    }
+}
+
+int cerror_inject_add_rule(const CErrorInjectRule* pRule)
+{
+    const uint32_t uCount = g_uInjectRuleCount;
+
+    if (NULL == pRule || uCount >= CERROR_INJECT_MAX_RULES ||
+        !(pRule->dProbability >= 0.0 && pRule->dProbability <= 1.0) || (pRule->ullMatch & ~pRule->ullMask) != 0)
+    {
+        return 0;
+    }
+
+    g_aInjectRules[uCount].stRule = *pRule;
+    g_aInjectRules[uCount].uInjected = 0;
+    CERROR_ATOMIC_STORE_U32(&g_uInjectRuleCount, uCount + 1u);
+    return 1;
+}
+
+void cerror_inject_clear_rules(void)
+{
+    CERROR_ATOMIC_STORE_U32(&g_uInjectRuleCount, 0u);
+}
+
+/**
+ * @brief Parse an unsigned number (decimal or 0x hex) up to ulMax
+ */
+static int cerror_inject_parse_uint(const char* pszValue, unsigned long ulMax, unsigned long* pulValue)
+{
+    char*               pszEnd;
+    const unsigned long ulValue = strtoul(pszValue, &pszEnd, 0);
+
+    if (pszEnd == pszValue || ulValue > ulMax || ('\0' != *pszEnd && !isspace((unsigned char)*pszEnd)))
+    {
+        return 0;
+    }
+    *pulValue = ulValue;
+    return 1;
+}
+
+/**
+ * @brief Compare a config key (not null-terminated) with a name
+ */
+static int cerror_inject_key_is(const char* pszKey, size_t nKeyLength, const char* pszName)
+{
+    return strlen(pszName) == nKeyLength && 0 == memcmp(pszKey, pszName, nKeyLength);
+}
+
+int cerror_inject_parse_rule(const char* pszLine, CErrorInjectRule* pRule)
+{
+    int           nSoftwareId = -1;
+    int           nComponentId = -1;
+    int           nStatus = -1;
+    const char*   p = pszLine;
+    unsigned long ulValue;
+
+    memset(pRule, 0, sizeof(*pRule));
+    while ('\0' != *p)
+    {
+        const char* pszKey;
+        const char* pszValue;
+        size_t      nKeyLength;
+
+        while (isspace((unsigned char)*p))
+        {
+            p++;
+        }
+        if ('\0' == *p)
+        {
+            break;
+        }
+
+        pszKey = p;
+        while ('\0' != *p && '=' != *p && !isspace((unsigned char)*p))
+        {
+            p++;
+        }
+        if ('=' != *p)
+        {
+            return 0;
+        }
+        nKeyLength = (size_t)(p - pszKey);
+        pszValue = ++p;
+
+        if (cerror_inject_key_is(pszKey, nKeyLength, "probability"))
+        {
+            char* pszEnd;
+            pRule->dProbability = strtod(pszValue, &pszEnd);
+            if (pszEnd == pszValue || ('\0' != *pszEnd && !isspace((unsigned char)*pszEnd)) ||
+                !(pRule->dProbability >= 0.0 && pRule->dProbability <= 1.0))
+            {
+                return 0;
+            }
+        }
+        else if (!cerror_inject_parse_uint(pszValue, 0xFFFFFFFFul, &ulValue))
+        {
+            return 0;
+        }
+        else if (cerror_inject_key_is(pszKey, nKeyLength, "software") && ulValue <= MAX_SOFTWARE_ID)
+        {
+            nSoftwareId = (int)ulValue;
+        }
+        else if (cerror_inject_key_is(pszKey, nKeyLength, "component") && ulValue <= MAX_COMPONENT)
+        {
+            nComponentId = (int)ulValue;
+        }
+        else if (cerror_inject_key_is(pszKey, nKeyLength, "status") && ulValue <= MAX_STATUS)
+        {
+            nStatus = (int)ulValue;
+        }
+        else if (cerror_inject_key_is(pszKey, nKeyLength, "every"))
+        {
+            pRule->uEveryNth = (uint32_t)ulValue;
+        }
+        else if (cerror_inject_key_is(pszKey, nKeyLength, "skip"))
+        {
+            pRule->uSkip = (uint32_t)ulValue;
+        }
+        else if (cerror_inject_key_is(pszKey, nKeyLength, "limit"))
+        {
+            pRule->uLimit = (uint32_t)ulValue;
+        }
+        else
+        {
+            return 0;
+        }
+
+        while ('\0' != *p && !isspace((unsigned char)*p))
+        {
+            p++;
+        }
+    }
+
+    cerror_inject_select(pRule, nSoftwareId, nComponentId, nStatus);
+    return 1;
+}
+
+int cerror_inject_load_config(const char* pszPath)
+{
+    FILE* pFile = fopen(pszPath, "r");
+    char  szLine[256];
+    int   nAdded = 0;
+
+    if (NULL == pFile)
+    {
+        return -1;
+    }
+
+    while (NULL != fgets(szLine, sizeof(szLine), pFile))
+    {
+        CErrorInjectRule stRule;
+        char* const      pszComment = strchr(szLine, '#');
+        const char*      p = szLine;
+
+        if (NULL != pszComment)
+        {
+            *pszComment = '\0';
+        }
+        while (isspace((unsigned char)*p))
+        {
+            p++;
+        }
+        if ('\0' == *p)
+        {
+            continue;
+        }
+
+        if (!cerror_inject_parse_rule(p, &stRule) || !cerror_inject_add_rule(&stRule))
+        {
+            fclose(pFile);
+            return -1;
+        }
+        nAdded++;
+    }
+
+    fclose(pFile);
+    return nAdded;
+}
+
+/* ============================================================================
+ * Control and Counters
+ * ============================================================================ */
+
+void cerror_inject_enable(int bEnable)
+{
+    CERROR_ATOMIC_STORE_U32(&g_CErrorInjectActive.uValue, bEnable ? 1u : 0u);
+}
+
+void cerror_inject_seed(uint64_t ullSeed)
+{
+    CERROR_ATOMIC_STORE_U64(&g_ullInjectSeed, ullSeed);
+    CERROR_ATOMIC_STORE_U64(&g_ullInjectThreadCount, 0u);
+
+    /* Publishes the seed: every thread rederives its stream on its next draw */
+    CERROR_ATOMIC_ADD_U32(&g_uInjectSeedGeneration, 1u);
+}
+
+uint32_t cerror_inject_get_points(CErrorInjectPointStats* aStats, uint32_t uMax)
+{
+    uint32_t uCount = 0;
+    uint32_t i;
+
+    for (i = 0; i < CERROR_INJECT_MAX_POINTS; ++i)
+    {
+        const CErrorInjectPoint* const pPoint = &g_aInjectPoints[i];
+
+        if (CERROR_INJECT_SLOT_READY != CERROR_ATOMIC_LOAD_U32(&pPoint->uState))
+        {
+            continue;
+        }
+        if (uCount < uMax)
+        {
+            aStats[uCount].pszFile = pPoint->pszFile;
+            aStats[uCount].nLine = pPoint->nLine;
+            aStats[uCount].ullError = pPoint->ullError;
+            aStats[uCount].ullCalls = CERROR_ATOMIC_LOAD_U64(&pPoint->ullCalls);
+            aStats[uCount].ullInjected = CERROR_ATOMIC_LOAD_U64(&pPoint->ullInjected);
+        }
+        uCount++;
+    }
+    return uCount;
+}
+
+void cerror_inject_reset_counters(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < CERROR_INJECT_MAX_POINTS; ++i)
+    {
+        CERROR_ATOMIC_STORE_U64(&g_aInjectPoints[i].ullCalls, 0u);
+        CERROR_ATOMIC_STORE_U64(&g_aInjectPoints[i].ullInjected, 0u);
+    }
+    for (i = 0; i < CERROR_INJECT_MAX_RULES; ++i)
+    {
+        CERROR_ATOMIC_STORE_U32(&g_aInjectRules[i].uInjected, 0u);
+    }
+}
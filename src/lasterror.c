@@ -8,6 +8,10 @@
  */
 
 #include "c-error/lasterror.h"
+#if defined(CERROR_ENABLE_LATENCY_HISTOGRAM)
+    #include "c-error/latency.h"
+#endif
+#include "cerror_internal.h"
 
 /* ============================================================================
  * Thread-local Storage Variable Definition
@@ -21,45 +25,743 @@
  * - pszLastErrorInfo = NULL
  * - pszLastErrorInfoBuffer = NULL
  * - nBufferCapacity = 0
+ * - nCopyLimit = 0
+ * - uModeFlags = 0, uErrorCount = 0, uCauseCount = 0 (aCauses unused)
+ * - uFrameDepth = 0, uFramesCaptured = 0, uFramesPinned = 0 (frame arrays unused)
+ * - ullTimestamp = 0, ullBytesCopied = 0
+ * - stAllocator = { NULL } (process-wide allocator)
+ * - pArena = NULL
+ * - pPayload = NULL, nPayloadSize = 0, nPayloadCapacity = 0
+ * - pSharedInfo = NULL
+ * - szInlineInfo = ""
+ * - nHeapBytes = 0, nPeakHeapBytes = 0, nPublishedHeapBytes = 0, ullGrowEvents = 0
+ *
+ * g_pBoundErrorCtx (CERROR_ENABLE_CONTEXT_BINDING only) starts as NULL: the
+ * thread's own context is current.
  */
 #if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
     /* C11 standard thread-local storage */
     _Thread_local ErrorContext g_LastErrorCtx = {0};
+    #if defined(CERROR_ENABLE_CONTEXT_BINDING)
+        _Thread_local ErrorContext* g_pBoundErrorCtx = NULL;
+    #endif
 #elif defined(_MSC_VER)
     /* Microsoft Visual C++ */
     __declspec(thread) ErrorContext g_LastErrorCtx = {0};
+    #if defined(CERROR_ENABLE_CONTEXT_BINDING)
+        __declspec(thread) ErrorContext* g_pBoundErrorCtx = NULL;
+    #endif
 #elif defined(__GNUC__) || defined(__clang__)
     /* GCC and Clang */
     __thread ErrorContext g_LastErrorCtx = {0};
+    #if defined(CERROR_ENABLE_CONTEXT_BINDING)
+        __thread ErrorContext* g_pBoundErrorCtx = NULL;
+    #endif
 #else
     #error "Thread-local storage not supported on this compiler"
 #endif
 
+/** Read by every set call: a full cache line of its own, away from written data */
+CErrorFlagLine g_CErrorSetHooks = { 0 };
+
 /* ============================================================================
  * Thread-local Buffer Cleanup
  * ============================================================================ */
 
+/**
+ * @brief Check whether the buffer is the in-context one (fixed-capacity mode)
+ */
+static int cerror_buffer_is_inline(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    return pCtx->pszLastErrorInfoBuffer == pCtx->szInlineInfo;
+}
+
+void cerror_release_info_buffer(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (NULL == pCtx->pszLastErrorInfoBuffer || cerror_buffer_is_inline())
+    {
+        return;
+    }
+
+    if (pCtx->pszLastErrorInfo == pCtx->pszLastErrorInfoBuffer)
+    {
+        pCtx->pszLastErrorInfo = NULL;
+    }
+    cerror_buffer_free(pCtx->pszLastErrorInfoBuffer, pCtx->nBufferCapacity);
+    pCtx->pszLastErrorInfoBuffer = NULL;
+    pCtx->nBufferCapacity = 0;
+    pCtx->nCopyLimit = 0;
+    pCtx->uModeFlags &= ~CERROR_MODE_OVERSIZED;
+}
+
+/**
+ * @brief Free the buffers of the current context and reset its error state
+ */
+static void cerror_context_cleanup(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    /* Drop shared info, free the dynamic buffer and payload spill if allocated */
+    if (0 != (pCtx->ullLastError & CERROR_FLAG_SHARED_INFO))
+    {
+        cerror_drop_shared_info();
+    }
+    cerror_release_info_buffer();
+    cerror_payload_release();
+    cerror_memory_fold();
+
+    /* Reset error state */
+    pCtx->ullLastError = 0ULL;
+    pCtx->pszLastErrorInfo = NULL;
+    pCtx->uErrorCount = 0;
+    pCtx->uModeFlags &= ~CERROR_MODE_SUPPRESSED;
+}
+
 /**
  * @brief Cleanup the dynamic buffer in thread-local error context
  *
  * Call this function before thread exit to free the dynamically allocated buffer.
  * This function is safe to call multiple times or when the buffer is not allocated.
+ * With the buffer pool enabled, the buffer is recycled for other threads.
+ * The thread's memory counters and latency histograms are folded into the
+ * process totals, and the memory exporter (if set) is called.
  *
  * @note This only frees the buffer (pszLastErrorInfoBuffer), not the context itself.
  *       The context (g_LastErrorCtx) is managed by the compiler and will be
- *       automatically destroyed when the thread exits.
+ *       automatically destroyed when the thread exits. A bound request context
+ *       is left alone; it is cleaned with cerror_context_destroy().
  */
 void cerror_cleanup_thread_local_buffer(void)
 {
-    /* Free the dynamic buffer if allocated */
-    if (NULL != g_LastErrorCtx.pszLastErrorInfoBuffer)
+#if defined(CERROR_ENABLE_CONTEXT_BINDING)
+    ErrorContext* const pPrevious = cerror_bind_context(NULL);
+
+    cerror_context_cleanup();
+    (void)cerror_bind_context(pPrevious);
+#else
+    cerror_context_cleanup();
+#endif
+    cerror_latency_release();
+    cerror_export_memory_stats();
+}
+
+/* ============================================================================
+ * Request-scoped Contexts
+ * ============================================================================ */
+
+#if defined(CERROR_ENABLE_CONTEXT_BINDING)
+void cerror_context_init(ErrorContext* pCtx)
+{
+    assert(0 == ((uintptr_t)pCtx & 63u));
+    memset(pCtx, 0, sizeof(*pCtx));
+}
+
+void cerror_context_destroy(ErrorContext* pCtx)
+{
+    /* Every helper works on the current context: bind it for the duration */
+    ErrorContext* const pPrevious = cerror_bind_context(pCtx);
+
+    cerror_context_cleanup();
+    (void)cerror_bind_context(pPrevious);
+}
+#endif
+
+/* ============================================================================
+ * Capacity Policy
+ * ============================================================================ */
+
+/** Process-wide growth policy (read by the slow path only) */
+static CErrorCapacityPolicy g_CErrorCapacityPolicy = {
+    ERROR_INFO_INITIAL_CAPACITY,
+    CERROR_CAPACITY_UNLIMITED,
+    CERROR_CAPACITY_UNLIMITED
+};
+
+int cerror_set_capacity_policy(const CErrorCapacityPolicy* pPolicy)
+{
+    if (NULL == pPolicy)
     {
-        free(g_LastErrorCtx.pszLastErrorInfoBuffer);
-        g_LastErrorCtx.pszLastErrorInfoBuffer = NULL;
-        g_LastErrorCtx.nBufferCapacity = 0;
+        g_CErrorCapacityPolicy.nInitialCapacity = ERROR_INFO_INITIAL_CAPACITY;
+        g_CErrorCapacityPolicy.nMaxCapacity = CERROR_CAPACITY_UNLIMITED;
+        g_CErrorCapacityPolicy.nShrinkThreshold = CERROR_CAPACITY_UNLIMITED;
+        return 1;
     }
 
-    /* Reset error state */
-    g_LastErrorCtx.ullLastError = 0ULL;
-    g_LastErrorCtx.pszLastErrorInfo = NULL;
-}
\ No newline at end of file
+    /* A threshold below the initial capacity would release every buffer it allocates */
+    if (0 == pPolicy->nInitialCapacity || pPolicy->nInitialCapacity > pPolicy->nMaxCapacity ||
+        pPolicy->nShrinkThreshold < pPolicy->nInitialCapacity)
+    {
+        return 0;
+    }
+
+    g_CErrorCapacityPolicy = *pPolicy;
+    return 1;
+}
+
+void cerror_get_capacity_policy(CErrorCapacityPolicy* pPolicy)
+{
+    if (NULL != pPolicy)
+    {
+        *pPolicy = g_CErrorCapacityPolicy;
+    }
+}
+
+/**
+ * @brief Round up to the next power of 2 (full size_t width)
+ *
+ * @return The rounded value, or 0 if it does not fit into size_t
+ */
+static size_t cerror_round_up_pow2(size_t n)
+{
+    n--;
+    n |= n >> 1;
+    n |= n >> 2;
+    n |= n >> 4;
+    n |= n >> 8;
+    n |= n >> 16;
+#if SIZE_MAX > 0xFFFFFFFFu
+    n |= n >> 32;
+#endif
+    n++;
+    return n;
+}
+
+/**
+ * @brief Buffer capacity for a required size under the current policy
+ */
+static size_t cerror_capacity_for(size_t nRequiredCapacity)
+{
+    const CErrorCapacityPolicy* pPolicy = &g_CErrorCapacityPolicy;
+    size_t n = cerror_round_up_pow2(nRequiredCapacity);
+
+    if (0 == n || n > pPolicy->nMaxCapacity)
+    {
+        /* Rounding overflowed or exceeds the cap: never go above max */
+        n = pPolicy->nMaxCapacity;
+    }
+    return (n > pPolicy->nInitialCapacity) ? n : pPolicy->nInitialCapacity;
+}
+
+/**
+ * @brief Recompute the capacity usable by the inline copy path
+ *
+ * A buffer above the shrink threshold gets limit 0, which routes every copy
+ * through the slow path, and CERROR_MODE_OVERSIZED, which does the same for
+ * the next clear, until it is released. A bound
+ * arena does the same so messages are bump-allocated from it.
+ */
+static int cerror_buffer_is_oversized(void)
+{
+    return cerror_ctx()->nBufferCapacity > g_CErrorCapacityPolicy.nShrinkThreshold && !cerror_buffer_is_inline();
+}
+
+static void cerror_update_copy_limit(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (NULL != pCtx->pArena)
+    {
+        /* Arena-backed mode: every copy takes the slow path */
+        pCtx->nCopyLimit = 0;
+    }
+    else
+    {
+        pCtx->nCopyLimit = cerror_buffer_is_oversized() ? 0 : pCtx->nBufferCapacity;
+    }
+
+    if (cerror_buffer_is_oversized())
+    {
+        pCtx->uModeFlags |= CERROR_MODE_OVERSIZED;
+    }
+    else
+    {
+        pCtx->uModeFlags &= ~CERROR_MODE_OVERSIZED;
+    }
+}
+
+void cerror_clear_last_slow(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    /* Observers see the error until the last one returns */
+    if (0 != (pCtx->uModeFlags & CERROR_MODE_NOTIFYING))
+    {
+        return;
+    }
+
+    if (0 != (pCtx->ullLastError & CERROR_FLAG_SHARED_INFO))
+    {
+        cerror_drop_shared_info();
+    }
+    pCtx->ullLastError = 0ULL;
+    pCtx->pszLastErrorInfo = NULL;
+    pCtx->uErrorCount = 0;
+    pCtx->uModeFlags &= ~CERROR_MODE_SUPPRESSED;
+
+    /* Release a buffer left oversized by a spike */
+    if (0 != (pCtx->uModeFlags & CERROR_MODE_OVERSIZED))
+    {
+        cerror_trim_thread_local_buffer();
+    }
+}
+
+int cerror_set_last_slow(const uint64_t ullError)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    /* An observer must not replace (and free the info of) the error it is notified of */
+    if (0 != (pCtx->uModeFlags & CERROR_MODE_NOTIFYING))
+    {
+        return 0;
+    }
+
+    if (0 != (pCtx->uModeFlags & CERROR_MODE_STICKY_FIRST))
+    {
+        if (0ULL != (ullError & VALID_ERROR_MASK))
+        {
+            pCtx->uErrorCount++;
+        }
+
+        /* Keep the first error; setters and payload writers leave it alone */
+        if (0ULL != (pCtx->ullLastError & VALID_ERROR_MASK))
+        {
+            pCtx->uModeFlags |= CERROR_MODE_SUPPRESSED;
+            return 0;
+        }
+        pCtx->uModeFlags &= ~CERROR_MODE_SUPPRESSED;
+    }
+
+    if (0 != (pCtx->ullLastError & CERROR_FLAG_SHARED_INFO))
+    {
+        cerror_drop_shared_info();
+    }
+    pCtx->ullLastError = (ullError & VALID_ERROR_MASK) | CERROR_FLAG_DIRTY | cerror_capture_frames(pCtx) |
+                         cerror_capture_timestamp(pCtx);
+    return 1;
+}
+
+void cerror_set_last_at_slow(const uint64_t ullError, const CErrorCallsite* pSite)
+{
+    if (cerror_set_last_slow(ullError))
+    {
+        CERROR_PROBE2(set, ullError, NULL);
+        cerror_observe(pSite);
+    }
+}
+
+void cerror_trim_thread_local_buffer(void)
+{
+    if (cerror_ctx()->nBufferCapacity > g_CErrorCapacityPolicy.nShrinkThreshold)
+    {
+        cerror_release_info_buffer();
+    }
+    cerror_update_copy_limit();
+}
+
+/* ============================================================================
+ * Fixed-capacity Mode
+ * ============================================================================ */
+
+/**
+ * @brief Make the in-context buffer the thread's info buffer
+ */
+static void cerror_use_inline_buffer(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    pCtx->pszLastErrorInfoBuffer = pCtx->szInlineInfo;
+    pCtx->nBufferCapacity = sizeof(pCtx->szInlineInfo);
+    cerror_update_copy_limit();
+}
+
+void cerror_set_fixed_info_mode(int bEnable)
+{
+#if defined(CERROR_NO_HEAP)
+    (void)bEnable;
+#else
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (bEnable)
+    {
+        if (!cerror_buffer_is_inline())
+        {
+            cerror_release_info_buffer();
+            cerror_use_inline_buffer();
+        }
+    }
+    else if (cerror_buffer_is_inline())
+    {
+        if (pCtx->pszLastErrorInfo == pCtx->szInlineInfo)
+        {
+            pCtx->pszLastErrorInfo = NULL;
+        }
+        pCtx->pszLastErrorInfoBuffer = NULL;
+        pCtx->nBufferCapacity = 0;
+        pCtx->nCopyLimit = 0;
+    }
+#endif
+#if defined(CERROR_ENABLE_LATENCY_HISTOGRAM)
+    /* Histograms are allocated now, not by the first timed set */
+    if (bEnable)
+    {
+        (void)cerror_latency_prepare_thread();
+    }
+#endif
+}
+
+int cerror_is_fixed_info_mode(void)
+{
+#if defined(CERROR_NO_HEAP)
+    return 1;
+#else
+    return cerror_buffer_is_inline();
+#endif
+}
+
+void cerror_set_sticky_first_mode(int bEnable)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    cerror_clear_last_slow();
+
+    if (bEnable)
+    {
+        pCtx->uModeFlags |= CERROR_MODE_STICKY_FIRST;
+    }
+    else
+    {
+        pCtx->uModeFlags &= ~CERROR_MODE_STICKY_FIRST;
+    }
+}
+
+int cerror_is_sticky_first_mode(void)
+{
+    return 0 != (cerror_ctx()->uModeFlags & CERROR_MODE_STICKY_FIRST);
+}
+
+/* ============================================================================
+ * Info Copy Slow Path
+ * ============================================================================ */
+
+/**
+ * @brief Copy the info string into pDst, truncating on a UTF-8 boundary if needed
+ *
+ * Sets the info pointer and, on truncation, CERROR_FLAG_INFO_TRUNCATED.
+ */
+static void cerror_copy_info_bounded(char* pDst, size_t nCapacity, const char* pszErrorInfo, size_t nLength)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (nLength >= nCapacity)
+    {
+        nLength = nCapacity - 1;
+        /* Do not split a multi-byte character: back off over continuation bytes */
+        while (nLength > 0 && 0x80 == ((unsigned char)pszErrorInfo[nLength] & 0xC0))
+        {
+            nLength--;
+        }
+        pCtx->ullLastError |= CERROR_FLAG_INFO_TRUNCATED;
+    }
+
+    memcpy(pDst, pszErrorInfo, nLength);
+    pDst[nLength] = '\0';
+    pCtx->pszLastErrorInfo = pDst;
+}
+
+/**
+ * @brief Copy the info string into the available storage, truncating if needed
+ *
+ * Uses the existing buffer if there is one, otherwise the in-context buffer
+ * (low-memory mode). Never allocates.
+ */
+static void cerror_store_info_bounded(const char* pszErrorInfo, size_t nLength)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (NULL != pCtx->pszLastErrorInfoBuffer && pCtx->nBufferCapacity > 0)
+    {
+        cerror_copy_info_bounded(pCtx->pszLastErrorInfoBuffer, pCtx->nBufferCapacity, pszErrorInfo, nLength);
+    }
+    else
+    {
+        cerror_copy_info_bounded(pCtx->szInlineInfo, sizeof(pCtx->szInlineInfo), pszErrorInfo, nLength);
+    }
+}
+
+/**
+ * @brief Bump-allocate the info string from the bound arena
+ *
+ * @return 1 if stored (possibly truncated), 0 if the arena is exhausted
+ */
+static int cerror_store_info_in_arena(CErrorArena* pArena, const char* pszErrorInfo, size_t nLength)
+{
+    const size_t nAvailable = pArena->nCapacity - pArena->nUsed;
+    char* const  pDst = pArena->pBase + pArena->nUsed;
+
+    if (nAvailable < 2)
+    {
+        return 0;
+    }
+
+    cerror_copy_info_bounded(pDst, nAvailable, pszErrorInfo, nLength);
+    pArena->nUsed += strlen(pDst) + 1;
+    return 1;
+}
+
+/**
+ * @brief Grow (or shrink after a spike) the dynamic buffer and copy the info string
+ *
+ * Messages beyond the policy's max capacity are truncated. On allocation
+ * failure the old buffer is kept and the message is truncated into it, so the
+ * info never refers to a previous, unrelated error.
+ */
+void cerror_set_last_info_copy_slow(const char* pszErrorInfo, size_t nLength)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    char* const         pOldBuffer = pCtx->pszLastErrorInfoBuffer;
+    const size_t        nCapacity = pCtx->nBufferCapacity;
+    size_t              nRequiredCapacity = nLength + 1;
+    size_t              nNewCapacity;
+
+    if (NULL != pCtx->pArena && cerror_store_info_in_arena(pCtx->pArena, pszErrorInfo, nLength))
+    {
+        return;
+    }
+
+#if defined(CERROR_NO_HEAP)
+    if (!cerror_buffer_is_inline())
+    {
+        cerror_use_inline_buffer();
+    }
+#endif
+    if (cerror_buffer_is_inline())
+    {
+        /* Fixed-capacity mode: never allocate */
+        cerror_store_info_bounded(pszErrorInfo, nLength);
+        return;
+    }
+
+    if (nRequiredCapacity < nLength || nRequiredCapacity > g_CErrorCapacityPolicy.nMaxCapacity)
+    {
+        /* Over the hard cap: fill the largest allowed buffer */
+        nRequiredCapacity = g_CErrorCapacityPolicy.nMaxCapacity;
+    }
+
+    nNewCapacity = cerror_capacity_for(nRequiredCapacity);
+
+    /*
+     * Shrink only into a smaller buffer that is itself within the threshold
+     * (otherwise every copy would reallocate), and only if the source does
+     * not live in the buffer being released
+     */
+    if (nRequiredCapacity > nCapacity ||
+        (nCapacity > g_CErrorCapacityPolicy.nShrinkThreshold && nNewCapacity < nCapacity &&
+         nNewCapacity <= g_CErrorCapacityPolicy.nShrinkThreshold &&
+         (pszErrorInfo < pOldBuffer || pszErrorInfo >= pOldBuffer + nCapacity)))
+    {
+        /* Contents are replaced anyway: allocate fresh instead of realloc (no copy) */
+        char* pNewBuffer = cerror_buffer_alloc(nNewCapacity);
+
+        if (NULL != pNewBuffer)
+        {
+            cerror_buffer_free(pOldBuffer, nCapacity);
+            pCtx->pszLastErrorInfoBuffer = pNewBuffer;
+            pCtx->nBufferCapacity = nNewCapacity;
+            if (nNewCapacity > nCapacity)
+            {
+                pCtx->ullGrowEvents++;
+                CERROR_PROBE3(info_grow, pCtx->ullLastError & VALID_ERROR_MASK, pszErrorInfo, nNewCapacity);
+            }
+        }
+        /* else: allocation failed (shrink failures are harmless), keep old buffer */
+    }
+    cerror_update_copy_limit();
+
+    /* Copy what fits; sets CERROR_FLAG_INFO_TRUNCATED if the message was cut */
+    cerror_store_info_bounded(pszErrorInfo, nLength);
+}
+
+/* ============================================================================
+ * Save / Restore
+ * ============================================================================ */
+
+/** Flags restored with a saved error (payload, causes and frames are not saved) */
+#define CERROR_SAVED_FLAGS_MASK (CERROR_FLAG_DIRTY | CERROR_FLAG_INFO_TRUNCATED | CERROR_FLAG_FROM_ERRNO | \
+                                 CERROR_FLAG_HAS_TIMESTAMP | CERROR_FLAG_SHARED_INFO)
+
+/**
+ * @brief Check whether pszInfo lives in storage the context reuses (dynamic or in-context buffer)
+ */
+static int cerror_info_is_owned(const char* pszInfo)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    const char* const pBuffer = pCtx->pszLastErrorInfoBuffer;
+
+    if (pszInfo >= pCtx->szInlineInfo && pszInfo < pCtx->szInlineInfo + sizeof(pCtx->szInlineInfo))
+    {
+        return 1;
+    }
+    return NULL != pBuffer && pszInfo >= pBuffer && pszInfo < pBuffer + pCtx->nBufferCapacity;
+}
+
+void cerror_save_slow(CErrorSavedState* pSaved)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    const char* const pszInfo = pCtx->pszLastErrorInfo;
+
+    pSaved->ullError = pCtx->ullLastError & (VALID_ERROR_MASK | CERROR_SAVED_FLAGS_MASK);
+    pSaved->pszInfo = pszInfo;
+    pSaved->pHeapInfo = NULL;
+    pSaved->nHeapSize = 0;
+    pSaved->pSharedInfo = NULL;
+    pSaved->ullTimestamp = pCtx->ullTimestamp;
+    pSaved->uErrorCount = pCtx->uErrorCount;
+    pSaved->uModeFlags = pCtx->uModeFlags & CERROR_MODE_SUPPRESSED;
+
+    /* Shared info of a cause (after cerror_wrap_last()) is not the error's own info */
+    if (CERROR_FLAG_SHARED_INFO == (pCtx->ullLastError & (CERROR_FLAG_SHARED_INFO | CERROR_FLAG_HAS_CAUSES)))
+    {
+        cerror_shared_info_retain(pCtx->pSharedInfo);
+        pSaved->pSharedInfo = pCtx->pSharedInfo;
+        return;
+    }
+    pSaved->ullError &= ~CERROR_FLAG_SHARED_INFO;
+
+    if (NULL == pszInfo || !cerror_info_is_owned(pszInfo))
+    {
+        return;
+    }
+
+    /* The next copied info would overwrite it: take a copy */
+    {
+        const size_t nLength = strlen(pszInfo);
+        char*        pDst = pSaved->szInfo;
+        size_t       nCapacity = sizeof(pSaved->szInfo);
+
+        if (nLength >= nCapacity && !cerror_is_fixed_info_mode())
+        {
+            char* const pHeap = (char*)cerror_process_alloc(nLength + 1);
+            if (NULL != pHeap)
+            {
+                pSaved->pHeapInfo = pHeap;
+                pSaved->nHeapSize = nLength + 1;
+                pDst = pHeap;
+                nCapacity = nLength + 1;
+            }
+        }
+
+        if (nLength < nCapacity)
+        {
+            memcpy(pDst, pszInfo, nLength + 1);
+        }
+        else
+        {
+            /* Fixed-capacity mode or out of memory: keep what fits, on a UTF-8 boundary */
+            size_t nKeep = nCapacity - 1;
+            while (nKeep > 0 && 0x80 == ((unsigned char)pszInfo[nKeep] & 0xC0))
+            {
+                nKeep--;
+            }
+            memcpy(pDst, pszInfo, nKeep);
+            pDst[nKeep] = '\0';
+            pSaved->ullError |= CERROR_FLAG_INFO_TRUNCATED;
+        }
+        pSaved->pszInfo = pDst;
+    }
+}
+
+void cerror_restore_slow(CErrorSavedState* pSaved)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (0 != (pCtx->uModeFlags & CERROR_MODE_NOTIFYING))
+    {
+        cerror_discard_saved(pSaved);
+        return;
+    }
+
+    if (0 != (pCtx->ullLastError & CERROR_FLAG_SHARED_INFO))
+    {
+        cerror_drop_shared_info();
+    }
+
+    /* The slot's reference moves to the context */
+    pCtx->ullLastError = pSaved->ullError;
+    pCtx->pSharedInfo = pSaved->pSharedInfo;
+    pCtx->ullTimestamp = pSaved->ullTimestamp;
+    pCtx->uErrorCount = pSaved->uErrorCount;
+    pCtx->uModeFlags = (pCtx->uModeFlags & ~CERROR_MODE_SUPPRESSED) | pSaved->uModeFlags;
+
+    if (NULL != pSaved->pszInfo && (pSaved->pszInfo == pSaved->szInfo || pSaved->pszInfo == pSaved->pHeapInfo))
+    {
+        /* The slot may not outlive the restore: copy back into the context */
+        pCtx->pszLastErrorInfo = NULL;
+        cerror_set_last_info_copy_slow(pSaved->pszInfo, strlen(pSaved->pszInfo));
+    }
+    else
+    {
+        pCtx->pszLastErrorInfo = pSaved->pszInfo;
+    }
+
+    pSaved->pSharedInfo = NULL;
+    cerror_discard_saved(pSaved);
+}
+
+void cerror_discard_saved(CErrorSavedState* pSaved)
+{
+    /* A slot saved from a clear context holds nothing else */
+    if (0ULL == pSaved->ullError)
+    {
+        return;
+    }
+    if (NULL != pSaved->pSharedInfo)
+    {
+        cerror_shared_info_release(pSaved->pSharedInfo);
+        pSaved->pSharedInfo = NULL;
+    }
+    if (NULL != pSaved->pHeapInfo)
+    {
+        cerror_process_free(pSaved->pHeapInfo, pSaved->nHeapSize);
+        pSaved->pHeapInfo = NULL;
+    }
+    pSaved->ullError = 0ULL;
+}
+
+/* ============================================================================
+ * Arena-backed Info Storage
+ * ============================================================================ */
+
+void cerror_arena_init(CErrorArena* pArena, void* pMemory, size_t nCapacity)
+{
+    pArena->pBase = (char*)pMemory;
+    pArena->nCapacity = (NULL != pMemory) ? nCapacity : 0;
+    pArena->nUsed = 0;
+}
+
+void cerror_arena_reset(CErrorArena* pArena)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    /* Do not leave the current info pointing into recycled arena memory */
+    const char* pszInfo = pCtx->pszLastErrorInfo;
+    if (NULL != pszInfo && pszInfo >= pArena->pBase && pszInfo < pArena->pBase + pArena->nCapacity)
+    {
+        pCtx->pszLastErrorInfo = NULL;
+    }
+    pArena->nUsed = 0;
+}
+
+void cerror_bind_arena(CErrorArena* pArena)
+{
+    cerror_ctx()->pArena = pArena;
+    cerror_update_copy_limit();
+}
+
+CErrorArena* cerror_get_bound_arena(void)
+{
+    return cerror_ctx()->pArena;
+}
@@ -0,0 +1,560 @@
+/** @file latency.c
+ *  @brief Latency Histograms of Error Handling per Component
+ *
+ *  Each recording thread owns a block of per-component histograms, linked
+ *  into a process-wide registry on its first record. The owner is the only
+ *  writer: counters are updated with relaxed loads and stores, which readers
+ *  may observe slightly behind. Snapshots and thread exit serialize on a spin
+ *  flag; recording never takes it after the first call.
+ *
+ *  Threads in fixed-capacity mode never allocate while recording: their
+ *  block and all its histograms are allocated by cerror_latency_prepare_thread()
+ *  when the mode is entered, and samples of a thread without a block are
+ *  dropped. Totals of exited threads live in static storage.
+ *
+ *  Resets bump an epoch instead of touching other threads' blocks: a thread
+ *  whose block belongs to an older epoch zeroes it on its next record, and
+ *  snapshots skip such blocks until then.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "c-error/latency.h"
+#include "cerror_internal.h"
+#include "cerror_atomic.h"
+
+/** Component IDs are 11 bits; snapshots track one slot per ID plus CERROR_LATENCY_OTHER */
+#define CERROR_LATENCY_TOTAL_SLOTS (MAX_COMPONENT + 2u)
+
+/**
+ * @brief Histograms of one thread (allocated from the process-wide allocator)
+ */
+typedef struct CErrorLatencyThread
+{
+    struct CErrorLatencyThread* pNext;          /**< Registry links (lock held) */
+    struct CErrorLatencyThread* pPrev;
+    uint32_t                    uEpoch;         /**< Reset epoch the counts belong to (atomic) */
+    uint32_t                    uCount;         /**< Histograms in use (atomic, published with release) */
+    CErrorLatencyHistogram*     apHistograms[CERROR_LATENCY_MAX_COMPONENTS];    /**< Prepared ones beyond uCount are spare */
+} CErrorLatencyThread;
+
+static CErrorLatencyThread*   g_pLatencyThreads = NULL;
+static CErrorLatencyHistogram g_aLatencyTotals[CERROR_LATENCY_MAX_TOTALS];  /**< Totals of exited threads (lock held) */
+static uint32_t               g_uLatencyTotalCount = 0;
+static uint32_t               g_uLatencyEpoch = 0;
+static uint32_t               g_uLatencyLock = 0;
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+    static _Thread_local CErrorLatencyThread* g_pLatencyThread = NULL;
+#elif defined(_MSC_VER)
+    static __declspec(thread) CErrorLatencyThread* g_pLatencyThread = NULL;
+#else
+    static __thread CErrorLatencyThread* g_pLatencyThread = NULL;
+#endif
+
+static void cerror_latency_lock(void)
+{
+    while (!CERROR_ATOMIC_CAS_U32(&g_uLatencyLock, 0u, 1u))
+    {
+    }
+}
+
+static void cerror_latency_unlock(void)
+{
+    CERROR_ATOMIC_STORE_U32(&g_uLatencyLock, 0u);
+}
+
+/**
+ * @brief Index of the highest set bit (ullValue != 0)
+ */
+static unsigned cerror_log2_u64(uint64_t ullValue)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - (unsigned)__builtin_clzll(ullValue);
+#else
+    unsigned uIndex = 0;
+    while (0 != (ullValue >>= 1))
+    {
+        uIndex++;
+    }
+    return uIndex;
+#endif
+}
+
+/**
+ * @brief Bucket of a duration (log-linear)
+ */
+static uint32_t cerror_latency_bucket(uint64_t ullTicks)
+{
+    unsigned uExponent;
+
+    if (ullTicks < CERROR_LATENCY_SUB_BUCKETS)
+    {
+        return (uint32_t)ullTicks;
+    }
+    uExponent = cerror_log2_u64(ullTicks);
+    if (uExponent >= CERROR_LATENCY_MAX_EXPONENT)
+    {
+        return CERROR_LATENCY_BUCKETS - 1u;
+    }
+    return (uExponent - CERROR_LATENCY_SUB_BUCKET_BITS + 1u) * CERROR_LATENCY_SUB_BUCKETS +
+           (uint32_t)((ullTicks >> (uExponent - CERROR_LATENCY_SUB_BUCKET_BITS)) & (CERROR_LATENCY_SUB_BUCKETS - 1u));
+}
+
+/**
+ * @brief Largest duration falling into a bucket
+ */
+static uint64_t cerror_latency_bucket_upper(uint32_t uBucket)
+{
+    const uint32_t uGroup = uBucket / CERROR_LATENCY_SUB_BUCKETS;
+    const uint64_t ullSub = uBucket % CERROR_LATENCY_SUB_BUCKETS;
+
+    if (0u == uGroup)
+    {
+        return ullSub;
+    }
+    /* Group g splits [2^(g+3), 2^(g+4)) into steps of 2^(g-1) */
+    return ((CERROR_LATENCY_SUB_BUCKETS + ullSub + 1u) << (uGroup - 1u)) - 1u;
+}
+
+/**
+ * @brief Nanoseconds per clock unit of cerror_latency_ticks() (the first call may calibrate the TSC)
+ */
+static double cerror_latency_ns_per_tick(void)
+{
+    uint32_t uClock = CERROR_ATOMIC_LOAD_U32(&g_CErrorLatencyClock.uValue);
+
+    if (CERROR_LATENCY_CLOCK_UNKNOWN == uClock)
+    {
+        uClock = cerror_latency_clock_init();
+    }
+    return (CERROR_LATENCY_CLOCK_TSC == uClock) ? cerror_clock_tsc_ns_per_tick() : 1.0;
+}
+
+/**
+ * @brief Zero the counters of a histogram
+ */
+static void cerror_latency_zero(CErrorLatencyHistogram* pHistogram)
+{
+    const uint32_t uComponentId = pHistogram->uComponentId;
+
+    memset(pHistogram, 0, sizeof(*pHistogram));
+    pHistogram->uComponentId = uComponentId;
+}
+
+/**
+ * @brief Add pFrom to pInto, reading pFrom with relaxed loads (it may belong to a recording thread)
+ */
+static void cerror_latency_accumulate(CErrorLatencyHistogram* pInto, CErrorLatencyHistogram* pFrom)
+{
+    const uint64_t ullMax = CERROR_ATOMIC_LOAD_U64(&pFrom->ullMaxTicks);
+    uint32_t       i;
+
+    pInto->ullCount += CERROR_ATOMIC_LOAD_U64(&pFrom->ullCount);
+    pInto->ullSumTicks += CERROR_ATOMIC_LOAD_U64(&pFrom->ullSumTicks);
+    if (ullMax > pInto->ullMaxTicks)
+    {
+        pInto->ullMaxTicks = ullMax;
+    }
+    for (i = 0; i < CERROR_LATENCY_BUCKETS; ++i)
+    {
+        pInto->aBuckets[i] += CERROR_ATOMIC_LOAD_U64(&pFrom->aBuckets[i]);
+    }
+}
+
+/* ============================================================================
+ * Recording
+ * ============================================================================ */
+
+/**
+ * @brief Allocate the calling thread's block and link it into the registry
+ */
+static CErrorLatencyThread* cerror_latency_attach(void)
+{
+    CErrorLatencyThread* const pThread = (CErrorLatencyThread*)cerror_process_alloc(sizeof(CErrorLatencyThread));
+
+    if (NULL == pThread)
+    {
+        return NULL;
+    }
+    memset(pThread, 0, sizeof(*pThread));
+
+    cerror_latency_lock();
+    pThread->uEpoch = g_uLatencyEpoch;
+    pThread->pNext = g_pLatencyThreads;
+    if (NULL != g_pLatencyThreads)
+    {
+        g_pLatencyThreads->pPrev = pThread;
+    }
+    g_pLatencyThreads = pThread;
+    cerror_latency_unlock();
+
+    g_pLatencyThread = pThread;
+    return pThread;
+}
+
+/**
+ * @brief Find or add the histogram of a component in the calling thread's block
+ *
+ * A prepared spare histogram is used first; only threads outside
+ * fixed-capacity mode allocate a new one.
+ */
+static CErrorLatencyHistogram* cerror_latency_histogram_of(CErrorLatencyThread* pThread, uint32_t uComponentId)
+{
+    const uint32_t          uCount = pThread->uCount;
+    CErrorLatencyHistogram* pHistogram;
+    uint32_t                i;
+
+    for (i = 0; i < uCount; ++i)
+    {
+        if (pThread->apHistograms[i]->uComponentId == uComponentId)
+        {
+            return pThread->apHistograms[i];
+        }
+    }
+
+    /* The last slot is reserved for the components beyond the limit */
+    if (uCount >= CERROR_LATENCY_MAX_COMPONENTS - 1u && CERROR_LATENCY_OTHER != uComponentId)
+    {
+        return cerror_latency_histogram_of(pThread, CERROR_LATENCY_OTHER);
+    }
+
+    pHistogram = pThread->apHistograms[uCount];
+    if (NULL == pHistogram)
+    {
+        if (cerror_is_fixed_info_mode())
+        {
+            return NULL;
+        }
+        pHistogram = (CErrorLatencyHistogram*)cerror_process_alloc(sizeof(CErrorLatencyHistogram));
+        if (NULL == pHistogram)
+        {
+            return NULL;
+        }
+        pThread->apHistograms[uCount] = pHistogram;
+    }
+    memset(pHistogram, 0, sizeof(*pHistogram));
+    pHistogram->uComponentId = uComponentId;
+    CERROR_ATOMIC_STORE_U32(&pThread->uCount, uCount + 1u);
+    return pHistogram;
+}
+
+void cerror_latency_record(uint64_t ullError, uint64_t ullStartTicks)
+{
+    const uint64_t          ullNow = cerror_latency_ticks();
+    const uint64_t          ullTicks = (ullNow > ullStartTicks) ? ullNow - ullStartTicks : 0u;
+    const uint32_t          uEpoch = CERROR_ATOMIC_LOAD_U32(&g_uLatencyEpoch);
+    CErrorLatencyThread*    pThread = g_pLatencyThread;
+    CErrorLatencyHistogram* pHistogram;
+    uint32_t                uBucket;
+
+    if (NULL == pThread)
+    {
+        /* Not prepared: a fixed-capacity thread drops the sample rather than allocate */
+        if (cerror_is_fixed_info_mode())
+        {
+            return;
+        }
+        pThread = cerror_latency_attach();
+        if (NULL == pThread)
+        {
+            return;
+        }
+    }
+
+    if (pThread->uEpoch != uEpoch)
+    {
+        /* Reset since the last record: drop the old counts, then rejoin snapshots */
+        uint32_t i;
+        for (i = 0; i < pThread->uCount; ++i)
+        {
+            cerror_latency_zero(pThread->apHistograms[i]);
+        }
+        CERROR_ATOMIC_STORE_U32(&pThread->uEpoch, uEpoch);
+    }
+
+    pHistogram = cerror_latency_histogram_of(pThread, GET_COMPONENT_ID(ullError));
+    if (NULL == pHistogram)
+    {
+        return;
+    }
+
+    /* Single writer: plain increments published with relaxed stores */
+    uBucket = cerror_latency_bucket(ullTicks);
+    CERROR_ATOMIC_STORE_U64(&pHistogram->aBuckets[uBucket], pHistogram->aBuckets[uBucket] + 1u);
+    CERROR_ATOMIC_STORE_U64(&pHistogram->ullCount, pHistogram->ullCount + 1u);
+    CERROR_ATOMIC_STORE_U64(&pHistogram->ullSumTicks, pHistogram->ullSumTicks + ullTicks);
+    if (ullTicks > pHistogram->ullMaxTicks)
+    {
+        CERROR_ATOMIC_STORE_U64(&pHistogram->ullMaxTicks, ullTicks);
+    }
+}
+
+int cerror_latency_prepare_thread(void)
+{
+    CErrorLatencyThread* pThread = g_pLatencyThread;
+    uint32_t             i;
+
+    if (NULL == pThread)
+    {
+        pThread = cerror_latency_attach();
+        if (NULL == pThread)
+        {
+            return 0;
+        }
+    }
+
+    for (i = pThread->uCount; i < CERROR_LATENCY_MAX_COMPONENTS; ++i)
+    {
+        if (NULL == pThread->apHistograms[i])
+        {
+            pThread->apHistograms[i] = (CErrorLatencyHistogram*)cerror_process_alloc(sizeof(CErrorLatencyHistogram));
+            if (NULL == pThread->apHistograms[i])
+            {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Total of a component in the static storage (lock held)
+ *
+ * The last slot is reserved for the components beyond CERROR_LATENCY_MAX_TOTALS.
+ */
+static CErrorLatencyHistogram* cerror_latency_total_of(uint32_t uComponentId)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_uLatencyTotalCount; ++i)
+    {
+        if (g_aLatencyTotals[i].uComponentId == uComponentId)
+        {
+            return &g_aLatencyTotals[i];
+        }
+    }
+    if (g_uLatencyTotalCount >= CERROR_LATENCY_MAX_TOTALS - 1u && CERROR_LATENCY_OTHER != uComponentId)
+    {
+        return cerror_latency_total_of(CERROR_LATENCY_OTHER);
+    }
+
+    memset(&g_aLatencyTotals[g_uLatencyTotalCount], 0, sizeof(g_aLatencyTotals[g_uLatencyTotalCount]));
+    g_aLatencyTotals[g_uLatencyTotalCount].uComponentId = uComponentId;
+    return &g_aLatencyTotals[g_uLatencyTotalCount++];
+}
+
+void cerror_latency_release(void)
+{
+    CErrorLatencyThread* const pThread = g_pLatencyThread;
+    uint32_t                   i;
+
+    if (NULL == pThread)
+    {
+        return;
+    }
+
+    cerror_latency_lock();
+    if (NULL != pThread->pPrev)
+    {
+        pThread->pPrev->pNext = pThread->pNext;
+    }
+    else
+    {
+        g_pLatencyThreads = pThread->pNext;
+    }
+    if (NULL != pThread->pNext)
+    {
+        pThread->pNext->pPrev = pThread->pPrev;
+    }
+
+    if (pThread->uEpoch == g_uLatencyEpoch)
+    {
+        for (i = 0; i < pThread->uCount; ++i)
+        {
+            cerror_latency_accumulate(cerror_latency_total_of(pThread->apHistograms[i]->uComponentId),
+                                      pThread->apHistograms[i]);
+        }
+    }
+    cerror_latency_unlock();
+
+    /* Used and spare histograms */
+    for (i = 0; i < CERROR_LATENCY_MAX_COMPONENTS && NULL != pThread->apHistograms[i]; ++i)
+    {
+        cerror_process_free(pThread->apHistograms[i], sizeof(CErrorLatencyHistogram));
+    }
+
+    cerror_process_free(pThread, sizeof(CErrorLatencyThread));
+    g_pLatencyThread = NULL;
+}
+
+/* ============================================================================
+ * Snapshot
+ * ============================================================================ */
+
+/**
+ * @brief Add a histogram to the snapshot entry of its component
+ *
+ * @return Updated number of components (entries beyond uMax are only counted)
+ */
+static uint32_t cerror_latency_collect(CErrorLatencyHistogram* aHistograms, uint32_t uMax, uint32_t uFound,
+                                       uint8_t* pSeen, CErrorLatencyHistogram* pHistogram)
+{
+    const uint32_t uComponentId = pHistogram->uComponentId;
+    const uint32_t uSlot = (CERROR_LATENCY_OTHER == uComponentId) ? MAX_COMPONENT + 1u : uComponentId;
+    uint32_t       i;
+
+    /* Totals zeroed by a reset */
+    if (0u == CERROR_ATOMIC_LOAD_U64(&pHistogram->ullCount))
+    {
+        return uFound;
+    }
+
+    if (0u == pSeen[uSlot])
+    {
+        pSeen[uSlot] = 1u;
+        if (uFound < uMax)
+        {
+            memset(&aHistograms[uFound], 0, sizeof(aHistograms[uFound]));
+            aHistograms[uFound].uComponentId = uComponentId;
+        }
+        uFound++;
+    }
+
+    for (i = 0; i < uFound && i < uMax; ++i)
+    {
+        if (aHistograms[i].uComponentId == uComponentId)
+        {
+            cerror_latency_accumulate(&aHistograms[i], pHistogram);
+            break;
+        }
+    }
+    return uFound;
+}
+
+uint32_t cerror_latency_snapshot(CErrorLatencyHistogram* aHistograms, uint32_t uMax)
+{
+    uint8_t              aSeen[CERROR_LATENCY_TOTAL_SLOTS];
+    CErrorLatencyThread* pThread;
+    uint32_t             uFound = 0;
+    uint32_t             uEpoch;
+    uint32_t             i;
+    uint32_t             j;
+    const double         dNsPerTick = cerror_latency_ns_per_tick();
+
+    memset(aSeen, 0, sizeof(aSeen));
+
+    cerror_latency_lock();
+    uEpoch = g_uLatencyEpoch;
+    for (i = 0; i < g_uLatencyTotalCount; ++i)
+    {
+        uFound = cerror_latency_collect(aHistograms, uMax, uFound, aSeen, &g_aLatencyTotals[i]);
+    }
+    for (pThread = g_pLatencyThreads; NULL != pThread; pThread = pThread->pNext)
+    {
+        const uint32_t uCount = CERROR_ATOMIC_LOAD_U32(&pThread->uCount);
+
+        /* Blocks of an older epoch hold counts from before the reset */
+        if (CERROR_ATOMIC_LOAD_U32(&pThread->uEpoch) != uEpoch)
+        {
+            continue;
+        }
+        for (i = 0; i < uCount; ++i)
+        {
+            uFound = cerror_latency_collect(aHistograms, uMax, uFound, aSeen, pThread->apHistograms[i]);
+        }
+    }
+    cerror_latency_unlock();
+
+    /* Sort the filled entries by component ID (insertion sort, few entries) */
+    for (i = 1; i < uFound && i < uMax; ++i)
+    {
+        for (j = i; j > 0 && aHistograms[j - 1].uComponentId > aHistograms[j].uComponentId; --j)
+        {
+            CErrorLatencyHistogram stTemp = aHistograms[j];
+            aHistograms[j] = aHistograms[j - 1];
+            aHistograms[j - 1] = stTemp;
+        }
+    }
+    for (i = 0; i < uFound && i < uMax; ++i)
+    {
+        aHistograms[i].dNsPerTick = dNsPerTick;
+    }
+    return uFound;
+}
+
+void cerror_latency_merge(CErrorLatencyHistogram* pInto, const CErrorLatencyHistogram* pFrom)
+{
+    uint32_t i;
+
+    pInto->ullCount += pFrom->ullCount;
+    pInto->ullSumTicks += pFrom->ullSumTicks;
+    if (pFrom->ullMaxTicks > pInto->ullMaxTicks)
+    {
+        pInto->ullMaxTicks = pFrom->ullMaxTicks;
+    }
+    if (0.0 == pInto->dNsPerTick)
+    {
+        pInto->dNsPerTick = pFrom->dNsPerTick;
+    }
+    for (i = 0; i < CERROR_LATENCY_BUCKETS; ++i)
+    {
+        pInto->aBuckets[i] += pFrom->aBuckets[i];
+    }
+}
+
+uint64_t cerror_latency_percentile_ns(const CErrorLatencyHistogram* pHistogram, double dPercentile)
+{
+    const double dNsPerTick = (0.0 != pHistogram->dNsPerTick) ? pHistogram->dNsPerTick : 1.0;
+    uint64_t     ullRank;
+    uint64_t     ullSeen = 0;
+    uint32_t     i;
+
+    if (0u == pHistogram->ullCount)
+    {
+        return 0u;
+    }
+    if (dPercentile < 0.0)
+    {
+        dPercentile = 0.0;
+    }
+    if (dPercentile > 100.0)
+    {
+        dPercentile = 100.0;
+    }
+
+    /* Rank of the percentile among the recorded calls (1-based) */
+    ullRank = (uint64_t)(dPercentile / 100.0 * (double)pHistogram->ullCount + 0.5);
+    if (0u == ullRank)
+    {
+        ullRank = 1u;
+    }
+
+    for (i = 0; i < CERROR_LATENCY_BUCKETS; ++i)
+    {
+        ullSeen += pHistogram->aBuckets[i];
+        if (ullSeen >= ullRank)
+        {
+            /* The last bucket is open-ended: report the maximum */
+            const uint64_t ullUpper = (CERROR_LATENCY_BUCKETS - 1u == i) ? pHistogram->ullMaxTicks
+                                                                         : cerror_latency_bucket_upper(i);
+            const uint64_t ullTicks = (ullUpper < pHistogram->ullMaxTicks) ? ullUpper : pHistogram->ullMaxTicks;
+            return (uint64_t)((double)ullTicks * dNsPerTick + 0.5);
+        }
+    }
+    return (uint64_t)((double)pHistogram->ullMaxTicks * dNsPerTick + 0.5);
+}
+
+void cerror_latency_reset(void)
+{
+    uint32_t i;
+
+    cerror_latency_lock();
+    for (i = 0; i < g_uLatencyTotalCount; ++i)
+    {
+        cerror_latency_zero(&g_aLatencyTotals[i]);
+    }
+    CERROR_ATOMIC_STORE_U32(&g_uLatencyEpoch, g_uLatencyEpoch + 1u);
+    cerror_latency_unlock();
+}
@@ -0,0 +1,205 @@
+/** @file observer.c
+ *  @brief Error Observer Registry
+ *
+ *  Observers live in an immutable snapshot published with a release store.
+ *  Notifying threads load it once and iterate without a lock. Writers
+ *  serialize on a spin flag, publish a copy with the change applied and
+ *  retire the old snapshot until cerror_reclaim_observers().
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "cerror_internal.h"
+#include "cerror_atomic.h"
+
+/**
+ * @brief Registered observer
+ */
+typedef struct CErrorObserverEntry
+{
+    CErrorObserverFn pfnObserver;
+    void*            pUserData;
+} CErrorObserverEntry;
+
+/**
+ * @brief Immutable observer snapshot (allocated from the process-wide allocator)
+ */
+typedef struct CErrorObserverTable
+{
+    struct CErrorObserverTable* pNextRetired;   /**< Retire list link */
+    uint32_t                    uCount;
+    CErrorObserverEntry         aEntries[1];    /**< uCount entries */
+} CErrorObserverTable;
+
+static CErrorObserverTable* g_pObserverTable = NULL;
+static CErrorObserverTable* g_pRetiredTables = NULL;
+static uint32_t             g_uObserverLock = 0;
+
+static size_t cerror_observer_table_size(uint32_t uCount)
+{
+    return offsetof(CErrorObserverTable, aEntries) + (size_t)(uCount ? uCount : 1u) * sizeof(CErrorObserverEntry);
+}
+
+static void cerror_observer_lock(void)
+{
+    while (!CERROR_ATOMIC_CAS_U32(&g_uObserverLock, 0u, 1u))
+    {
+    }
+}
+
+static void cerror_observer_unlock(void)
+{
+    CERROR_ATOMIC_STORE_U32(&g_uObserverLock, 0u);
+}
+
+/**
+ * @brief Publish a new snapshot (NULL: no observers) and retire the old one (lock held)
+ */
+static void cerror_observer_publish(CErrorObserverTable* pTable)
+{
+    CErrorObserverTable* const pOld = g_pObserverTable;
+
+    CERROR_ATOMIC_STORE_PTR(&g_pObserverTable, pTable);
+    if (NULL != pTable)
+    {
+        (void)CERROR_ATOMIC_OR_U32(&g_CErrorSetHooks.uValue, CERROR_HOOK_OBSERVERS);
+    }
+    else
+    {
+        (void)CERROR_ATOMIC_AND_U32(&g_CErrorSetHooks.uValue, ~CERROR_HOOK_OBSERVERS);
+    }
+    if (NULL != pOld)
+    {
+        pOld->pNextRetired = g_pRetiredTables;
+        g_pRetiredTables = pOld;
+    }
+}
+
+/* ============================================================================
+ * Notification
+ * ============================================================================ */
+
+void cerror_notify_observers(const CErrorCallsite* pSite)
+{
+    ErrorContext* const              pCtx = cerror_ctx();
+    const CErrorObserverTable* const pTable = CERROR_ATOMIC_LOAD_PTR(&g_pObserverTable);
+    uint64_t                         ullError;
+    const char*                      pszInfo;
+    uint32_t                         i;
+
+    /* Sets made by an observer are ignored (cerror_set_last_slow()), never reported again */
+    if (NULL == pTable || 0 != (pCtx->uModeFlags & CERROR_MODE_NOTIFYING))
+    {
+        return;
+    }
+
+    pCtx->uModeFlags |= CERROR_MODE_NOTIFYING;
+    ullError = cerror_get_last();
+    pszInfo = cerror_get_last_info();
+    for (i = 0; i < pTable->uCount; ++i)
+    {
+        pTable->aEntries[i].pfnObserver(ullError, pszInfo, pSite, pTable->aEntries[i].pUserData);
+    }
+    pCtx->uModeFlags &= ~CERROR_MODE_NOTIFYING;
+}
+
+/* ============================================================================
+ * Registration
+ * ============================================================================ */
+
+int cerror_add_observer(CErrorObserverFn pfnObserver, void* pUserData)
+{
+    CErrorObserverTable* pOld;
+    CErrorObserverTable* pNew;
+    uint32_t             uCount;
+
+    if (NULL == pfnObserver)
+    {
+        return 0;
+    }
+
+    cerror_observer_lock();
+    pOld = g_pObserverTable;
+    uCount = (NULL != pOld) ? pOld->uCount : 0u;
+    pNew = (CErrorObserverTable*)cerror_process_alloc(cerror_observer_table_size(uCount + 1u));
+    if (NULL == pNew)
+    {
+        cerror_observer_unlock();
+        return 0;
+    }
+
+    if (uCount > 0)
+    {
+        memcpy(pNew->aEntries, pOld->aEntries, uCount * sizeof(CErrorObserverEntry));
+    }
+    pNew->pNextRetired = NULL;
+    pNew->aEntries[uCount].pfnObserver = pfnObserver;
+    pNew->aEntries[uCount].pUserData = pUserData;
+    pNew->uCount = uCount + 1u;
+    cerror_observer_publish(pNew);
+    cerror_observer_unlock();
+    return 1;
+}
+
+int cerror_remove_observer(CErrorObserverFn pfnObserver, void* pUserData)
+{
+    CErrorObserverTable* pOld;
+    CErrorObserverTable* pNew = NULL;
+    uint32_t             uFound;
+    uint32_t             i;
+
+    cerror_observer_lock();
+    pOld = g_pObserverTable;
+    for (uFound = 0; NULL != pOld && uFound < pOld->uCount; ++uFound)
+    {
+        if (pOld->aEntries[uFound].pfnObserver == pfnObserver && pOld->aEntries[uFound].pUserData == pUserData)
+        {
+            break;
+        }
+    }
+    if (NULL == pOld || uFound == pOld->uCount)
+    {
+        cerror_observer_unlock();
+        return 0;
+    }
+
+    if (pOld->uCount > 1u)
+    {
+        pNew = (CErrorObserverTable*)cerror_process_alloc(cerror_observer_table_size(pOld->uCount - 1u));
+        if (NULL == pNew)
+        {
+            cerror_observer_unlock();
+            return 0;
+        }
+        pNew->pNextRetired = NULL;
+        pNew->uCount = 0;
+        for (i = 0; i < pOld->uCount; ++i)
+        {
+            if (i != uFound)
+            {
+                pNew->aEntries[pNew->uCount++] = pOld->aEntries[i];
+            }
+        }
+    }
+    cerror_observer_publish(pNew);
+    cerror_observer_unlock();
+    return 1;
+}
+
+void cerror_reclaim_observers(void)
+{
+    CErrorObserverTable* pTable;
+
+    cerror_observer_lock();
+    pTable = g_pRetiredTables;
+    g_pRetiredTables = NULL;
+    cerror_observer_unlock();
+
+    while (NULL != pTable)
+    {
+        CErrorObserverTable* const pNext = pTable->pNextRetired;
+        cerror_process_free(pTable, cerror_observer_table_size(pTable->uCount));
+        pTable = pNext;
+    }
+}
@@ -0,0 +1,389 @@
+/** @file payload.c
+ *  @brief Structured Key/Value Payload Implementation
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "c-error/payload.h"
+#include "cerror_internal.h"
+
+#include <stdio.h>
+
+/* ============================================================================
+ * Storage
+ * ============================================================================ */
+
+/**
+ * @brief Reserve nBytes at the end of the payload, spilling to the heap if needed
+ *
+ * @return Pointer to the reserved bytes, or NULL if storage is exhausted
+ */
+static unsigned char* cerror_payload_reserve(size_t nBytes)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    /* Sticky first-error mode dropped the error these fields belong to; observers only read */
+    if (0 != (pCtx->uModeFlags & (CERROR_MODE_SUPPRESSED | CERROR_MODE_NOTIFYING)))
+    {
+        return NULL;
+    }
+
+    /* No error to attach to: the flag alone would leave a clear context non-zero */
+    if (0 == (pCtx->ullLastError & CERROR_FLAG_DIRTY))
+    {
+        return NULL;
+    }
+
+    if (NULL == pCtx->pPayload)
+    {
+        pCtx->pPayload = pCtx->aPayloadInline;
+        pCtx->nPayloadCapacity = sizeof(pCtx->aPayloadInline);
+    }
+
+    /* First field of a new error: payload of the previous error is discarded */
+    if (0 == (pCtx->ullLastError & CERROR_FLAG_HAS_PAYLOAD))
+    {
+        pCtx->nPayloadSize = 0;
+    }
+
+    if (nBytes > pCtx->nPayloadCapacity - pCtx->nPayloadSize)
+    {
+        size_t         nNewCapacity = pCtx->nPayloadCapacity * 2;
+        unsigned char* pNew;
+
+        if (cerror_is_fixed_info_mode())
+        {
+            return NULL;
+        }
+        while (nNewCapacity - pCtx->nPayloadSize < nBytes)
+        {
+            nNewCapacity *= 2;
+        }
+
+        pNew = (unsigned char*)cerror_buffer_alloc(nNewCapacity);
+        if (NULL == pNew)
+        {
+            return NULL;
+        }
+        memcpy(pNew, pCtx->pPayload, pCtx->nPayloadSize);
+        cerror_payload_release();
+        pCtx->pPayload = pNew;
+        pCtx->nPayloadCapacity = nNewCapacity;
+        pCtx->ullGrowEvents++;
+    }
+
+    pCtx->ullLastError |= CERROR_FLAG_HAS_PAYLOAD;
+    pCtx->nPayloadSize += nBytes;
+    return pCtx->pPayload + pCtx->nPayloadSize - nBytes;
+}
+
+void cerror_payload_release(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (NULL != pCtx->pPayload && pCtx->pPayload != pCtx->aPayloadInline)
+    {
+        cerror_buffer_free((char*)pCtx->pPayload, pCtx->nPayloadCapacity);
+    }
+    pCtx->pPayload = NULL;
+    pCtx->nPayloadCapacity = 0;
+}
+
+/**
+ * @brief Append one record
+ */
+static int cerror_payload_add(CErrorPayloadType eType, const char* pszKey, const void* pValue, size_t nValueLength)
+{
+    const size_t   nKeyLength = (NULL != pszKey) ? strlen(pszKey) : 0;
+    unsigned char* pRecord;
+
+    if (nKeyLength > CERROR_PAYLOAD_MAX_KEY || nValueLength > CERROR_PAYLOAD_MAX_VALUE)
+    {
+        return 0;
+    }
+
+    pRecord = cerror_payload_reserve(CERROR_PAYLOAD_HEADER_SIZE + nKeyLength + nValueLength);
+    if (NULL == pRecord)
+    {
+        return 0;
+    }
+
+    pRecord[0] = (unsigned char)eType;
+    pRecord[1] = (unsigned char)nKeyLength;
+    pRecord[2] = (unsigned char)(nValueLength & 0xFFu);
+    pRecord[3] = (unsigned char)(nValueLength >> 8);
+    /* A NULL key or empty blob may come with a NULL pointer, which memcpy does not accept */
+    if (0 != nKeyLength)
+    {
+        memcpy(pRecord + CERROR_PAYLOAD_HEADER_SIZE, pszKey, nKeyLength);
+    }
+    if (0 != nValueLength)
+    {
+        memcpy(pRecord + CERROR_PAYLOAD_HEADER_SIZE + nKeyLength, pValue, nValueLength);
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * Typed Setters
+ * ============================================================================ */
+
+int cerror_payload_add_int(const char* pszKey, int64_t llValue)
+{
+    return cerror_payload_add(CERROR_PAYLOAD_INT, pszKey, &llValue, sizeof(llValue));
+}
+
+int cerror_payload_add_double(const char* pszKey, double dValue)
+{
+    return cerror_payload_add(CERROR_PAYLOAD_DOUBLE, pszKey, &dValue, sizeof(dValue));
+}
+
+int cerror_payload_add_string(const char* pszKey, const char* pszValue)
+{
+    if (NULL == pszValue)
+    {
+        pszValue = "";
+    }
+    return cerror_payload_add(CERROR_PAYLOAD_STRING, pszKey, pszValue, strlen(pszValue));
+}
+
+int cerror_payload_add_bytes(const char* pszKey, const void* pData, size_t nLength)
+{
+    if (NULL == pData && 0 != nLength)
+    {
+        return 0;
+    }
+    return cerror_payload_add(CERROR_PAYLOAD_BYTES, pszKey, pData, nLength);
+}
+
+/* ============================================================================
+ * Iteration
+ * ============================================================================ */
+
+void cerror_payload_iter_init(CErrorPayloadIter* pIter)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (cerror_has_payload())
+    {
+        pIter->pCur = pCtx->pPayload;
+        pIter->pEnd = pCtx->pPayload + pCtx->nPayloadSize;
+    }
+    else
+    {
+        pIter->pCur = NULL;
+        pIter->pEnd = NULL;
+    }
+}
+
+int cerror_payload_next(CErrorPayloadIter* pIter, CErrorPayloadField* pField)
+{
+    const unsigned char* pRecord = pIter->pCur;
+    size_t               nKeyLength;
+    size_t               nValueLength;
+
+    if (NULL == pRecord || (size_t)(pIter->pEnd - pRecord) < CERROR_PAYLOAD_HEADER_SIZE)
+    {
+        return 0;
+    }
+
+    nKeyLength = pRecord[1];
+    nValueLength = (size_t)pRecord[2] | ((size_t)pRecord[3] << 8);
+
+    pField->eType = (CErrorPayloadType)pRecord[0];
+    pField->pKey = (const char*)(pRecord + CERROR_PAYLOAD_HEADER_SIZE);
+    pField->nKeyLength = nKeyLength;
+    pField->pValue = pRecord + CERROR_PAYLOAD_HEADER_SIZE + nKeyLength;
+    pField->nValueLength = nValueLength;
+
+    pIter->pCur = pRecord + CERROR_PAYLOAD_HEADER_SIZE + nKeyLength + nValueLength;
+    return 1;
+}
+
+int64_t cerror_payload_field_int(const CErrorPayloadField* pField)
+{
+    int64_t llValue = 0;
+    if (CERROR_PAYLOAD_INT == pField->eType && sizeof(llValue) == pField->nValueLength)
+    {
+        memcpy(&llValue, pField->pValue, sizeof(llValue));
+    }
+    return llValue;
+}
+
+double cerror_payload_field_double(const CErrorPayloadField* pField)
+{
+    double dValue = 0.0;
+    if (CERROR_PAYLOAD_DOUBLE == pField->eType && sizeof(dValue) == pField->nValueLength)
+    {
+        memcpy(&dValue, pField->pValue, sizeof(dValue));
+    }
+    return dValue;
+}
+
+/* ============================================================================
+ * Lazy Rendering
+ * ============================================================================ */
+
+/**
+ * @brief Bounded output writer with snprintf-style length accounting
+ */
+typedef struct CErrorWriter
+{
+    char*  pszBuffer;
+    size_t nSize;
+    size_t nLength;     /**< Length of the full output so far */
+} CErrorWriter;
+
+static void cerror_writer_put(CErrorWriter* pWriter, const char* pData, size_t nLength)
+{
+    if (pWriter->nLength < pWriter->nSize)
+    {
+        const size_t nRoom = pWriter->nSize - 1 - pWriter->nLength;
+        memcpy(pWriter->pszBuffer + pWriter->nLength, pData, (nLength < nRoom) ? nLength : nRoom);
+    }
+    pWriter->nLength += nLength;
+}
+
+static void cerror_writer_puts(CErrorWriter* pWriter, const char* pszText)
+{
+    cerror_writer_put(pWriter, pszText, strlen(pszText));
+}
+
+static void cerror_writer_finish(CErrorWriter* pWriter)
+{
+    if (pWriter->nSize > 0)
+    {
+        pWriter->pszBuffer[(pWriter->nLength < pWriter->nSize) ? pWriter->nLength : pWriter->nSize - 1] = '\0';
+    }
+}
+
+static void cerror_writer_hex(CErrorWriter* pWriter, const unsigned char* pData, size_t nLength)
+{
+    static const char s_szHex[] = "0123456789abcdef";
+    size_t i;
+
+    for (i = 0; i < nLength; ++i)
+    {
+        const char aDigits[2] = { s_szHex[pData[i] >> 4], s_szHex[pData[i] & 0x0F] };
+        cerror_writer_put(pWriter, aDigits, 2);
+    }
+}
+
+static void cerror_writer_json_string(CErrorWriter* pWriter, const char* pData, size_t nLength)
+{
+    size_t i;
+
+    cerror_writer_put(pWriter, "\"", 1);
+    for (i = 0; i < nLength; ++i)
+    {
+        const unsigned char c = (unsigned char)pData[i];
+        char aEscape[8];
+
+        if ('"' == c || '\\' == c)
+        {
+            aEscape[0] = '\\';
+            aEscape[1] = (char)c;
+            cerror_writer_put(pWriter, aEscape, 2);
+        }
+        else if (c < 0x20)
+        {
+            snprintf(aEscape, sizeof(aEscape), "\\u%04x", c);
+            cerror_writer_put(pWriter, aEscape, 6);
+        }
+        else
+        {
+            cerror_writer_put(pWriter, &pData[i], 1);
+        }
+    }
+    cerror_writer_put(pWriter, "\"", 1);
+}
+
+/**
+ * @brief Write a numeric field value (shared by text and JSON)
+ */
+static void cerror_writer_number(CErrorWriter* pWriter, const CErrorPayloadField* pField, int bJson)
+{
+    char aNumber[32];
+
+    if (CERROR_PAYLOAD_INT == pField->eType)
+    {
+        snprintf(aNumber, sizeof(aNumber), "%lld", (long long)cerror_payload_field_int(pField));
+    }
+    else
+    {
+        const double dValue = cerror_payload_field_double(pField);
+        if (bJson && (dValue != dValue || dValue - dValue != 0.0))
+        {
+            cerror_writer_puts(pWriter, "null");   /* NaN / Inf */
+            return;
+        }
+        snprintf(aNumber, sizeof(aNumber), "%.17g", dValue);
+    }
+    cerror_writer_puts(pWriter, aNumber);
+}
+
+size_t cerror_payload_render_text(char* pszBuffer, size_t nSize)
+{
+    CErrorWriter       writer = { pszBuffer, nSize, 0 };
+    CErrorPayloadIter  iter;
+    CErrorPayloadField field;
+
+    cerror_payload_iter_init(&iter);
+    while (cerror_payload_next(&iter, &field))
+    {
+        if (writer.nLength > 0)
+        {
+            cerror_writer_put(&writer, " ", 1);
+        }
+        cerror_writer_put(&writer, field.pKey, field.nKeyLength);
+        cerror_writer_put(&writer, "=", 1);
+
+        switch (field.eType)
+        {
+            case CERROR_PAYLOAD_INT:
+            case CERROR_PAYLOAD_DOUBLE: cerror_writer_number(&writer, &field, 0); break;
+            case CERROR_PAYLOAD_STRING: cerror_writer_put(&writer, (const char*)field.pValue, field.nValueLength); break;
+            default:                    cerror_writer_hex(&writer, (const unsigned char*)field.pValue, field.nValueLength); break;
+        }
+    }
+    cerror_writer_finish(&writer);
+    return writer.nLength;
+}
+
+size_t cerror_payload_render_json(char* pszBuffer, size_t nSize)
+{
+    CErrorWriter       writer = { pszBuffer, nSize, 0 };
+    CErrorPayloadIter  iter;
+    CErrorPayloadField field;
+    int                bFirst = 1;
+
+    cerror_writer_put(&writer, "{", 1);
+    cerror_payload_iter_init(&iter);
+    while (cerror_payload_next(&iter, &field))
+    {
+        if (!bFirst)
+        {
+            cerror_writer_put(&writer, ",", 1);
+        }
+        bFirst = 0;
+
+        cerror_writer_json_string(&writer, field.pKey, field.nKeyLength);
+        cerror_writer_put(&writer, ":", 1);
+
+        switch (field.eType)
+        {
+            case CERROR_PAYLOAD_INT:
+            case CERROR_PAYLOAD_DOUBLE: cerror_writer_number(&writer, &field, 1); break;
+            case CERROR_PAYLOAD_STRING: cerror_writer_json_string(&writer, (const char*)field.pValue, field.nValueLength); break;
+            default:
+                cerror_writer_put(&writer, "\"", 1);
+                cerror_writer_hex(&writer, (const unsigned char*)field.pValue, field.nValueLength);
+                cerror_writer_put(&writer, "\"", 1);
+                break;
+        }
+    }
+    cerror_writer_put(&writer, "}", 1);
+    cerror_writer_finish(&writer);
+    return writer.nLength;
+}
@@ -0,0 +1,215 @@
+/** @file reduce.c
+ *  @brief Parallel Error Reduction Implementation
+ *
+ *  FIRST_BY_INDEX and MOST_SEVERE: the winner lives in the reducer's stBest,
+ *  so the result never depends on the entry count (errors arriving in
+ *  descending index order each win). ullBestRank mirrors the winner as one
+ *  comparable word; a contribution that ranks strictly worse is rejected
+ *  without the lock. Anything else takes uBestLock, compares against the
+ *  complete stBest with the exact policy and replaces it.
+ *
+ *  COLLECT_ALL entries are write-once: a contributor claims a fresh entry with
+ *  a fetch-add and fills it.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "c-error/reduce.h"
+#include "cerror_atomic.h"
+
+/**
+ * @brief Check whether (ullError, ullIndex) beats an entry under the policy
+ */
+static int cerror_reduce_beats(CErrorReducePolicy ePolicy, uint64_t ullError, uint64_t ullIndex,
+                               const CErrorReduceEntry* pOther)
+{
+    if (CERROR_REDUCE_MOST_SEVERE == ePolicy)
+    {
+        const uint32_t uSeverity = cerror_status_severity((CErrorStatusCode)GET_STATUS(ullError));
+        const uint32_t uOtherSeverity = cerror_status_severity((CErrorStatusCode)GET_STATUS(pOther->ullError));
+
+        if (uSeverity != uOtherSeverity)
+        {
+            return uSeverity > uOtherSeverity;
+        }
+    }
+    return ullIndex < pOther->ullIndex;
+}
+
+/** Index bits of a MOST_SEVERE rank (the severity goes above them) */
+#define CERROR_REDUCE_RANK_INDEX_BITS 58
+
+/**
+ * @brief Rank of a contribution: lower wins; equal ranks need the exact comparison
+ *
+ * MOST_SEVERE indices beyond the rank's index bits are clamped, so equal
+ * ranks may still differ by index.
+ */
+static uint64_t cerror_reduce_rank(CErrorReducePolicy ePolicy, uint64_t ullError, uint64_t ullIndex)
+{
+    const uint64_t ullIndexMask = (1ULL << CERROR_REDUCE_RANK_INDEX_BITS) - 1u;
+    uint32_t       uSeverity;
+
+    if (CERROR_REDUCE_MOST_SEVERE != ePolicy)
+    {
+        return ullIndex;
+    }
+    uSeverity = cerror_status_severity((CErrorStatusCode)GET_STATUS(ullError));
+    return ((uint64_t)(31u - uSeverity) << CERROR_REDUCE_RANK_INDEX_BITS) |
+           ((ullIndex < ullIndexMask) ? ullIndex : ullIndexMask);
+}
+
+/**
+ * @brief Copy an info string into an entry, truncating on a UTF-8 boundary
+ */
+static void cerror_reduce_copy_info(char* pDst, const char* pszInfo)
+{
+    size_t nLength = strlen(pszInfo);
+
+    if (nLength >= CERROR_REDUCE_INFO_CAPACITY)
+    {
+        nLength = CERROR_REDUCE_INFO_CAPACITY - 1;
+        while (nLength > 0 && 0x80 == ((unsigned char)pszInfo[nLength] & 0xC0))
+        {
+            nLength--;
+        }
+    }
+    memcpy(pDst, pszInfo, nLength);
+    pDst[nLength] = '\0';
+}
+
+void cerror_reducer_init(CErrorReducer* pReducer, CErrorReducePolicy ePolicy,
+                         CErrorReduceEntry* pEntries, uint32_t uCapacity)
+{
+    pReducer->ePolicy = ePolicy;
+    pReducer->pEntries = pEntries;
+    pReducer->uCapacity = (NULL != pEntries) ? uCapacity : 0;
+    pReducer->uClaimed = 0;
+    pReducer->uErrors = 0;
+    pReducer->uBestLock = 0;
+    pReducer->ullBestRank = CERROR_REDUCE_NO_RANK;
+    memset(&pReducer->stBest, 0, sizeof(pReducer->stBest));
+}
+
+/**
+ * @brief Replace the winner if (ullError, ullIndex) beats it
+ */
+static void cerror_reduce_select(CErrorReducer* pReducer, uint64_t ullError, uint64_t ullIndex)
+{
+    const uint64_t    ullRank = cerror_reduce_rank(pReducer->ePolicy, ullError, ullIndex);
+    CErrorReduceEntry stCandidate;
+
+    /* Strictly worse than the winner: no entry, no lock */
+    if (ullRank > CERROR_ATOMIC_LOAD_U64(&pReducer->ullBestRank))
+    {
+        return;
+    }
+
+    stCandidate.ullError = ullError;
+    stCandidate.ullIndex = ullIndex;
+    cerror_reduce_copy_info(stCandidate.szInfo, cerror_get_last_info());
+
+    while (!CERROR_ATOMIC_CAS_U32(&pReducer->uBestLock, 0u, 1u))
+    {
+    }
+    if (0ULL == pReducer->stBest.ullError ||
+        cerror_reduce_beats(pReducer->ePolicy, ullError, ullIndex, &pReducer->stBest))
+    {
+        pReducer->stBest = stCandidate;
+        CERROR_ATOMIC_STORE_U64(&pReducer->ullBestRank, ullRank);
+    }
+    CERROR_ATOMIC_STORE_U32(&pReducer->uBestLock, 0u);
+}
+
+int cerror_reducer_contribute(CErrorReducer* pReducer, uint64_t ullIndex)
+{
+    const uint64_t ullError = cerror_get_last();
+    uint32_t       uSlot;
+
+    if (0ULL == ullError)
+    {
+        return 0;
+    }
+    CERROR_ATOMIC_ADD_U32(&pReducer->uErrors, 1u);
+
+    if (CERROR_REDUCE_COLLECT_ALL != pReducer->ePolicy)
+    {
+        cerror_reduce_select(pReducer, ullError, ullIndex);
+        cerror_clear_last();
+        return 1;
+    }
+
+    uSlot = CERROR_ATOMIC_ADD_U32(&pReducer->uClaimed, 1u);
+    if (uSlot < pReducer->uCapacity)
+    {
+        CErrorReduceEntry* const pEntry = &pReducer->pEntries[uSlot];
+
+        pEntry->ullError = ullError;
+        pEntry->ullIndex = ullIndex;
+        cerror_reduce_copy_info(pEntry->szInfo, cerror_get_last_info());
+    }
+    /* else: out of entries, counted but dropped (cerror_reducer_dropped()) */
+
+    cerror_clear_last();
+    return 1;
+}
+
+/**
+ * @brief qsort comparator: ascending work item index
+ */
+static int cerror_reduce_compare_index(const void* pLeft, const void* pRight)
+{
+    const uint64_t ullLeft = ((const CErrorReduceEntry*)pLeft)->ullIndex;
+    const uint64_t ullRight = ((const CErrorReduceEntry*)pRight)->ullIndex;
+
+    return (ullLeft > ullRight) - (ullLeft < ullRight);
+}
+
+uint32_t cerror_reducer_finish(CErrorReducer* pReducer)
+{
+    const uint32_t uCount = cerror_reducer_entry_count(pReducer);
+
+    if (CERROR_REDUCE_COLLECT_ALL == pReducer->ePolicy && uCount > 0)
+    {
+        qsort(pReducer->pEntries, uCount, sizeof(CErrorReduceEntry), cerror_reduce_compare_index);
+    }
+
+    if (0 == uCount)
+    {
+        cerror_clear_last();
+    }
+    else
+    {
+        const CErrorReduceEntry* const pBest = cerror_reducer_entry(pReducer, 0);
+        cerror_set_last_info_copy(pBest->ullError, pBest->szInfo);
+    }
+    return pReducer->uErrors;
+}
+
+uint32_t cerror_reducer_dropped(const CErrorReducer* pReducer)
+{
+    if (CERROR_REDUCE_COLLECT_ALL != pReducer->ePolicy)
+    {
+        return 0;
+    }
+    return pReducer->uErrors - cerror_reducer_entry_count(pReducer);
+}
+
+uint32_t cerror_reducer_entry_count(const CErrorReducer* pReducer)
+{
+    if (CERROR_REDUCE_COLLECT_ALL != pReducer->ePolicy)
+    {
+        return (0ULL != pReducer->stBest.ullError) ? 1u : 0u;
+    }
+    return (pReducer->uClaimed < pReducer->uCapacity) ? pReducer->uClaimed : pReducer->uCapacity;
+}
+
+const CErrorReduceEntry* cerror_reducer_entry(const CErrorReducer* pReducer, uint32_t uEntry)
+{
+    if (uEntry >= cerror_reducer_entry_count(pReducer))
+    {
+        return NULL;
+    }
+    return (CERROR_REDUCE_COLLECT_ALL != pReducer->ePolicy) ? &pReducer->stBest : &pReducer->pEntries[uEntry];
+}
@@ -0,0 +1,123 @@
+/** @file sharedinfo.c
+ *  @brief Reference-counted External Info Strings
+ *
+ *  A holder pairs an external info string with a release callback and an
+ *  atomic reference count. The error context, other threads, loggers etc.
+ *  can all hold references; the string is released when the last one goes.
+ *
+ *  @author c-error contributors
+ *  @date 2026-01-19
+ */
+
+#include "cerror_internal.h"
+#include "cerror_atomic.h"
+
+/**
+ * @brief Shared info holder (allocated from the process-wide allocator)
+ */
+struct CErrorSharedInfo
+{
+    uint32_t        uRefCount;      /**< Atomic reference count */
+    const char*     pszInfo;        /**< External info string */
+    CErrorReleaseFn pfnRelease;     /**< Called by the last reference (NULL allowed) */
+    void*           pUserData;      /**< Passed to pfnRelease */
+};
+
+CErrorSharedInfo* cerror_shared_info_create(const char* pszInfo, CErrorReleaseFn pfnRelease, void* pUserData)
+{
+    CErrorSharedInfo* pShared = (CErrorSharedInfo*)cerror_process_alloc(sizeof(CErrorSharedInfo));
+
+    if (NULL != pShared)
+    {
+        pShared->uRefCount = 1;
+        pShared->pszInfo = (NULL != pszInfo) ? pszInfo : "";
+        pShared->pfnRelease = pfnRelease;
+        pShared->pUserData = pUserData;
+    }
+    return pShared;
+}
+
+void cerror_shared_info_retain(CErrorSharedInfo* pShared)
+{
+    if (NULL != pShared)
+    {
+        CERROR_ATOMIC_ADD_U32(&pShared->uRefCount, 1u);
+    }
+}
+
+void cerror_shared_info_release(CErrorSharedInfo* pShared)
+{
+    if (NULL == pShared)
+    {
+        return;
+    }
+
+    /* fetch_sub returns the previous value: 1 means this was the last reference */
+    if (1u == CERROR_ATOMIC_SUB_U32(&pShared->uRefCount, 1u))
+    {
+        if (NULL != pShared->pfnRelease)
+        {
+            pShared->pfnRelease(pShared->pszInfo, pShared->pUserData);
+        }
+        cerror_process_free(pShared, sizeof(CErrorSharedInfo));
+    }
+}
+
+const char* cerror_shared_info_get(const CErrorSharedInfo* pShared)
+{
+    return (NULL != pShared) ? pShared->pszInfo : "";
+}
+
+/* ============================================================================
+ * Error Context Integration
+ * ============================================================================ */
+
+void cerror_drop_shared_info(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+    CErrorSharedInfo* const pShared = pCtx->pSharedInfo;
+
+    if (pCtx->pszLastErrorInfo == pShared->pszInfo)
+    {
+        pCtx->pszLastErrorInfo = NULL;
+    }
+    pCtx->pSharedInfo = NULL;
+    pCtx->ullLastError &= ~CERROR_FLAG_SHARED_INFO;
+    cerror_shared_info_release(pShared);
+}
+
+void cerror_set_last_info_shared(const uint64_t ullError, CErrorSharedInfo* pShared)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    if (!cerror_try_set_last(ullError))
+    {
+        return;
+    }
+
+    if (NULL == pShared)
+    {
+        pCtx->pszLastErrorInfo = NULL;
+    }
+    else
+    {
+        cerror_shared_info_retain(pShared);
+        pCtx->pSharedInfo = pShared;
+        pCtx->pszLastErrorInfo = pShared->pszInfo;
+        pCtx->ullLastError |= CERROR_FLAG_SHARED_INFO;
+    }
+    cerror_observe(NULL);
+}
+
+CErrorSharedInfo* cerror_get_last_info_shared(void)
+{
+    ErrorContext* const pCtx = cerror_ctx();
+
+    /* After cerror_wrap_last() the reference belongs to a cause, not to the last error */
+    if (CERROR_FLAG_SHARED_INFO != (pCtx->ullLastError & (CERROR_FLAG_SHARED_INFO | CERROR_FLAG_HAS_CAUSES)))
+    {
+        return NULL;
+    }
+    cerror_shared_info_retain(pCtx->pSharedInfo);
+    return pCtx->pSharedInfo;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_allocator.c
+ * @brief Allocator hooks: validation, sizes and user data, thread allocators, switching
+ *
+ * Two counting allocators track their own live bytes; every block must be
+ * freed by the allocator that provided it, with the size it was allocated
+ * with.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <string.h>
+
+typedef struct CountingAllocator
+{
+    unsigned  uAllocs;
+    unsigned  uFrees;
+    long long llLiveBytes;
+} CountingAllocator;
+
+static void* countingRealloc(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData)
+{
+    CountingAllocator* const pAllocator = (CountingAllocator*)pUserData;
+    void* const              pNew = realloc(pBlock, nNewSize);
+
+    if (NULL != pNew)
+    {
+        pAllocator->uAllocs++;
+        pAllocator->llLiveBytes += (long long)nNewSize - (long long)nOldSize;
+    }
+    return pNew;
+}
+
+static void countingFree(void* pBlock, size_t nSize, void* pUserData)
+{
+    CountingAllocator* const pAllocator = (CountingAllocator*)pUserData;
+
+    pAllocator->uFrees++;
+    pAllocator->llLiveBytes -= (long long)nSize;
+    free(pBlock);
+}
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x62, CERROR_INTERNAL, 0x0001);
+
+static char g_szLong[1024];
+
+static void testValidation(void)
+{
+    CountingAllocator stAllocator;
+
+    memset(&stAllocator, 0, sizeof(stAllocator));
+    TEST_CHECK(!cerror_set_allocator(countingRealloc, NULL, &stAllocator));
+    TEST_CHECK(!cerror_set_allocator(NULL, countingFree, &stAllocator));
+    TEST_CHECK(!cerror_set_thread_allocator(countingRealloc, NULL, &stAllocator));
+    TEST_CHECK(!cerror_set_thread_allocator(NULL, countingFree, &stAllocator));
+}
+
+/**
+ * @brief The process-wide hooks see growth and cleanup with matching sizes
+ */
+static void testProcessAllocator(void)
+{
+    CountingAllocator stProcess;
+
+    memset(&stProcess, 0, sizeof(stProcess));
+    TEST_CHECK(cerror_set_allocator(countingRealloc, countingFree, &stProcess));
+
+    cerror_set_last_info_copy(g_ullCode, "short");
+    TEST_CHECK(1u == stProcess.uAllocs);
+    TEST_CHECK(ERROR_INFO_INITIAL_CAPACITY == stProcess.llLiveBytes);
+
+    /* Growth allocates the larger buffer and frees the old one */
+    cerror_set_last_info_copy(g_ullCode, g_szLong);
+    TEST_CHECK(2u == stProcess.uAllocs);
+    TEST_CHECK(1u == stProcess.uFrees);
+    TEST_CHECK(1024 == stProcess.llLiveBytes);
+    TEST_CHECK(0 == strcmp(g_szLong, cerror_get_last_info()));
+
+    cerror_cleanup_thread_local_buffer();
+    TEST_CHECK(2u == stProcess.uFrees);
+    TEST_CHECK(0 == stProcess.llLiveBytes);
+
+    TEST_CHECK(cerror_set_allocator(NULL, NULL, NULL));
+}
+
+/**
+ * @brief A thread allocator takes over; the current buffer goes back to its owner
+ */
+static void testThreadAllocator(void)
+{
+    CountingAllocator stProcess;
+    CountingAllocator stThread;
+
+    memset(&stProcess, 0, sizeof(stProcess));
+    memset(&stThread, 0, sizeof(stThread));
+    TEST_CHECK(cerror_set_allocator(countingRealloc, countingFree, &stProcess));
+
+    cerror_set_last_info_copy(g_ullCode, "from the process allocator");
+    TEST_CHECK(1u == stProcess.uAllocs);
+
+    TEST_CHECK(cerror_set_thread_allocator(countingRealloc, countingFree, &stThread));
+    TEST_CHECK(0 == stProcess.llLiveBytes);
+
+    cerror_set_last_info_copy(g_ullCode, "from the thread allocator");
+    TEST_CHECK(1u == stProcess.uAllocs);
+    TEST_CHECK(1u == stThread.uAllocs);
+    TEST_CHECK(0 == strcmp("from the thread allocator", cerror_get_last_info()));
+
+    /* Reverting frees the thread allocator's buffer through it */
+    TEST_CHECK(cerror_set_thread_allocator(NULL, NULL, NULL));
+    TEST_CHECK(0 == stThread.llLiveBytes);
+    cerror_set_last_info_copy(g_ullCode, "from the process allocator again");
+    TEST_CHECK(2u == stProcess.uAllocs);
+
+    cerror_cleanup_thread_local_buffer();
+    TEST_CHECK(0 == stProcess.llLiveBytes);
+    TEST_CHECK(1u == stThread.uFrees);
+
+    TEST_CHECK(cerror_set_allocator(NULL, NULL, NULL));
+}
+
+static void countRelease(const char* pszInfo, void* pUserData)
+{
+    (void)pszInfo;
+    (void)pUserData;
+}
+
+/**
+ * @brief The switch is refused while blocks of the current allocator are live
+ */
+static void testSwitchWhileLive(void)
+{
+    CountingAllocator stProcess;
+    CErrorSharedInfo* pShared;
+
+    memset(&stProcess, 0, sizeof(stProcess));
+    TEST_CHECK(cerror_set_allocator(countingRealloc, countingFree, &stProcess));
+
+    cerror_set_last_info_copy(g_ullCode, "held by this thread");
+    TEST_CHECK(!cerror_set_allocator(NULL, NULL, NULL));
+    cerror_cleanup_thread_local_buffer();
+
+    pShared = cerror_shared_info_create("held by a holder", countRelease, NULL);
+    TEST_CHECK(!cerror_set_allocator(NULL, NULL, NULL));
+    cerror_shared_info_release(pShared);
+
+    /* Cached pool buffers are drained back to their allocator first */
+    cerror_pool_enable(4096);
+    cerror_set_last_info_copy(g_ullCode, "cached by the pool");
+    cerror_cleanup_thread_local_buffer();
+    TEST_CHECK(cerror_set_allocator(NULL, NULL, NULL));
+    TEST_CHECK(0 == stProcess.llLiveBytes);
+    TEST_CHECK(stProcess.uAllocs == stProcess.uFrees);
+    cerror_pool_disable();
+}
+
+int main(void)
+{
+    memset(g_szLong, 'a', sizeof(g_szLong) - 1);
+
+    testValidation();
+    testProcessAllocator();
+    testThreadAllocator();
+    testSwitchWhileLive();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,88 @@
+/**
+ * @file test_arena.c
+ * @brief Per-request arenas: retained messages, truncation, exhaustion and reset
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <string.h>
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x63, CERROR_UNAVAILABLE, 0x0001);
+
+/**
+ * @brief Every message of a request stays valid until the arena is reset
+ */
+static void testRetained(void)
+{
+    char        aMemory[128];
+    CErrorArena stArena;
+    const char* pszFirst;
+    const char* pszSecond;
+
+    cerror_arena_init(&stArena, aMemory, sizeof(aMemory));
+    cerror_bind_arena(&stArena);
+    TEST_CHECK(&stArena == cerror_get_bound_arena());
+
+    cerror_set_last_info_copy(g_ullCode, "first");
+    pszFirst = cerror_get_last_info();
+    cerror_set_last_info_copy(g_ullCode, "second");
+    pszSecond = cerror_get_last_info();
+
+    TEST_CHECK(pszFirst >= aMemory && pszFirst < aMemory + sizeof(aMemory));
+    TEST_CHECK(pszSecond == pszFirst + sizeof("first"));
+    TEST_CHECK(0 == strcmp("first", pszFirst));
+    TEST_CHECK(0 == strcmp("second", pszSecond));
+    TEST_CHECK(sizeof("first") + sizeof("second") == stArena.nUsed);
+
+    /* Reset: O(1), and the current info no longer points into the arena */
+    cerror_arena_reset(&stArena);
+    TEST_CHECK(0u == stArena.nUsed);
+    TEST_CHECK(g_ullCode == cerror_get_last());
+    TEST_CHECK('\0' == cerror_get_last_info()[0]);
+
+    cerror_bind_arena(NULL);
+    TEST_CHECK(NULL == cerror_get_bound_arena());
+}
+
+/**
+ * @brief A message that does not fit is truncated, an exhausted arena falls back to the buffer
+ */
+static void testExhausted(void)
+{
+    char        aMemory[16];
+    CErrorArena stArena;
+    const char* pszInfo;
+
+    cerror_arena_init(&stArena, aMemory, sizeof(aMemory));
+    cerror_bind_arena(&stArena);
+
+    cerror_set_last_info_copy(g_ullCode, "a message longer than the arena");
+    pszInfo = cerror_get_last_info();
+    TEST_CHECK(pszInfo == aMemory);
+    TEST_CHECK(cerror_is_last_info_truncated());
+    TEST_CHECK(sizeof(aMemory) - 1 == strlen(pszInfo));
+    TEST_CHECK(sizeof(aMemory) == stArena.nUsed);
+
+    cerror_set_last_info_copy(g_ullCode, "from the buffer");
+    pszInfo = cerror_get_last_info();
+    TEST_CHECK(pszInfo < aMemory || pszInfo >= aMemory + sizeof(aMemory));
+    TEST_CHECK(0 == strcmp("from the buffer", pszInfo));
+    TEST_CHECK(!cerror_is_last_info_truncated());
+
+    /* Info outside the arena survives its reset */
+    cerror_arena_reset(&stArena);
+    TEST_CHECK(0 == strcmp("from the buffer", cerror_get_last_info()));
+
+    cerror_bind_arena(NULL);
+}
+
+int main(void)
+{
+    testRetained();
+    testExhausted();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,136 @@
+/**
+ * @file test_capacity_policy.c
+ * @brief Capacity policy: validation, power-of-2 growth, hard cap and shrink after a spike
+ *
+ * The thread's heap bytes (cerror_get_thread_memory_stats()) show the
+ * capacity of its info buffer.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <string.h>
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x61, CERROR_INVALID_ARGUMENT, 0x0001);
+
+static char g_szText[8192];
+
+/**
+ * @brief Copy a message of nLength bytes
+ */
+static void copyLength(size_t nLength)
+{
+    cerror_set_last_info_copy(g_ullCode, g_szText + sizeof(g_szText) - 1 - nLength);
+}
+
+static uint64_t bufferBytes(void)
+{
+    CErrorMemoryStats stStats;
+
+    cerror_get_thread_memory_stats(&stStats);
+    return stStats.ullCurrentBytes;
+}
+
+static void testValidation(void)
+{
+    CErrorCapacityPolicy stPolicy;
+
+    stPolicy.nInitialCapacity = 0;
+    stPolicy.nMaxCapacity = 1024;
+    stPolicy.nShrinkThreshold = CERROR_CAPACITY_UNLIMITED;
+    TEST_CHECK(!cerror_set_capacity_policy(&stPolicy));
+
+    stPolicy.nInitialCapacity = 2048;
+    TEST_CHECK(!cerror_set_capacity_policy(&stPolicy));
+
+    stPolicy.nInitialCapacity = 256;
+    stPolicy.nShrinkThreshold = 128;
+    TEST_CHECK(!cerror_set_capacity_policy(&stPolicy));
+
+    /* Rejected policies leave the default in place */
+    cerror_get_capacity_policy(&stPolicy);
+    TEST_CHECK(ERROR_INFO_INITIAL_CAPACITY == stPolicy.nInitialCapacity);
+    TEST_CHECK(CERROR_CAPACITY_UNLIMITED == stPolicy.nMaxCapacity);
+    TEST_CHECK(CERROR_CAPACITY_UNLIMITED == stPolicy.nShrinkThreshold);
+}
+
+static void testGrowth(void)
+{
+    TEST_CHECK(cerror_set_capacity_policy(NULL));
+
+    copyLength(10);
+    TEST_CHECK(ERROR_INFO_INITIAL_CAPACITY == bufferBytes());
+
+    copyLength(300);
+    TEST_CHECK(512u == bufferBytes());
+    TEST_CHECK(300u == strlen(cerror_get_last_info()));
+
+    /* Without a shrink threshold the buffer stays */
+    copyLength(10);
+    cerror_clear_last();
+    TEST_CHECK(512u == bufferBytes());
+    cerror_cleanup_thread_local_buffer();
+}
+
+static void testMaxCapacity(void)
+{
+    CErrorCapacityPolicy stPolicy;
+
+    stPolicy.nInitialCapacity = 128;
+    stPolicy.nMaxCapacity = 256;
+    stPolicy.nShrinkThreshold = CERROR_CAPACITY_UNLIMITED;
+    TEST_CHECK(cerror_set_capacity_policy(&stPolicy));
+
+    copyLength(1000);
+    TEST_CHECK(g_ullCode == cerror_get_last());
+    TEST_CHECK(cerror_is_last_info_truncated());
+    TEST_CHECK(255u == strlen(cerror_get_last_info()));
+    TEST_CHECK(256u == bufferBytes());
+
+    cerror_cleanup_thread_local_buffer();
+}
+
+static void testShrink(void)
+{
+    CErrorCapacityPolicy stPolicy;
+
+    stPolicy.nInitialCapacity = 128;
+    stPolicy.nMaxCapacity = CERROR_CAPACITY_UNLIMITED;
+    stPolicy.nShrinkThreshold = 1024;
+    TEST_CHECK(cerror_set_capacity_policy(&stPolicy));
+
+    /* A spike, then a small message: the large buffer is released */
+    copyLength(3000);
+    TEST_CHECK(4096u == bufferBytes());
+    TEST_CHECK(3000u == strlen(cerror_get_last_info()));
+    copyLength(20);
+    TEST_CHECK(bufferBytes() <= 1024u);
+    TEST_CHECK(20u == strlen(cerror_get_last_info()));
+
+    /* A spike, then a clear */
+    copyLength(3000);
+    TEST_CHECK(4096u == bufferBytes());
+    cerror_clear_last();
+    TEST_CHECK(0u == bufferBytes());
+
+    /* Within the threshold the buffer is kept */
+    copyLength(600);
+    cerror_clear_last();
+    TEST_CHECK(1024u == bufferBytes());
+
+    cerror_cleanup_thread_local_buffer();
+    TEST_CHECK(cerror_set_capacity_policy(NULL));
+}
+
+int main(void)
+{
+    memset(g_szText, 'c', sizeof(g_szText) - 1);
+
+    testValidation();
+    testGrowth();
+    testMaxCapacity();
+    testShrink();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,94 @@
+/**
+ * @file test_causes.c
+ * @brief Cause chains: wrap order, copied causes, a full chain and the chain's lifetime
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <string.h>
+
+static uint64_t layerCode(uint16_t uLayer)
+{
+    return MAKE_ERROR_CODE(0x01, 0x68, CERROR_UNAVAILABLE, uLayer);
+}
+
+/**
+ * @brief Depth 0 is the last error, the deepest entry is the root
+ */
+static void testChain(void)
+{
+    cerror_set_last_info_copy(layerCode(1), "disk read failed");
+    cerror_wrap_last(layerCode(2), "load page");
+    cerror_wrap_last(layerCode(3), "open table");
+
+    TEST_CHECK(2u == cerror_get_cause_count());
+    TEST_CHECK(layerCode(3) == cerror_get_last());
+    TEST_CHECK(layerCode(3) == cerror_get_cause(0));
+    TEST_CHECK(layerCode(2) == cerror_get_cause(1));
+    TEST_CHECK(layerCode(1) == cerror_get_cause(2));
+    TEST_CHECK(0u == cerror_get_cause(3));
+    TEST_CHECK(0 == strcmp("open table", cerror_get_cause_info(0)));
+    TEST_CHECK(0 == strcmp("load page", cerror_get_cause_info(1)));
+    TEST_CHECK(0 == strcmp("disk read failed", cerror_get_cause_info(2)));
+    TEST_CHECK(0 == strcmp("", cerror_get_cause_info(3)));
+
+    /* The copied root info is still intact after wrapping */
+    TEST_CHECK(layerCode(1) == cerror_get_root_cause());
+    TEST_CHECK(0 == strcmp("disk read failed", cerror_get_root_cause_info()));
+}
+
+/**
+ * @brief A full chain keeps the root and the nearest causes
+ */
+static void testFullChain(void)
+{
+    uint16_t uLayer;
+
+    cerror_set_last_info(layerCode(0), "root");
+    for (uLayer = 1; uLayer <= CERROR_MAX_CAUSE_DEPTH + 2; ++uLayer)
+    {
+        cerror_wrap_last(layerCode(uLayer), "layer");
+    }
+
+    TEST_CHECK(CERROR_MAX_CAUSE_DEPTH == cerror_get_cause_count());
+    TEST_CHECK(layerCode(CERROR_MAX_CAUSE_DEPTH + 2) == cerror_get_last());
+    TEST_CHECK(layerCode(CERROR_MAX_CAUSE_DEPTH + 1) == cerror_get_cause(1));
+    TEST_CHECK(layerCode(0) == cerror_get_root_cause());
+    TEST_CHECK(0 == strcmp("root", cerror_get_root_cause_info()));
+}
+
+/**
+ * @brief Wrapping nothing is a plain set; the next set or clear drops the chain
+ */
+static void testLifetime(void)
+{
+    cerror_clear_last();
+    cerror_wrap_last(layerCode(5), "nothing to wrap");
+    TEST_CHECK(0u == cerror_get_cause_count());
+    TEST_CHECK(layerCode(5) == cerror_get_root_cause());
+    TEST_CHECK(0 == strcmp("nothing to wrap", cerror_get_last_info()));
+
+    cerror_wrap_last(layerCode(6), "wrapped");
+    TEST_CHECK(1u == cerror_get_cause_count());
+    cerror_set_last(layerCode(7));
+    TEST_CHECK(0u == cerror_get_cause_count());
+    TEST_CHECK(layerCode(7) == cerror_get_root_cause());
+
+    cerror_wrap_last(layerCode(8), "wrapped again");
+    TEST_CHECK(1u == cerror_get_cause_count());
+    cerror_clear_last();
+    TEST_CHECK(0u == cerror_get_cause_count());
+    TEST_CHECK(0u == cerror_get_root_cause());
+}
+
+int main(void)
+{
+    testChain();
+    testFullChain();
+    testLifetime();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
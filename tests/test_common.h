@@ -0,0 +1,26 @@
+/**
+ * @file test_common.h
+ * @brief Minimal check macros shared by the tests
+ *
+ * A failed check prints its location and expression and the test goes on;
+ * main() returns TEST_RESULT() so CTest sees the failure.
+ */
+#pragma once
+
+#include <stdio.h>
+
+static int g_nTestFailures = 0;
+
+/** Record a failure if cond is false */
+#define TEST_CHECK(cond) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_nTestFailures; \
+        } \
+    } while (0)
+
+/** Exit code of a test: 0 if every check passed */
+#define TEST_RESULT() (0 == g_nTestFailures ? 0 : 1)
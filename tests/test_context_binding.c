@@ -0,0 +1,93 @@
+/**
+ * @file test_context_binding.c
+ * @brief Request-scoped contexts: interleaved requests on one thread keep their errors apart
+ *
+ * Built with CERROR_ENABLE_CONTEXT_BINDING.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <string.h>
+
+static const uint64_t g_ullCodeA = MAKE_ERROR_CODE(0x01, 0x6E, CERROR_NOT_FOUND, 0x0001);
+static const uint64_t g_ullCodeB = MAKE_ERROR_CODE(0x01, 0x6E, CERROR_UNAVAILABLE, 0x0002);
+static const uint64_t g_ullOwn = MAKE_ERROR_CODE(0x01, 0x6E, CERROR_INTERNAL, 0x0003);
+
+static ErrorContext g_RequestA;
+static ErrorContext g_RequestB;
+
+/**
+ * @brief Each callback sees only its request's error, the thread's own error is untouched
+ */
+static void testInterleaved(void)
+{
+    ErrorContext* pPrevious;
+
+    cerror_context_init(&g_RequestA);
+    cerror_context_init(&g_RequestB);
+    cerror_set_last_info_copy(g_ullOwn, "thread error");
+
+    pPrevious = cerror_bind_context(&g_RequestA);
+    TEST_CHECK(NULL == pPrevious);
+    TEST_CHECK(&g_RequestA == cerror_ctx());
+    TEST_CHECK(0u == cerror_get_last());
+    cerror_set_last_info_copy(g_ullCodeA, "request A failed");
+
+    pPrevious = cerror_bind_context(&g_RequestB);
+    TEST_CHECK(&g_RequestA == pPrevious);
+    TEST_CHECK(0u == cerror_get_last());
+    cerror_set_last_info_copy(g_ullCodeB, "request B failed");
+    (void)cerror_bind_context(pPrevious);
+
+    TEST_CHECK(g_ullCodeA == cerror_get_last());
+    TEST_CHECK(0 == strcmp("request A failed", cerror_get_last_info()));
+    cerror_unbind_context();
+
+    TEST_CHECK(g_ullOwn == cerror_get_last());
+    TEST_CHECK(0 == strcmp("thread error", cerror_get_last_info()));
+
+    (void)cerror_bind_context(&g_RequestB);
+    TEST_CHECK(g_ullCodeB == cerror_get_last());
+    TEST_CHECK(0 == strcmp("request B failed", cerror_get_last_info()));
+    cerror_unbind_context();
+}
+
+/**
+ * @brief Thread cleanup leaves a bound request context alone; destroy frees it
+ */
+static void testCleanup(void)
+{
+    (void)cerror_bind_context(&g_RequestA);
+    cerror_cleanup_thread_local_buffer();
+    TEST_CHECK(&g_RequestA == cerror_ctx());
+    TEST_CHECK(g_ullCodeA == cerror_get_last());
+    TEST_CHECK(0 == strcmp("request A failed", cerror_get_last_info()));
+    cerror_unbind_context();
+
+    TEST_CHECK(&g_LastErrorCtx == cerror_ctx());
+    TEST_CHECK(0u == cerror_get_last());
+
+    cerror_context_destroy(&g_RequestA);
+    cerror_context_destroy(&g_RequestB);
+    TEST_CHECK(NULL == g_RequestA.pszLastErrorInfoBuffer);
+    TEST_CHECK(NULL == g_RequestB.pszLastErrorInfoBuffer);
+
+    /* A destroyed context can be initialized and used again */
+    cerror_context_init(&g_RequestA);
+    (void)cerror_bind_context(&g_RequestA);
+    cerror_set_last(g_ullCodeA);
+    TEST_CHECK(g_ullCodeA == cerror_get_last());
+    cerror_unbind_context();
+    cerror_context_destroy(&g_RequestA);
+}
+
+int main(void)
+{
+    testInterleaved();
+    testCleanup();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,71 @@
+/**
+ * @file test_dirty_clear.c
+ * @brief Dirty-word clear: the context word is 0 exactly when nothing is set
+ *
+ * cerror_clear_last() returns after one load when the word is 0, so every
+ * setter must leave it non-zero (even for code 0) and every clear must
+ * leave info and flags reading as empty.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x67, CERROR_ABORTED, 0x0001);
+
+static uint64_t contextWord(void)
+{
+    return cerror_ctx()->ullLastError;
+}
+
+static void testDirtyAfterSet(void)
+{
+    TEST_CHECK(0u == contextWord());
+
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(0u != (contextWord() & CERROR_FLAG_DIRTY));
+    cerror_clear_last();
+    TEST_CHECK(0u == contextWord());
+
+    /* Info without a code is still something to clear */
+    cerror_set_last_info(0u, "info only");
+    TEST_CHECK(0u != contextWord());
+    TEST_CHECK(0u == cerror_get_last());
+    cerror_clear_last();
+    TEST_CHECK(0u == contextWord());
+    TEST_CHECK('\0' == cerror_get_last_info()[0]);
+
+    cerror_set_last_info_copy(0u, "copied info only");
+    TEST_CHECK(0u != contextWord());
+    cerror_clear_last();
+    TEST_CHECK('\0' == cerror_get_last_info()[0]);
+}
+
+static void testClearResetsEverything(void)
+{
+    cerror_set_last_info_copy(g_ullCode, "copied");
+    cerror_clear_last();
+    TEST_CHECK(0u == cerror_get_last());
+    TEST_CHECK('\0' == cerror_get_last_info()[0]);
+    TEST_CHECK(!cerror_is_last_info_truncated());
+    TEST_CHECK(0u == cerror_get_cause_count());
+
+    /* Clearing a clear context changes nothing */
+    cerror_clear_last();
+    cerror_clear_last();
+    TEST_CHECK(0u == contextWord());
+    TEST_CHECK('\0' == cerror_get_last_info()[0]);
+
+    /* The buffer is kept for the next copy */
+    cerror_set_last_info_copy(g_ullCode, "again");
+    TEST_CHECK(g_ullCode == cerror_get_last());
+}
+
+int main(void)
+{
+    testDirtyAfterSet();
+    testClearResetsEverything();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
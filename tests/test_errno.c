@@ -0,0 +1,73 @@
+/**
+ * @file test_errno.c
+ * @brief errno integration: status mapping, round trip and lazily rendered strerror text
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <errno.h>
+#include <string.h>
+
+static void testMapping(void)
+{
+    TEST_CHECK(CERROR_OK == cerror_errno_to_status(0));
+    TEST_CHECK(CERROR_NOT_FOUND == cerror_errno_to_status(ENOENT));
+    TEST_CHECK(CERROR_PERMISSION_DENIED == cerror_errno_to_status(EACCES));
+    TEST_CHECK(CERROR_INVALID_ARGUMENT == cerror_errno_to_status(EINVAL));
+    TEST_CHECK(CERROR_RESOURCE_EXHAUSTED == cerror_errno_to_status(ENOMEM));
+    TEST_CHECK(CERROR_DEADLINE_EXCEEDED == cerror_errno_to_status(ETIMEDOUT));
+
+    TEST_CHECK(0 == cerror_status_to_errno(CERROR_OK));
+    TEST_CHECK(ENOENT == cerror_status_to_errno(CERROR_NOT_FOUND));
+    TEST_CHECK(EINVAL == cerror_status_to_errno(CERROR_INVALID_ARGUMENT));
+}
+
+/**
+ * @brief The errno value survives the round trip and its text appears on first read
+ */
+static void testSetFromErrno(void)
+{
+    char szExpected[128];
+
+    cerror_set_from_errno(0x01, 0x66, EACCES);
+    TEST_CHECK(CERROR_PERMISSION_DENIED == cerror_get_last_status());
+    TEST_CHECK(0x66 == GET_COMPONENT_ID(cerror_get_last()));
+    TEST_CHECK(EACCES == cerror_get_last_code());
+    TEST_CHECK(EACCES == cerror_get_last_errno());
+
+    /* Rendered lazily, the same text as strerror */
+    strncpy(szExpected, strerror(EACCES), sizeof(szExpected) - 1);
+    szExpected[sizeof(szExpected) - 1] = '\0';
+    TEST_CHECK(0 == strcmp(szExpected, cerror_get_last_info()));
+    TEST_CHECK(0 == strcmp(szExpected, cerror_get_last_info()));
+
+    /* The next set replaces the text */
+    cerror_set_from_errno(0x01, 0x66, ENOENT);
+    strncpy(szExpected, strerror(ENOENT), sizeof(szExpected) - 1);
+    TEST_CHECK(0 == strcmp(szExpected, cerror_get_last_info()));
+}
+
+/**
+ * @brief Errors not set from errno report a representative errno
+ */
+static void testRepresentativeErrno(void)
+{
+    cerror_set_last_info(MAKE_ERROR_CODE(0x01, 0x66, CERROR_NOT_FOUND, 0x0777), "no such key");
+    TEST_CHECK(ENOENT == cerror_get_last_errno());
+    TEST_CHECK(0 == strcmp("no such key", cerror_get_last_info()));
+
+    cerror_clear_last();
+    TEST_CHECK(0 == cerror_get_last_errno());
+}
+
+int main(void)
+{
+    testMapping();
+    testSetFromErrno();
+    testRepresentativeErrno();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_errorvec.c
+ * @brief Error vectors: per-row set, bulk set, merge and queries over a partial last word
+ */
+
+#include "test_common.h"
+
+#include <c-error/errorvec.h>
+
+#include <string.h>
+
+/** Three bitmap words, the last one partial */
+#define TEST_ROWS 130u
+
+static const uint64_t g_ullParse = MAKE_ERROR_CODE(0x01, 0x6D, CERROR_INVALID_ARGUMENT, 0x0001);
+static const uint64_t g_ullRange = MAKE_ERROR_CODE(0x01, 0x6D, CERROR_OUT_OF_RANGE, 0x0002);
+
+static uint64_t g_aCodes[TEST_ROWS];
+static uint64_t g_aValidity[CERROR_VECTOR_BITMAP_WORDS(TEST_ROWS)];
+
+static void testSingleRows(void)
+{
+    CErrorVector vector;
+
+    cerror_vector_init(&vector, g_aCodes, g_aValidity, TEST_ROWS);
+    TEST_CHECK(!cerror_vector_any(&vector));
+    TEST_CHECK(CERROR_VECTOR_NONE == cerror_vector_first(&vector));
+
+    cerror_vector_set(&vector, 129, g_ullParse);
+    cerror_vector_set(&vector, 64, g_ullRange);
+    TEST_CHECK(cerror_vector_any(&vector));
+    TEST_CHECK(2u == cerror_vector_count(&vector));
+    TEST_CHECK(64u == cerror_vector_first(&vector));
+    TEST_CHECK(g_ullParse == cerror_vector_get(&vector, 129));
+    TEST_CHECK(0u == cerror_vector_get(&vector, 128));
+    TEST_CHECK(!cerror_vector_is_set(&vector, 0));
+
+    cerror_vector_reset(&vector);
+    TEST_CHECK(0u == cerror_vector_count(&vector));
+}
+
+/**
+ * @brief Flag bytes and masks set exactly their rows; mask bits past the end are ignored
+ */
+static void testBulk(void)
+{
+    CErrorVector vector;
+    uint8_t      aFlags[TEST_ROWS];
+    uint64_t     aMask[CERROR_VECTOR_BITMAP_WORDS(TEST_ROWS)];
+    size_t       aCounts[MAX_STATUS + 1];
+    size_t       i;
+
+    cerror_vector_init(&vector, g_aCodes, g_aValidity, TEST_ROWS);
+    for (i = 0; i < TEST_ROWS; ++i)
+    {
+        aFlags[i] = (uint8_t)(0 == i % 3u ? 0xFF : 0);
+    }
+    cerror_vector_set_flags(&vector, aFlags, g_ullParse);
+    TEST_CHECK(44u == cerror_vector_count(&vector));
+    TEST_CHECK(g_ullParse == cerror_vector_get(&vector, 129));
+
+    /* Rows 0, 1, 127, 128 and 129; the rest of the last word lies past the end */
+    aMask[0] = 0x3ULL;
+    aMask[1] = 1ULL << 63;
+    aMask[2] = ~0ULL;
+    cerror_vector_set_mask(&vector, aMask, g_ullRange);
+    TEST_CHECK(g_ullRange == cerror_vector_get(&vector, 0));
+    TEST_CHECK(g_ullRange == cerror_vector_get(&vector, 1));
+    TEST_CHECK(g_ullRange == cerror_vector_get(&vector, 129));
+    TEST_CHECK(0u == (g_aValidity[2] >> (TEST_ROWS % 64u)));
+    TEST_CHECK(47u == cerror_vector_count(&vector));
+
+    cerror_vector_count_by_status(&vector, aCounts);
+    TEST_CHECK(5u == aCounts[CERROR_OUT_OF_RANGE]);
+    TEST_CHECK(42u == aCounts[CERROR_INVALID_ARGUMENT]);
+    TEST_CHECK(0u == aCounts[CERROR_OK]);
+}
+
+/**
+ * @brief Rows that failed in both keep the target's error
+ */
+static void testMerge(void)
+{
+    CErrorVector target;
+    CErrorVector source;
+    uint64_t     aCodes[TEST_ROWS];
+    uint64_t     aValidity[CERROR_VECTOR_BITMAP_WORDS(TEST_ROWS)];
+
+    cerror_vector_init(&target, g_aCodes, g_aValidity, TEST_ROWS);
+    cerror_vector_init(&source, aCodes, aValidity, TEST_ROWS);
+    cerror_vector_set(&target, 5, g_ullParse);
+    cerror_vector_set(&source, 5, g_ullRange);
+    cerror_vector_set(&source, 100, g_ullRange);
+
+    cerror_vector_merge(&target, &source);
+    TEST_CHECK(2u == cerror_vector_count(&target));
+    TEST_CHECK(g_ullParse == cerror_vector_get(&target, 5));
+    TEST_CHECK(g_ullRange == cerror_vector_get(&target, 100));
+
+    /* Only rows inside both vectors merge: bits past a shorter source are not rows */
+    cerror_vector_init(&target, g_aCodes, g_aValidity, TEST_ROWS);
+    cerror_vector_init(&source, aCodes, aValidity, 70);
+    cerror_vector_set(&source, 69, g_ullRange);
+    aValidity[1] |= 1ULL << (84 - 64);
+    cerror_vector_merge(&target, &source);
+    TEST_CHECK(1u == cerror_vector_count(&target));
+    TEST_CHECK(g_ullRange == cerror_vector_get(&target, 69));
+    TEST_CHECK(0u == cerror_vector_get(&target, 84));
+
+    /* A shorter target takes nothing past its own rows */
+    cerror_vector_init(&target, g_aCodes, g_aValidity, 70);
+    cerror_vector_init(&source, aCodes, aValidity, TEST_ROWS);
+    cerror_vector_set(&source, 3, g_ullParse);
+    cerror_vector_set(&source, 100, g_ullRange);
+    cerror_vector_merge(&target, &source);
+    TEST_CHECK(1u == cerror_vector_count(&target));
+    TEST_CHECK(0 == (g_aValidity[1] >> (70 - 64)));
+}
+
+static void testToLast(void)
+{
+    CErrorVector vector;
+
+    cerror_vector_init(&vector, g_aCodes, g_aValidity, TEST_ROWS);
+    cerror_clear_last();
+    TEST_CHECK(CERROR_VECTOR_NONE == cerror_vector_to_last(&vector));
+    TEST_CHECK(0u == cerror_get_last());
+
+    cerror_vector_set(&vector, 77, g_ullRange);
+    cerror_vector_set(&vector, 99, g_ullParse);
+    TEST_CHECK(77u == cerror_vector_to_last(&vector));
+    TEST_CHECK(g_ullRange == cerror_get_last());
+}
+
+int main(void)
+{
+    testSingleRows();
+    testBulk();
+    testMerge();
+    testToLast();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
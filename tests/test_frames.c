@@ -0,0 +1,110 @@
+/**
+ * @file test_frames.c
+ * @brief Annotation frames: capture on set, survival of later pushes, depth limit
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+#include <c-error/frames.h>
+
+#include <string.h>
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x69, CERROR_INTERNAL, 0x0001);
+
+/**
+ * @brief Frames active at the set are rendered outermost first, after they are popped
+ */
+static void testCapture(void)
+{
+    char szText[128];
+
+    cerror_frame_push("tenant %lld", 42, 0);
+    cerror_frame_push("shard %lld of %lld", 7, 16);
+    cerror_set_last_info(g_ullCode, "write failed");
+    cerror_frame_pop();
+    cerror_frame_pop();
+
+    TEST_CHECK(2u == cerror_get_frame_count());
+    TEST_CHECK(42 == cerror_get_frames()[0].llArg0);
+    TEST_CHECK(7 == cerror_get_frames()[1].llArg0);
+    TEST_CHECK(25u == cerror_frames_render(szText, sizeof(szText)));
+    TEST_CHECK(0 == strcmp("tenant 42 / shard 7 of 16", szText));
+}
+
+/**
+ * @brief A push over a captured slot copies the error's frames aside first
+ */
+static void testLaterPush(void)
+{
+    char szText[128];
+
+    cerror_frame_push("request %lld", 1, 0);
+    cerror_set_last(g_ullCode);
+    cerror_frame_pop();
+
+    cerror_frame_push("request %lld", 2, 0);
+    cerror_frame_push("retry %lld", 3, 0);
+    cerror_frames_render(szText, sizeof(szText));
+    TEST_CHECK(1u == cerror_get_frame_count());
+    TEST_CHECK(0 == strcmp("request 1", szText));
+
+    /* Frames active now belong to the next error */
+    cerror_set_last(g_ullCode);
+    cerror_frames_render(szText, sizeof(szText));
+    TEST_CHECK(0 == strcmp("request 2 / retry 3", szText));
+    cerror_frame_pop();
+    cerror_frame_pop();
+}
+
+static void testNoFrames(void)
+{
+    char szText[16];
+
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(0u == cerror_get_frame_count());
+    TEST_CHECK(0u == cerror_frames_render(szText, sizeof(szText)));
+    TEST_CHECK('\0' == szText[0]);
+
+    cerror_frame_push("job %lld", 5, 0);
+    cerror_set_last(g_ullCode);
+    cerror_frame_pop();
+    cerror_clear_last();
+    TEST_CHECK(0u == cerror_get_frame_count());
+}
+
+/**
+ * @brief Frames beyond CERROR_MAX_FRAMES are counted on the stack but not recorded
+ */
+static void testDepthLimit(void)
+{
+    char     szText[16];
+    uint32_t i;
+
+    for (i = 0; i < CERROR_MAX_FRAMES + 3; ++i)
+    {
+        cerror_frame_push("level %lld", (int64_t)i, 0);
+    }
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(CERROR_MAX_FRAMES == cerror_get_frame_count());
+    for (i = 0; i < CERROR_MAX_FRAMES + 3; ++i)
+    {
+        cerror_frame_pop();
+    }
+    TEST_CHECK(0u == cerror_ctx()->uFrameDepth);
+
+    /* snprintf semantics when the output is too small */
+    TEST_CHECK(cerror_frames_render(szText, sizeof(szText)) >= sizeof(szText));
+    TEST_CHECK(sizeof(szText) - 1 == strlen(szText));
+}
+
+int main(void)
+{
+    testCapture();
+    testLaterPush();
+    testNoFrames();
+    testDepthLimit();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
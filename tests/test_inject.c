@@ -0,0 +1,229 @@
+/**
+ * @file test_inject.c
+ * @brief Fault injection: rule selection, schedules, seeded probability, config parsing and counters
+ */
+
+#include "test_common.h"
+
+#include <c-error/inject.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_CALLS 64
+
+static const uint64_t g_ullRead = MAKE_ERROR_CODE(0x01, 0x6F, CERROR_UNAVAILABLE, 0x0001);
+static const uint64_t g_ullWrite = MAKE_ERROR_CODE(0x01, 0x70, CERROR_RESOURCE_EXHAUSTED, 0x0002);
+
+/** Injection points: return 1 on success, 0 when failed by a rule */
+static int readBlock(void)
+{
+    return !CERROR_INJECT_POINT(g_ullRead);
+}
+
+static int writeBlock(void)
+{
+    return !CERROR_INJECT_POINT(g_ullWrite);
+}
+
+/**
+ * @brief Bitmap of the failed calls among TEST_CALLS calls of readBlock()
+ */
+static uint64_t failedReads(void)
+{
+    uint64_t ullFailed = 0;
+    int      i;
+
+    for (i = 0; i < TEST_CALLS; ++i)
+    {
+        if (!readBlock())
+        {
+            ullFailed |= 1ULL << i;
+        }
+    }
+    return ullFailed;
+}
+
+static void resetRules(void)
+{
+    cerror_inject_enable(0);
+    cerror_inject_clear_rules();
+    cerror_inject_reset_counters();
+}
+
+/**
+ * @brief Nothing fails while disabled; a rule hits only the selected component
+ */
+static void testSelection(void)
+{
+    CErrorInjectRule stRule;
+
+    memset(&stRule, 0, sizeof(stRule));
+    cerror_inject_select(&stRule, -1, 0x6F, -1);
+    stRule.dProbability = 1.0;
+    TEST_CHECK(1 == cerror_inject_add_rule(&stRule));
+
+    TEST_CHECK(0u == failedReads());
+
+    cerror_inject_enable(1);
+    cerror_clear_last();
+    TEST_CHECK(0 == readBlock());
+    TEST_CHECK(g_ullRead == cerror_get_last());
+    TEST_CHECK(0 == strcmp("injected fault", cerror_get_last_info()));
+    TEST_CHECK(1 == writeBlock());
+    resetRules();
+
+    /* Probability out of range and match bits outside the mask are invalid */
+    stRule.dProbability = 1.5;
+    TEST_CHECK(0 == cerror_inject_add_rule(&stRule));
+    stRule.dProbability = 0.5;
+    stRule.ullMask = 0;
+    TEST_CHECK(0 == cerror_inject_add_rule(&stRule));
+}
+
+/**
+ * @brief every=3 skip=4 limit=2 fails the 7th and 10th call only
+ */
+static void testSchedule(void)
+{
+    CErrorInjectRule stRule;
+
+    TEST_CHECK(1 == cerror_inject_parse_rule("component=0x6F every=3 skip=4 limit=2", &stRule));
+    TEST_CHECK(1 == cerror_inject_add_rule(&stRule));
+    cerror_inject_enable(1);
+    TEST_CHECK(((1ULL << 6) | (1ULL << 9)) == failedReads());
+
+    /* Counters restart the schedule and the limit */
+    cerror_inject_reset_counters();
+    TEST_CHECK(((1ULL << 6) | (1ULL << 9)) == failedReads());
+    resetRules();
+}
+
+/**
+ * @brief The same seed replays the same failures
+ */
+static void testSeed(void)
+{
+    CErrorInjectRule stRule;
+    uint64_t         ullFirst;
+    uint64_t         ullSecond;
+
+    TEST_CHECK(1 == cerror_inject_parse_rule("software=1 component=0x6F probability=0.5", &stRule));
+    TEST_CHECK(1 == cerror_inject_add_rule(&stRule));
+    cerror_inject_enable(1);
+
+    cerror_inject_seed(1234);
+    ullFirst = failedReads();
+    cerror_inject_seed(1234);
+    ullSecond = failedReads();
+    TEST_CHECK(ullFirst == ullSecond);
+    TEST_CHECK(0u != ullFirst && ~0ULL != ullFirst);
+
+    cerror_inject_seed(4321);
+    TEST_CHECK(ullFirst != failedReads());
+    resetRules();
+}
+
+static void testParse(void)
+{
+    CErrorInjectRule stRule;
+    CErrorInjectRule stExpected;
+
+    TEST_CHECK(1 == cerror_inject_parse_rule("  status=14\tprobability=0.25 limit=0x10 ", &stRule));
+    memset(&stExpected, 0, sizeof(stExpected));
+    cerror_inject_select(&stExpected, -1, -1, 14);
+    TEST_CHECK(stExpected.ullMask == stRule.ullMask && stExpected.ullMatch == stRule.ullMatch);
+    TEST_CHECK(0.25 == stRule.dProbability);
+    TEST_CHECK(16u == stRule.uLimit);
+
+    TEST_CHECK(0 == cerror_inject_parse_rule("colour=3", &stRule));
+    TEST_CHECK(0 == cerror_inject_parse_rule("status", &stRule));
+    TEST_CHECK(0 == cerror_inject_parse_rule("status=99", &stRule));
+    TEST_CHECK(0 == cerror_inject_parse_rule("skip=12x", &stRule));
+    TEST_CHECK(0 == cerror_inject_parse_rule("probability=2", &stRule));
+    TEST_CHECK(0 == cerror_inject_parse_rule("probability=0.5abc", &stRule));
+}
+
+/**
+ * @brief Config files add one rule per line; comments and blank lines are skipped
+ */
+static void testConfig(void)
+{
+    const char* const pszPath = "test_inject.cfg";
+    FILE*             pFile = fopen(pszPath, "w");
+
+    TEST_CHECK(NULL != pFile);
+    if (NULL == pFile)
+    {
+        return;
+    }
+    fputs("# storage faults\n\ncomponent=0x70 every=2   # every other write\nstatus=3 probability=0\n", pFile);
+    fclose(pFile);
+
+    TEST_CHECK(2 == cerror_inject_load_config(pszPath));
+    cerror_inject_enable(1);
+    TEST_CHECK(1 == writeBlock());
+    TEST_CHECK(0 == writeBlock());
+    TEST_CHECK(g_ullWrite == cerror_get_last());
+    resetRules();
+
+    pFile = fopen(pszPath, "w");
+    if (NULL != pFile)
+    {
+        fputs("component=0x70\nbogus\n", pFile);
+        fclose(pFile);
+        TEST_CHECK(-1 == cerror_inject_load_config(pszPath));
+        cerror_inject_clear_rules();
+    }
+    remove(pszPath);
+    TEST_CHECK(-1 == cerror_inject_load_config(pszPath));
+}
+
+/**
+ * @brief Each point counts its calls and injections
+ */
+static void testCounters(void)
+{
+    CErrorInjectRule       stRule;
+    CErrorInjectPointStats aStats[4];
+    uint32_t               uPoints;
+    uint32_t               i;
+
+    TEST_CHECK(1 == cerror_inject_parse_rule("component=0x6F every=4", &stRule));
+    TEST_CHECK(1 == cerror_inject_add_rule(&stRule));
+    cerror_inject_enable(1);
+    (void)failedReads();
+    (void)writeBlock();
+    cerror_inject_enable(0);
+
+    uPoints = cerror_inject_get_points(aStats, 4);
+    TEST_CHECK(2u == uPoints);
+    for (i = 0; i < uPoints && i < 4; ++i)
+    {
+        if (g_ullRead == aStats[i].ullError)
+        {
+            TEST_CHECK(TEST_CALLS == aStats[i].ullCalls);
+            TEST_CHECK(TEST_CALLS / 4 == aStats[i].ullInjected);
+        }
+        else
+        {
+            TEST_CHECK(g_ullWrite == aStats[i].ullError);
+            TEST_CHECK(1u == aStats[i].ullCalls);
+            TEST_CHECK(0u == aStats[i].ullInjected);
+        }
+    }
+    resetRules();
+}
+
+int main(void)
+{
+    testSelection();
+    testSchedule();
+    testSeed();
+    testParse();
+    testConfig();
+    testCounters();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,182 @@
+/**
+ * @file test_latency.c
+ * @brief Latency histograms: per-component recording, totals of exited threads, percentiles and reset
+ *
+ * Built with CERROR_ENABLE_LATENCY_HISTOGRAM.
+ */
+
+#include "test_common.h"
+
+#include <c-error/latency.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#define TEST_SNAPSHOT_MAX (CERROR_LATENCY_MAX_COMPONENTS + 8u)
+
+static uint64_t componentCode(uint16_t uComponent)
+{
+    return MAKE_ERROR_CODE(0x01, uComponent, CERROR_UNAVAILABLE, 0x0001);
+}
+
+static CErrorLatencyHistogram g_aSnapshot[TEST_SNAPSHOT_MAX];
+
+/**
+ * @brief Snapshot entry of a component (NULL if it has no calls)
+ */
+static const CErrorLatencyHistogram* findComponent(uint32_t uCount, uint32_t uComponentId)
+{
+    uint32_t i;
+
+    for (i = 0; i < uCount && i < TEST_SNAPSHOT_MAX; ++i)
+    {
+        if (uComponentId == g_aSnapshot[i].uComponentId)
+        {
+            return &g_aSnapshot[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Setters with info (and wrapping) are recorded per component, plain sets are not
+ */
+static void testRecord(void)
+{
+    const CErrorLatencyHistogram* pEntry;
+    uint32_t                      uCount;
+    int                           i;
+
+    for (i = 0; i < 10; ++i)
+    {
+        cerror_set_last_info(componentCode(0x73), "constant");
+    }
+    for (i = 0; i < 5; ++i)
+    {
+        cerror_set_last_info_copy(componentCode(0x72), "copied");
+    }
+    cerror_set_last(componentCode(0x74));
+
+    /* Wrapping stores info like cerror_set_last_info() and is timed as well */
+    cerror_wrap_last(componentCode(0x72), "wrapped");
+
+    uCount = cerror_latency_snapshot(g_aSnapshot, TEST_SNAPSHOT_MAX);
+    TEST_CHECK(2u == uCount);
+    TEST_CHECK(0x72u == g_aSnapshot[0].uComponentId && 0x73u == g_aSnapshot[1].uComponentId);
+    TEST_CHECK(6u == g_aSnapshot[0].ullCount);
+    TEST_CHECK(10u == g_aSnapshot[1].ullCount);
+    TEST_CHECK(NULL == findComponent(uCount, 0x74));
+
+    pEntry = &g_aSnapshot[1];
+    TEST_CHECK(pEntry->dNsPerTick > 0.0);
+    TEST_CHECK(pEntry->ullSumTicks >= pEntry->ullMaxTicks);
+    TEST_CHECK(cerror_latency_percentile_ns(pEntry, 50.0) <= cerror_latency_percentile_ns(pEntry, 100.0));
+
+    /* A short output array still reports the number of components */
+    TEST_CHECK(2u == cerror_latency_snapshot(NULL, 0));
+}
+
+/**
+ * @brief Components beyond a thread's limit are collected under CERROR_LATENCY_OTHER
+ */
+static void testOther(void)
+{
+    const CErrorLatencyHistogram* pOther;
+    uint32_t                      uCount;
+    uint16_t                      uComponent;
+
+    for (uComponent = 0x80; uComponent < 0x80 + CERROR_LATENCY_MAX_COMPONENTS; ++uComponent)
+    {
+        cerror_set_last_info(componentCode(uComponent), "spread");
+    }
+
+    /* Two components are already tracked and the last histogram is OTHER's */
+    uCount = cerror_latency_snapshot(g_aSnapshot, TEST_SNAPSHOT_MAX);
+    pOther = findComponent(uCount, CERROR_LATENCY_OTHER);
+    TEST_CHECK(NULL != pOther && 3u == pOther->ullCount);
+    TEST_CHECK(CERROR_LATENCY_MAX_COMPONENTS == uCount);
+}
+
+static void* workerThread(void* pArg)
+{
+    int i;
+
+    (void)pArg;
+    for (i = 0; i < 7; ++i)
+    {
+        cerror_set_last_info(componentCode(0x73), "from a worker");
+    }
+    cerror_cleanup_thread_local_buffer();
+    return NULL;
+}
+
+/**
+ * @brief Counts of a thread that cleaned up before exiting stay in the totals
+ */
+static void testExitedThread(void)
+{
+    const CErrorLatencyHistogram* pEntry;
+    pthread_t                     thread;
+    uint32_t                      uCount;
+
+    TEST_CHECK(0 == pthread_create(&thread, NULL, workerThread, NULL));
+    TEST_CHECK(0 == pthread_join(thread, NULL));
+
+    uCount = cerror_latency_snapshot(g_aSnapshot, TEST_SNAPSHOT_MAX);
+    pEntry = findComponent(uCount, 0x73);
+    TEST_CHECK(NULL != pEntry && 17u == pEntry->ullCount);
+}
+
+static void testReset(void)
+{
+    cerror_latency_reset();
+    TEST_CHECK(0u == cerror_latency_snapshot(g_aSnapshot, TEST_SNAPSHOT_MAX));
+
+    cerror_set_last_info(componentCode(0x72), "after reset");
+    TEST_CHECK(1u == cerror_latency_snapshot(g_aSnapshot, TEST_SNAPSHOT_MAX));
+    TEST_CHECK(1u == g_aSnapshot[0].ullCount);
+}
+
+/**
+ * @brief Percentiles from known buckets: bucket upper bound capped at the maximum, scaled to ns
+ */
+static void testPercentile(void)
+{
+    CErrorLatencyHistogram histogram;
+    CErrorLatencyHistogram merged;
+
+    memset(&histogram, 0, sizeof(histogram));
+    TEST_CHECK(0u == cerror_latency_percentile_ns(&histogram, 50.0));
+
+    /* 90 calls of 5 ticks, 10 of 1000 ticks (bucket 6 * 16 + 15, upper bound 1023) */
+    histogram.dNsPerTick = 2.0;
+    histogram.ullCount = 100;
+    histogram.ullSumTicks = 90 * 5 + 10 * 1000;
+    histogram.ullMaxTicks = 1000;
+    histogram.aBuckets[5] = 90;
+    histogram.aBuckets[6 * CERROR_LATENCY_SUB_BUCKETS + 15] = 10;
+
+    TEST_CHECK(10u == cerror_latency_percentile_ns(&histogram, 50.0));
+    TEST_CHECK(10u == cerror_latency_percentile_ns(&histogram, 90.0));
+    TEST_CHECK(2000u == cerror_latency_percentile_ns(&histogram, 99.0));
+    TEST_CHECK(2000u == cerror_latency_percentile_ns(&histogram, 150.0));
+
+    memset(&merged, 0, sizeof(merged));
+    cerror_latency_merge(&merged, &histogram);
+    cerror_latency_merge(&merged, &histogram);
+    TEST_CHECK(200u == merged.ullCount);
+    TEST_CHECK(1000u == merged.ullMaxTicks);
+    TEST_CHECK(180u == merged.aBuckets[5]);
+}
+
+int main(void)
+{
+    testRecord();
+    testOther();
+    testExitedThread();
+    testReset();
+    testPercentile();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_memory_stats.c
+ * @brief Memory accounting: per-context counters, folding at cleanup and the exporter
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+#include <c-error/payload.h>
+
+#include <pthread.h>
+#include <string.h>
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x75, CERROR_RESOURCE_EXHAUSTED, 0x0001);
+
+static char g_szInfo[1024];
+
+/**
+ * @brief Copy a message of nLength bytes
+ */
+static void copyInfo(size_t nLength)
+{
+    memset(g_szInfo, 'm', nLength);
+    g_szInfo[nLength] = '\0';
+    cerror_set_last_info_copy(g_ullCode, g_szInfo);
+}
+
+typedef struct ExportLog
+{
+    unsigned          uCalls;
+    CErrorMemoryStats stLast;
+} ExportLog;
+
+static void recordExport(const CErrorMemoryStats* pStats, void* pUserData)
+{
+    ExportLog* const pLog = (ExportLog*)pUserData;
+
+    pLog->uCalls++;
+    pLog->stLast = *pStats;
+}
+
+/**
+ * @brief Buffer growth, payload spill and copied bytes are counted on the context
+ */
+static void testThreadCounters(void)
+{
+    CErrorMemoryStats stStats;
+    CErrorMemoryStats stProcess;
+    unsigned char     aBlob[CERROR_PAYLOAD_INLINE_CAPACITY * 2];
+
+    cerror_get_thread_memory_stats(&stStats);
+    TEST_CHECK(0u == stStats.ullCurrentBytes && 0u == stStats.ullGrowEvents && 0u == stStats.ullBytesCopied);
+
+    copyInfo(200);
+    cerror_get_thread_memory_stats(&stStats);
+    TEST_CHECK(cerror_ctx()->nBufferCapacity == stStats.ullCurrentBytes);
+    TEST_CHECK(1u == stStats.ullGrowEvents);
+    TEST_CHECK(200u == stStats.ullBytesCopied);
+
+    /* Less than CERROR_MEMORY_PUBLISH_BYTES held: not in the process-wide count yet */
+    cerror_get_memory_stats(&stProcess);
+    TEST_CHECK(0u == stProcess.ullCurrentBytes);
+
+    copyInfo(1000);
+    copyInfo(10);
+    cerror_get_thread_memory_stats(&stStats);
+    TEST_CHECK(cerror_ctx()->nBufferCapacity == stStats.ullCurrentBytes);
+    TEST_CHECK(2u == stStats.ullGrowEvents);
+    TEST_CHECK(1210u == stStats.ullBytesCopied);
+    TEST_CHECK(stStats.ullPeakBytes >= stStats.ullCurrentBytes);
+
+    /* A payload larger than the in-context area spills to the heap */
+    memset(aBlob, 0xAB, sizeof(aBlob));
+    TEST_CHECK(1 == cerror_payload_add_bytes("blob", aBlob, sizeof(aBlob)));
+    cerror_get_thread_memory_stats(&stStats);
+    TEST_CHECK(cerror_ctx()->nBufferCapacity + cerror_ctx()->nPayloadCapacity == stStats.ullCurrentBytes);
+    TEST_CHECK(3u == stStats.ullGrowEvents);
+}
+
+/**
+ * @brief Cleanup frees the buffers, folds the counters and calls the exporter
+ */
+static void testFold(void)
+{
+    CErrorMemoryStats stThread;
+    CErrorMemoryStats stBefore;
+    CErrorMemoryStats stProcess;
+    ExportLog         log;
+
+    memset(&log, 0, sizeof(log));
+    cerror_get_thread_memory_stats(&stThread);
+    cerror_get_memory_stats(&stBefore);
+    cerror_set_memory_exporter(recordExport, &log);
+
+    cerror_cleanup_thread_local_buffer();
+    TEST_CHECK(1u == log.uCalls);
+    cerror_get_memory_stats(&stProcess);
+    TEST_CHECK(0 == memcmp(&stProcess, &log.stLast, sizeof(stProcess)));
+    TEST_CHECK(0u == stProcess.ullCurrentBytes);
+    TEST_CHECK(stProcess.ullPeakBytes >= stThread.ullPeakBytes);
+    TEST_CHECK(stBefore.ullGrowEvents + stThread.ullGrowEvents == stProcess.ullGrowEvents);
+    TEST_CHECK(stBefore.ullBytesCopied + stThread.ullBytesCopied == stProcess.ullBytesCopied);
+
+    cerror_get_thread_memory_stats(&stThread);
+    TEST_CHECK(0u == stThread.ullCurrentBytes && 0u == stThread.ullGrowEvents && 0u == stThread.ullBytesCopied);
+
+    cerror_export_memory_stats();
+    TEST_CHECK(2u == log.uCalls);
+    cerror_set_memory_exporter(NULL, NULL);
+    cerror_export_memory_stats();
+    TEST_CHECK(2u == log.uCalls);
+}
+
+static char g_szLong[CERROR_MEMORY_PUBLISH_BYTES + 1];
+
+/**
+ * @brief A thread holding CERROR_MEMORY_PUBLISH_BYTES or more publishes its bytes
+ */
+static void testPublish(void)
+{
+    CErrorMemoryStats stBefore;
+    CErrorMemoryStats stThread;
+    CErrorMemoryStats stProcess;
+
+    cerror_get_memory_stats(&stBefore);
+    memset(g_szLong, 'p', sizeof(g_szLong) - 1);
+    cerror_set_last_info_copy(g_ullCode, g_szLong);
+
+    cerror_get_thread_memory_stats(&stThread);
+    cerror_get_memory_stats(&stProcess);
+    TEST_CHECK(stThread.ullCurrentBytes >= CERROR_MEMORY_PUBLISH_BYTES);
+    TEST_CHECK(stBefore.ullCurrentBytes + stThread.ullCurrentBytes == stProcess.ullCurrentBytes);
+    TEST_CHECK(stProcess.ullPeakBytes >= stProcess.ullCurrentBytes);
+
+    cerror_cleanup_thread_local_buffer();
+    cerror_get_memory_stats(&stProcess);
+    TEST_CHECK(stBefore.ullCurrentBytes == stProcess.ullCurrentBytes);
+}
+
+static void* workerThread(void* pArg)
+{
+    (void)pArg;
+    copyInfo(300);
+    cerror_cleanup_thread_local_buffer();
+    return NULL;
+}
+
+/**
+ * @brief Counters of other threads arrive with their cleanup
+ */
+static void testOtherThread(void)
+{
+    CErrorMemoryStats stBefore;
+    CErrorMemoryStats stAfter;
+    pthread_t         thread;
+
+    cerror_get_memory_stats(&stBefore);
+    TEST_CHECK(0 == pthread_create(&thread, NULL, workerThread, NULL));
+    TEST_CHECK(0 == pthread_join(thread, NULL));
+    cerror_get_memory_stats(&stAfter);
+
+    TEST_CHECK(stBefore.ullGrowEvents + 1u == stAfter.ullGrowEvents);
+    TEST_CHECK(stBefore.ullBytesCopied + 300u == stAfter.ullBytesCopied);
+    TEST_CHECK(0u == stAfter.ullCurrentBytes);
+}
+
+int main(void)
+{
+    testThreadCounters();
+    testFold();
+    testPublish();
+    testOtherThread();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,145 @@
+/**
+ * @file test_observer.c
+ * @brief Observer hooks: what is reported, callsites, removal and reentrancy
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <string.h>
+
+typedef struct ObservedErrors
+{
+    unsigned uCalls;
+    uint64_t ullLastError;
+    char     szLastInfo[64];
+    int      nLastLine;     /**< Line of the last callsite (0 if none) */
+} ObservedErrors;
+
+static void recordObserver(uint64_t ullError, const char* pszInfo, const CErrorCallsite* pSite, void* pUserData)
+{
+    ObservedErrors* const pObserved = (ObservedErrors*)pUserData;
+
+    pObserved->uCalls++;
+    pObserved->ullLastError = ullError;
+    strncpy(pObserved->szLastInfo, pszInfo, sizeof(pObserved->szLastInfo) - 1);
+    pObserved->szLastInfo[sizeof(pObserved->szLastInfo) - 1] = '\0';
+    pObserved->nLastLine = (NULL != pSite) ? pSite->nLine : 0;
+}
+
+/** Sets an error itself: must not be reported again (no recursion) */
+static void settingObserver(uint64_t ullError, const char* pszInfo, const CErrorCallsite* pSite, void* pUserData)
+{
+    (void)ullError;
+    (void)pszInfo;
+    (void)pSite;
+    ++*(unsigned*)pUserData;
+    cerror_set_last_info(MAKE_ERROR_CODE(0x01, 0x50, CERROR_INTERNAL, 0x0099), "set by an observer");
+}
+
+/** Copies info longer than the thread's buffer (would reallocate it) and clears */
+static void growingObserver(uint64_t ullError, const char* pszInfo, const CErrorCallsite* pSite, void* pUserData)
+{
+    char szLong[1024];
+
+    (void)ullError;
+    (void)pszInfo;
+    (void)pSite;
+    (void)pUserData;
+    memset(szLong, 'g', sizeof(szLong) - 1);
+    szLong[sizeof(szLong) - 1] = '\0';
+    cerror_set_last_info_copy(MAKE_ERROR_CODE(0x01, 0x50, CERROR_INTERNAL, 0x0098), szLong);
+    cerror_clear_last();
+}
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x50, CERROR_UNAVAILABLE, 0x0001);
+
+static void testReported(void)
+{
+    ObservedErrors stObserved;
+    int            nLine;
+
+    memset(&stObserved, 0, sizeof(stObserved));
+    TEST_CHECK(cerror_add_observer(recordObserver, &stObserved));
+
+    /* Info is in place when the observer runs */
+    cerror_set_last_info_copy(g_ullCode, "copied");
+    TEST_CHECK(1u == stObserved.uCalls);
+    TEST_CHECK(g_ullCode == stObserved.ullLastError);
+    TEST_CHECK(0 == strcmp("copied", stObserved.szLastInfo));
+    TEST_CHECK(0 == stObserved.nLastLine);
+
+    nLine = __LINE__ + 1;
+    CERROR_SET_LAST_INFO(g_ullCode, "with callsite");
+    TEST_CHECK(2u == stObserved.uCalls);
+    TEST_CHECK(nLine == stObserved.nLastLine);
+
+    cerror_wrap_last(MAKE_ERROR_CODE(0x01, 0x51, CERROR_UNAVAILABLE, 0x0002), "wrapped");
+    TEST_CHECK(3u == stObserved.uCalls);
+    TEST_CHECK(0 == strcmp("wrapped", stObserved.szLastInfo));
+
+    /* Clearing is not an error */
+    cerror_clear_last();
+    TEST_CHECK(3u == stObserved.uCalls);
+
+    TEST_CHECK(cerror_remove_observer(recordObserver, &stObserved));
+    TEST_CHECK(!cerror_remove_observer(recordObserver, &stObserved));
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(3u == stObserved.uCalls);
+}
+
+static void testReentrant(void)
+{
+    ObservedErrors stObserved;
+    unsigned       uSettingCalls = 0;
+
+    memset(&stObserved, 0, sizeof(stObserved));
+    TEST_CHECK(cerror_add_observer(settingObserver, &uSettingCalls));
+    TEST_CHECK(cerror_add_observer(recordObserver, &stObserved));
+
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(1u == uSettingCalls);
+    TEST_CHECK(1u == stObserved.uCalls);
+    TEST_CHECK(g_ullCode == stObserved.ullLastError);
+
+    /* The observer's set was ignored: the caller's error is intact */
+    TEST_CHECK(g_ullCode == cerror_get_last());
+
+    TEST_CHECK(cerror_remove_observer(settingObserver, &uSettingCalls));
+    TEST_CHECK(cerror_remove_observer(recordObserver, &stObserved));
+}
+
+/**
+ * @brief An observer that copies a long info cannot free the info later observers read
+ */
+static void testGrowingObserver(void)
+{
+    ObservedErrors stObserved;
+
+    memset(&stObserved, 0, sizeof(stObserved));
+    TEST_CHECK(cerror_add_observer(growingObserver, NULL));
+    TEST_CHECK(cerror_add_observer(recordObserver, &stObserved));
+
+    cerror_set_last_info_copy(g_ullCode, "short copied info");
+    TEST_CHECK(1u == stObserved.uCalls);
+    TEST_CHECK(g_ullCode == stObserved.ullLastError);
+    TEST_CHECK(0 == strcmp("short copied info", stObserved.szLastInfo));
+    TEST_CHECK(g_ullCode == cerror_get_last());
+    TEST_CHECK(0 == strcmp("short copied info", cerror_get_last_info()));
+
+    TEST_CHECK(cerror_remove_observer(growingObserver, NULL));
+    TEST_CHECK(cerror_remove_observer(recordObserver, &stObserved));
+}
+
+int main(void)
+{
+    testReported();
+    testReentrant();
+    testGrowingObserver();
+
+    /* Quiescent: no other thread is setting errors */
+    cerror_reclaim_observers();
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test_oom_copy.c
+ * @brief Copies under allocation failure keep the new code with a prefix of its own message
+ *
+ * Allocator hooks fail on demand. A failed grow must truncate the new
+ * message into the existing buffer (or the in-context emergency buffer when
+ * there is none) and flag it, never leave the previous message in place.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <string.h>
+
+static int g_bFailAllocations = 0;
+
+static void* failingRealloc(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData)
+{
+    (void)nOldSize;
+    (void)pUserData;
+    return g_bFailAllocations ? NULL : realloc(pBlock, nNewSize);
+}
+
+static void failingFree(void* pBlock, size_t nSize, void* pUserData)
+{
+    (void)nSize;
+    (void)pUserData;
+    free(pBlock);
+}
+
+static const uint64_t g_ullFirst = MAKE_ERROR_CODE(0x01, 0x60, CERROR_UNAVAILABLE, 0x0001);
+static const uint64_t g_ullSecond = MAKE_ERROR_CODE(0x01, 0x60, CERROR_RESOURCE_EXHAUSTED, 0x0002);
+
+/**
+ * @brief No buffer yet: the emergency buffer takes the start of the message
+ */
+static void testEmergencyBuffer(const char* pszLong)
+{
+    const char* pszInfo;
+
+    g_bFailAllocations = 1;
+    cerror_set_last_info_copy(g_ullFirst, pszLong);
+    g_bFailAllocations = 0;
+
+    pszInfo = cerror_get_last_info();
+    TEST_CHECK(g_ullFirst == cerror_get_last());
+    TEST_CHECK(cerror_is_last_info_truncated());
+    TEST_CHECK(strlen(pszInfo) == ERROR_INFO_INLINE_CAPACITY - 1);
+    TEST_CHECK(0 == strncmp(pszLong, pszInfo, strlen(pszInfo)));
+
+    /* A short message afterwards is whole again */
+    cerror_set_last_info_copy(g_ullFirst, "fits");
+    TEST_CHECK(!cerror_is_last_info_truncated());
+    TEST_CHECK(0 == strcmp("fits", cerror_get_last_info()));
+}
+
+/**
+ * @brief A failed grow truncates into the existing buffer, not into the old message
+ */
+static void testExistingBuffer(const char* pszLong)
+{
+    const char* pszInfo;
+
+    cerror_set_last_info_copy(g_ullFirst, "previous message");
+    TEST_CHECK(0 == strcmp("previous message", cerror_get_last_info()));
+
+    g_bFailAllocations = 1;
+    cerror_set_last_info_copy(g_ullSecond, pszLong);
+    g_bFailAllocations = 0;
+
+    pszInfo = cerror_get_last_info();
+    TEST_CHECK(g_ullSecond == cerror_get_last());
+    TEST_CHECK(cerror_is_last_info_truncated());
+    TEST_CHECK(strlen(pszInfo) > 0u);
+    TEST_CHECK(strlen(pszInfo) < strlen(pszLong));
+    TEST_CHECK(0 == strncmp(pszLong, pszInfo, strlen(pszInfo)));
+
+    cerror_clear_last();
+    TEST_CHECK(!cerror_is_last_info_truncated());
+}
+
+int main(void)
+{
+    char szLong[4096];
+
+    memset(szLong, 'm', sizeof(szLong) - 1);
+    szLong[sizeof(szLong) - 1] = '\0';
+    TEST_CHECK(cerror_set_allocator(failingRealloc, failingFree, NULL));
+
+    testEmergencyBuffer(szLong);
+    testExistingBuffer(szLong);
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,183 @@
+/**
+ * @file test_payload.c
+ * @brief Structured payload: typed fields, iteration, heap spill, rendering, lifetime and edge cases
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+#include <c-error/payload.h>
+
+#include <math.h>
+#include <string.h>
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x64, CERROR_INVALID_ARGUMENT, 0x0001);
+
+static int keyIs(const CErrorPayloadField* pField, const char* pszKey)
+{
+    return strlen(pszKey) == pField->nKeyLength && 0 == memcmp(pszKey, pField->pKey, pField->nKeyLength);
+}
+
+/**
+ * @brief Fields come back in order with their types and values
+ */
+static void testTypedFields(void)
+{
+    const unsigned char aRaw[3] = { 0x01, 0xAB, 0xFF };
+    CErrorPayloadIter   stIter;
+    CErrorPayloadField  stField;
+
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(!cerror_has_payload());
+    TEST_CHECK(cerror_payload_add_int("n", -7));
+    TEST_CHECK(cerror_payload_add_double("ratio", 0.5));
+    TEST_CHECK(cerror_payload_add_string("user", "alice"));
+    TEST_CHECK(cerror_payload_add_bytes("raw", aRaw, sizeof(aRaw)));
+    TEST_CHECK(cerror_has_payload());
+
+    cerror_payload_iter_init(&stIter);
+    TEST_CHECK(cerror_payload_next(&stIter, &stField));
+    TEST_CHECK(CERROR_PAYLOAD_INT == stField.eType && keyIs(&stField, "n"));
+    TEST_CHECK(-7 == cerror_payload_field_int(&stField));
+    TEST_CHECK(cerror_payload_next(&stIter, &stField));
+    TEST_CHECK(CERROR_PAYLOAD_DOUBLE == stField.eType && keyIs(&stField, "ratio"));
+    TEST_CHECK(0.5 == cerror_payload_field_double(&stField));
+    TEST_CHECK(cerror_payload_next(&stIter, &stField));
+    TEST_CHECK(CERROR_PAYLOAD_STRING == stField.eType && keyIs(&stField, "user"));
+    TEST_CHECK(5u == stField.nValueLength && 0 == memcmp("alice", stField.pValue, 5));
+    TEST_CHECK(cerror_payload_next(&stIter, &stField));
+    TEST_CHECK(CERROR_PAYLOAD_BYTES == stField.eType && keyIs(&stField, "raw"));
+    TEST_CHECK(sizeof(aRaw) == stField.nValueLength && 0 == memcmp(aRaw, stField.pValue, sizeof(aRaw)));
+    TEST_CHECK(!cerror_payload_next(&stIter, &stField));
+
+    /* Integer accessor on a non-integer field */
+    TEST_CHECK(0 == cerror_payload_field_int(&stField));
+}
+
+static void testRendering(void)
+{
+    const unsigned char aRaw[3] = { 0x01, 0xAB, 0xFF };
+    char                szText[128];
+    char                szSmall[8];
+
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(cerror_payload_add_int("n", -7));
+    TEST_CHECK(cerror_payload_add_double("bad", NAN));
+    TEST_CHECK(cerror_payload_add_bytes("raw", aRaw, sizeof(aRaw)));
+    TEST_CHECK(cerror_payload_add_string("q", "say \"hi\""));
+
+    TEST_CHECK(34u == cerror_payload_render_text(szText, sizeof(szText)));
+    TEST_CHECK(0 == strcmp("n=-7 bad=nan raw=01abff q=say \"hi\"", szText));
+    TEST_CHECK(51u == cerror_payload_render_json(szText, sizeof(szText)));
+    TEST_CHECK(0 == strcmp("{\"n\":-7,\"bad\":null,\"raw\":\"01abff\",\"q\":\"say \\\"hi\\\"\"}", szText));
+
+    /* snprintf semantics: the full length is returned, the output is cut and terminated */
+    TEST_CHECK(51u == cerror_payload_render_json(szSmall, sizeof(szSmall)));
+    TEST_CHECK(sizeof(szSmall) - 1 == strlen(szSmall));
+}
+
+/**
+ * @brief Fields beyond the in-context area spill to the heap and are released
+ */
+static void testSpill(void)
+{
+    CErrorMemoryStats  stStats;
+    CErrorPayloadIter  stIter;
+    CErrorPayloadField stField;
+    char               szKey[8];
+    int                nFields = 0;
+    int                i;
+
+    cerror_set_last(g_ullCode);
+    for (i = 0; i < 20; ++i)
+    {
+        szKey[0] = 'k';
+        szKey[1] = (char)('a' + i);
+        szKey[2] = '\0';
+        TEST_CHECK(cerror_payload_add_int(szKey, i));
+    }
+    cerror_get_thread_memory_stats(&stStats);
+    TEST_CHECK(stStats.ullCurrentBytes > 0u);
+
+    cerror_payload_iter_init(&stIter);
+    while (cerror_payload_next(&stIter, &stField))
+    {
+        TEST_CHECK(nFields == cerror_payload_field_int(&stField));
+        nFields++;
+    }
+    TEST_CHECK(20 == nFields);
+
+    cerror_cleanup_thread_local_buffer();
+    cerror_get_thread_memory_stats(&stStats);
+    TEST_CHECK(0u == stStats.ullCurrentBytes);
+}
+
+/**
+ * @brief The payload belongs to the current error
+ */
+static void testLifetime(void)
+{
+    char szKey[CERROR_PAYLOAD_MAX_KEY + 2];
+
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(cerror_payload_add_int("fd", 3));
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(!cerror_has_payload());
+
+    TEST_CHECK(cerror_payload_add_int("fd", 4));
+    cerror_clear_last();
+    TEST_CHECK(!cerror_has_payload());
+
+    /* Over-long keys are rejected */
+    memset(szKey, 'k', sizeof(szKey) - 1);
+    szKey[sizeof(szKey) - 1] = '\0';
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(!cerror_payload_add_int(szKey, 1));
+    TEST_CHECK(!cerror_has_payload());
+}
+
+/**
+ * @brief Without an error nothing is attached and the context stays clear
+ */
+static void testNoError(void)
+{
+    cerror_clear_last();
+    TEST_CHECK(!cerror_payload_add_int("orphan", 1));
+    TEST_CHECK(!cerror_has_payload());
+    TEST_CHECK(0u == cerror_ctx()->ullLastError);
+}
+
+/**
+ * @brief A NULL key and an empty blob are stored as empty (no memcpy from NULL)
+ */
+static void testEmptyKeyAndValue(void)
+{
+    CErrorPayloadIter  stIter;
+    CErrorPayloadField stField;
+
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(cerror_payload_add_int(NULL, 5));
+    TEST_CHECK(cerror_payload_add_bytes("empty", NULL, 0));
+    TEST_CHECK(!cerror_payload_add_bytes("missing", NULL, 4));
+
+    cerror_payload_iter_init(&stIter);
+    TEST_CHECK(cerror_payload_next(&stIter, &stField));
+    TEST_CHECK(0u == stField.nKeyLength);
+    TEST_CHECK(5 == cerror_payload_field_int(&stField));
+    TEST_CHECK(cerror_payload_next(&stIter, &stField));
+    TEST_CHECK(keyIs(&stField, "empty") && 0u == stField.nValueLength);
+    TEST_CHECK(!cerror_payload_next(&stIter, &stField));
+}
+
+int main(void)
+{
+    testTypedFields();
+    testRendering();
+    testSpill();
+    testLifetime();
+    testNoError();
+    testEmptyKeyAndValue();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_pool.c
+ * @brief Info buffer pool: reuse across threads, byte bound and no leaks
+ *
+ * Threads copy info of several size classes and release their buffer on
+ * exit. Released buffers must be handed to later threads, the pool must not
+ * hold more than its bound, and disabling it must return every byte to the
+ * allocator (checked with counting hooks), also while threads are releasing. Under CERROR_NO_HEAP every copy
+ * is truncated into the in-context buffer and the pool stays empty.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#define TEST_THREADS        8
+#define TEST_ROUNDS         50
+#define TEST_SETS           16
+#define TEST_MAX_BYTES_HELD 4096u
+
+static pthread_mutex_t g_stLiveLock = PTHREAD_MUTEX_INITIALIZER;
+static long long       g_llLiveBytes = 0;
+
+static void* countingRealloc(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData)
+{
+    void* const pNew = realloc(pBlock, nNewSize);
+
+    (void)pUserData;
+    if (NULL != pNew)
+    {
+        pthread_mutex_lock(&g_stLiveLock);
+        g_llLiveBytes += (long long)nNewSize - (long long)nOldSize;
+        pthread_mutex_unlock(&g_stLiveLock);
+    }
+    return pNew;
+}
+
+static void countingFree(void* pBlock, size_t nSize, void* pUserData)
+{
+    (void)pUserData;
+    free(pBlock);
+    pthread_mutex_lock(&g_stLiveLock);
+    g_llLiveBytes -= (long long)nSize;
+    pthread_mutex_unlock(&g_stLiveLock);
+}
+
+static char g_szInfo[1024];
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x30, CERROR_RESOURCE_EXHAUSTED, 0x0001);
+
+static void* copyThread(void* pArg)
+{
+    const size_t nFirst = (size_t)(uintptr_t)pArg;
+    size_t       i;
+
+    for (i = 0; i < TEST_SETS; ++i)
+    {
+        const size_t nLength = 100 + ((nFirst + i) * 61) % (sizeof(g_szInfo) - 100);
+
+        cerror_set_last_info_copy(g_ullCode, g_szInfo + sizeof(g_szInfo) - 1 - nLength);
+#if defined(CERROR_NO_HEAP)
+        if (!cerror_is_last_info_truncated() || strlen(cerror_get_last_info()) >= ERROR_INFO_INLINE_CAPACITY)
+        {
+            return (void*)1;
+        }
+#else
+        if (strlen(cerror_get_last_info()) != nLength)
+        {
+            return (void*)1;
+        }
+#endif
+    }
+    cerror_cleanup_thread_local_buffer();
+    return NULL;
+}
+
+static void runThread(size_t nFirst)
+{
+    pthread_t hThread;
+    void*     pResult = (void*)1;
+
+    TEST_CHECK(0 == pthread_create(&hThread, NULL, copyThread, (void*)(uintptr_t)nFirst));
+    TEST_CHECK(0 == pthread_join(hThread, &pResult));
+    TEST_CHECK(NULL == pResult);
+}
+
+/**
+ * @brief A buffer released by one thread serves the next one (no buffers at all without a heap)
+ */
+static void testReuse(void)
+{
+    CErrorPoolStats stBefore;
+    CErrorPoolStats stAfter;
+
+    cerror_pool_get_stats(&stBefore);
+    runThread(0);
+    runThread(0);
+    cerror_pool_get_stats(&stAfter);
+
+#if defined(CERROR_NO_HEAP)
+    TEST_CHECK(stAfter.ullReturned == stBefore.ullReturned);
+    TEST_CHECK(stAfter.ullHits == stBefore.ullHits);
+    TEST_CHECK(0u == stAfter.ullBuffersHeld);
+#else
+    TEST_CHECK(stAfter.ullReturned > stBefore.ullReturned);
+    TEST_CHECK(stAfter.ullHits > stBefore.ullHits);
+    TEST_CHECK(stAfter.ullBuffersHeld > 0u);
+#endif
+}
+
+/**
+ * @brief Concurrent release and reuse keep the bound and lose nothing
+ */
+static void testConcurrent(void)
+{
+    pthread_t       aThreads[TEST_THREADS];
+    void*           pResult;
+    CErrorPoolStats stStats;
+    size_t          nRound;
+    size_t          t;
+
+    for (nRound = 0; nRound < TEST_ROUNDS; ++nRound)
+    {
+        for (t = 0; t < TEST_THREADS; ++t)
+        {
+            TEST_CHECK(0 == pthread_create(&aThreads[t], NULL, copyThread, (void*)(uintptr_t)(nRound * TEST_THREADS + t)));
+        }
+        for (t = 0; t < TEST_THREADS; ++t)
+        {
+            pResult = (void*)1;
+            TEST_CHECK(0 == pthread_join(aThreads[t], &pResult));
+            TEST_CHECK(NULL == pResult);
+        }
+
+        cerror_pool_get_stats(&stStats);
+        TEST_CHECK(stStats.ullBytesHeld <= TEST_MAX_BYTES_HELD);
+    }
+}
+
+/**
+ * @brief A release racing with cerror_pool_disable() is never cached after the drain
+ */
+static void testDisableRace(void)
+{
+    pthread_t       aThreads[TEST_THREADS];
+    void*           pResult;
+    CErrorPoolStats stStats;
+    size_t          nRound;
+    size_t          t;
+
+    for (nRound = 0; nRound < TEST_ROUNDS; ++nRound)
+    {
+        cerror_pool_enable(TEST_MAX_BYTES_HELD);
+        for (t = 0; t < TEST_THREADS; ++t)
+        {
+            TEST_CHECK(0 == pthread_create(&aThreads[t], NULL, copyThread, (void*)(uintptr_t)(nRound + t)));
+        }
+        cerror_pool_disable();
+        for (t = 0; t < TEST_THREADS; ++t)
+        {
+            pResult = (void*)1;
+            TEST_CHECK(0 == pthread_join(aThreads[t], &pResult));
+            TEST_CHECK(NULL == pResult);
+        }
+
+        cerror_pool_get_stats(&stStats);
+        TEST_CHECK(0u == stStats.ullBuffersHeld);
+        TEST_CHECK(0u == stStats.ullBytesHeld);
+    }
+}
+
+int main(void)
+{
+    CErrorPoolStats stStats;
+
+    memset(g_szInfo, 'x', sizeof(g_szInfo) - 1);
+    TEST_CHECK(cerror_set_allocator(countingRealloc, countingFree, NULL));
+    cerror_pool_enable(TEST_MAX_BYTES_HELD);
+
+    testReuse();
+    testConcurrent();
+    testDisableRace();
+
+    cerror_pool_disable();
+    cerror_pool_get_stats(&stStats);
+    TEST_CHECK(0u == stStats.ullBytesHeld);
+    TEST_CHECK(0u == stStats.ullBuffersHeld);
+    TEST_CHECK(0 == g_llLiveBytes);
+    return TEST_RESULT();
+}
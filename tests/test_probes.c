@@ -0,0 +1,117 @@
+/**
+ * @file test_probes.c
+ * @brief USDT probes: the error path behaves the same and the notes are in the binary
+ *
+ * Built with CERROR_ENABLE_PROBES. On ELF targets with probe support the
+ * executable must carry a provider "cerror" note for each probe name.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+#include <c-error/probes.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x71, CERROR_INTERNAL, 0x0001);
+
+/**
+ * @brief Every probed path still sets, wraps, copies, grows and clears as without probes
+ */
+static void testBehaviour(void)
+{
+    char szLong[ERROR_INFO_INITIAL_CAPACITY * 4];
+
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(g_ullCode == cerror_get_last());
+
+    cerror_set_from_errno(0x01, 0x71, ENOENT);
+    TEST_CHECK(ENOENT == cerror_get_last_errno());
+
+    cerror_wrap_last(g_ullCode, "wrapped");
+    TEST_CHECK(1u == cerror_get_cause_count());
+
+    cerror_set_last_info(g_ullCode, "constant");
+    TEST_CHECK(0 == strcmp("constant", cerror_get_last_info()));
+
+    memset(szLong, 'p', sizeof(szLong) - 1);
+    szLong[sizeof(szLong) - 1] = '\0';
+    cerror_set_last_info_copy(g_ullCode, szLong);
+    TEST_CHECK(0 == strcmp(szLong, cerror_get_last_info()));
+
+    cerror_clear_last();
+    TEST_CHECK(0u == cerror_get_last());
+    cerror_clear_last();
+}
+
+#if defined(CERROR_ENABLE_PROBES) && (defined(CERROR_PROBES_SYS_SDT) || \
+    ((defined(__GNUC__) || defined(__clang__)) && defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__))))
+/**
+ * @brief Check that a note "cerror\0<name>\0" is in the image
+ */
+static int hasProbe(const char* pImage, size_t nSize, const char* pszName)
+{
+    char         szPattern[64];
+    const size_t nLength = (size_t)snprintf(szPattern, sizeof(szPattern), "cerror%c%s", '\0', pszName) + 1;
+    size_t       i;
+
+    for (i = 0; i + nLength <= nSize; ++i)
+    {
+        if (0 == memcmp(pImage + i, szPattern, nLength))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void testNotes(const char* pszExecutable)
+{
+    FILE* pFile = fopen(pszExecutable, "rb");
+    char* pImage;
+    long  lSize;
+
+    TEST_CHECK(NULL != pFile);
+    if (NULL == pFile)
+    {
+        return;
+    }
+    fseek(pFile, 0, SEEK_END);
+    lSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    pImage = (char*)malloc((size_t)lSize);
+    TEST_CHECK(NULL != pImage && (size_t)lSize == fread(pImage, 1, (size_t)lSize, pFile));
+    fclose(pFile);
+
+    if (NULL != pImage)
+    {
+        TEST_CHECK(hasProbe(pImage, (size_t)lSize, "set"));
+        TEST_CHECK(hasProbe(pImage, (size_t)lSize, "set_info"));
+        TEST_CHECK(hasProbe(pImage, (size_t)lSize, "set_info_copy"));
+        TEST_CHECK(hasProbe(pImage, (size_t)lSize, "info_grow"));
+        TEST_CHECK(hasProbe(pImage, (size_t)lSize, "clear"));
+        free(pImage);
+    }
+}
+#else
+static void testNotes(const char* pszExecutable)
+{
+    /* Probes compile to nothing here */
+    (void)pszExecutable;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    testBehaviour();
+    if (argc > 0)
+    {
+        testNotes(argv[0]);
+    }
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
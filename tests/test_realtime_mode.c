@@ -0,0 +1,187 @@
+/**
+ * @file test_realtime_mode.c
+ * @brief Fixed-capacity mode never reaches the allocator
+ *
+ * Counting allocator hooks are installed and the thread is switched to
+ * fixed-capacity mode; every info path (copy, payload, errno rendering,
+ * save/restore, cause chains, arena) must then leave the counter at zero.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+#include <c-error/payload.h>
+
+#include <errno.h>
+#include <string.h>
+
+static unsigned g_uAllocatorCalls = 0;
+
+static void* countingRealloc(void* pBlock, size_t nOldSize, size_t nNewSize, void* pUserData)
+{
+    (void)nOldSize;
+    (void)pUserData;
+    ++g_uAllocatorCalls;
+    return realloc(pBlock, nNewSize);
+}
+
+static void countingFree(void* pBlock, size_t nSize, void* pUserData)
+{
+    (void)nSize;
+    (void)pUserData;
+    ++g_uAllocatorCalls;
+    free(pBlock);
+}
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x10, CERROR_UNAVAILABLE, 0x0001);
+
+/**
+ * @brief Fill a buffer with two-byte UTF-8 characters (U+00E9)
+ */
+static void fillTwoByteText(char* pszText, size_t nSize)
+{
+    size_t i;
+
+    for (i = 0; i + 2 < nSize; i += 2)
+    {
+        pszText[i] = (char)0xC3;
+        pszText[i + 1] = (char)0xA9;
+    }
+    pszText[i] = '\0';
+}
+
+static void testCopy(const char* pszLong)
+{
+    cerror_set_last_info_copy(g_ullCode, "buffer underrun");
+    TEST_CHECK(0 == strcmp("buffer underrun", cerror_get_last_info()));
+    TEST_CHECK(!cerror_is_last_info_truncated());
+
+    /* Cut on a character boundary, never in the middle of one */
+    cerror_set_last_info_copy(g_ullCode, pszLong);
+    TEST_CHECK(cerror_is_last_info_truncated());
+    TEST_CHECK(strlen(cerror_get_last_info()) < ERROR_INFO_INLINE_CAPACITY);
+    TEST_CHECK(0 == strlen(cerror_get_last_info()) % 2);
+
+    cerror_set_last_info(g_ullCode, pszLong);
+    TEST_CHECK(cerror_get_last_info() == pszLong);
+}
+
+static void testPayload(void)
+{
+    unsigned char aBlob[2 * CERROR_PAYLOAD_INLINE_CAPACITY];
+    char          szText[256];
+
+    memset(aBlob, 0xAB, sizeof(aBlob));
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(cerror_payload_add_int("fd", 42));
+    TEST_CHECK(cerror_payload_add_string("op", "read"));
+
+    /* Would spill to the heap: rejected instead */
+    TEST_CHECK(!cerror_payload_add_bytes("blob", aBlob, sizeof(aBlob)));
+    TEST_CHECK(cerror_has_payload());
+
+    TEST_CHECK(13u == cerror_payload_render_text(szText, sizeof(szText)));
+    TEST_CHECK(0 == strcmp("fd=42 op=read", szText));
+    TEST_CHECK(21u == cerror_payload_render_json(szText, sizeof(szText)));
+    TEST_CHECK(0 == strcmp("{\"fd\":42,\"op\":\"read\"}", szText));
+}
+
+static void testErrno(void)
+{
+    cerror_set_from_errno(0x01, 0x10, ENOENT);
+    TEST_CHECK(CERROR_NOT_FOUND == cerror_get_last_status());
+    TEST_CHECK(ENOENT == cerror_get_last_errno());
+    TEST_CHECK('\0' != cerror_get_last_info()[0]);
+}
+
+static void testSaveRestore(const char* pszLong)
+{
+    CErrorSavedState stSaved;
+    char             szExpected[ERROR_INFO_INLINE_CAPACITY];
+
+    cerror_set_last_info_copy(g_ullCode, pszLong);
+    strcpy(szExpected, cerror_get_last_info());
+    cerror_save(&stSaved);
+
+    /* Cleanup code overwrites the in-context buffer */
+    cerror_set_last_info_copy(MAKE_ERROR_CODE(0x01, 0x10, CERROR_INTERNAL, 0x0002), "cleanup failed");
+    cerror_restore(&stSaved);
+    TEST_CHECK(g_ullCode == cerror_get_last());
+    TEST_CHECK(0 == strcmp(szExpected, cerror_get_last_info()));
+
+    cerror_save(&stSaved);
+    cerror_discard_saved(&stSaved);
+}
+
+static void testWrap(void)
+{
+    cerror_set_last_info_copy(g_ullCode, "connect refused");
+    cerror_wrap_last(MAKE_ERROR_CODE(0x01, 0x20, CERROR_UNAVAILABLE, 0x0003), "fetch failed");
+    TEST_CHECK(1u == cerror_get_cause_count());
+    TEST_CHECK(g_ullCode == cerror_get_root_cause());
+    TEST_CHECK(0 == strcmp("connect refused", cerror_get_root_cause_info()));
+    TEST_CHECK(0 == strcmp("fetch failed", cerror_get_last_info()));
+}
+
+static void testArena(const char* pszLong)
+{
+    char        aMemory[256];
+    CErrorArena stArena;
+
+    cerror_arena_init(&stArena, aMemory, sizeof(aMemory));
+    cerror_bind_arena(&stArena);
+    cerror_set_last_info_copy(g_ullCode, "from the arena");
+    TEST_CHECK(0 == strcmp("from the arena", cerror_get_last_info()));
+
+    /* Exhaust the arena: the in-context buffer takes over */
+    cerror_set_last_info_copy(g_ullCode, pszLong);
+    cerror_set_last_info_copy(g_ullCode, pszLong);
+    cerror_set_last_info_copy(g_ullCode, "after the arena");
+    TEST_CHECK(0 == strcmp("after the arena", cerror_get_last_info()));
+
+    cerror_arena_reset(&stArena);
+    cerror_bind_arena(NULL);
+}
+
+int main(void)
+{
+    char              szLong[4 * ERROR_INFO_INLINE_CAPACITY];
+    CErrorMemoryStats stStats;
+
+    fillTwoByteText(szLong, sizeof(szLong));
+    TEST_CHECK(cerror_set_allocator(countingRealloc, countingFree, NULL));
+
+    /* The hooks see the dynamic buffer outside the mode (CERROR_NO_HEAP: there is no outside) */
+    cerror_set_last_info_copy(g_ullCode, szLong);
+#if defined(CERROR_NO_HEAP)
+    TEST_CHECK(cerror_is_fixed_info_mode());
+    TEST_CHECK(cerror_is_last_info_truncated());
+    TEST_CHECK(0u == g_uAllocatorCalls);
+#else
+    TEST_CHECK(g_uAllocatorCalls > 0);
+#endif
+
+    cerror_set_fixed_info_mode(1);
+    TEST_CHECK(cerror_is_fixed_info_mode());
+    g_uAllocatorCalls = 0;
+
+    testCopy(szLong);
+    testPayload();
+    testErrno();
+    testSaveRestore(szLong);
+    testWrap();
+    testArena(szLong);
+
+    cerror_get_thread_memory_stats(&stStats);
+    TEST_CHECK(0u == stStats.ullCurrentBytes);
+    cerror_trim_thread_local_buffer();
+    cerror_clear_last();
+    TEST_CHECK(0u == g_uAllocatorCalls);
+
+    cerror_cleanup_thread_local_buffer();
+#if !defined(CERROR_ENABLE_LATENCY_HISTOGRAM)
+    /* Only the latency histograms allocated with the mode are freed here */
+    TEST_CHECK(0u == g_uAllocatorCalls);
+#endif
+    return TEST_RESULT();
+}
@@ -0,0 +1,174 @@
+/**
+ * @file test_reducer.c
+ * @brief Parallel error reduction: policies, dropped errors and concurrency
+ *
+ * Contributions are made from the main thread in a chosen order (the winner
+ * must not depend on it) and from concurrent workers (TSan-friendly: the
+ * reducer is the only shared state).
+ */
+
+#include "test_common.h"
+
+#include <c-error/reduce.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#define TEST_THREADS          8
+#define TEST_ITEMS_PER_THREAD 1000
+
+static uint64_t testCode(CErrorStatusCode eStatus, uint16_t uCode)
+{
+    return MAKE_ERROR_CODE(0x01, 0x40, eStatus, uCode);
+}
+
+static void contribute(CErrorReducer* pReducer, uint64_t ullError, const char* pszInfo, uint64_t ullIndex)
+{
+    cerror_set_last_info_copy(ullError, pszInfo);
+    TEST_CHECK(cerror_reducer_contribute(pReducer, ullIndex));
+    TEST_CHECK(0u == cerror_get_last());
+}
+
+/**
+ * @brief The lowest index wins even when it arrives last
+ */
+static void testFirstByIndex(void)
+{
+    CErrorReducer stReducer;
+
+    cerror_reducer_init(&stReducer, CERROR_REDUCE_FIRST_BY_INDEX, NULL, 0);
+    contribute(&stReducer, testCode(CERROR_INTERNAL, 10), "item 10", 10);
+    contribute(&stReducer, testCode(CERROR_INTERNAL, 9), "item 9", 9);
+    contribute(&stReducer, testCode(CERROR_INTERNAL, 8), "item 8", 8);
+    TEST_CHECK(!cerror_reducer_contribute(&stReducer, 1));
+
+    TEST_CHECK(3u == cerror_reducer_finish(&stReducer));
+    TEST_CHECK(testCode(CERROR_INTERNAL, 8) == cerror_get_last());
+    TEST_CHECK(0 == strcmp("item 8", cerror_get_last_info()));
+    TEST_CHECK(1u == cerror_reducer_entry_count(&stReducer));
+    TEST_CHECK(8u == cerror_reducer_entry(&stReducer, 0)->ullIndex);
+    TEST_CHECK(0u == cerror_reducer_dropped(&stReducer));
+}
+
+/**
+ * @brief The most severe status wins, the lowest index breaks ties
+ */
+static void testMostSevere(void)
+{
+    CErrorReducer stReducer;
+
+    cerror_reducer_init(&stReducer, CERROR_REDUCE_MOST_SEVERE, NULL, 0);
+    contribute(&stReducer, testCode(CERROR_NOT_FOUND, 1), "not found", 1);
+    contribute(&stReducer, testCode(CERROR_DATA_LOSS, 7), "data loss 7", 7);
+    contribute(&stReducer, testCode(CERROR_DATA_LOSS, 5), "data loss 5", 5);
+    contribute(&stReducer, testCode(CERROR_UNAVAILABLE, 2), "unavailable", 2);
+
+    TEST_CHECK(4u == cerror_reducer_finish(&stReducer));
+    TEST_CHECK(testCode(CERROR_DATA_LOSS, 5) == cerror_get_last());
+    TEST_CHECK(0 == strcmp("data loss 5", cerror_get_last_info()));
+}
+
+/**
+ * @brief Errors beyond the entries are counted as dropped, kept ones are sorted
+ */
+static void testCollectAll(void)
+{
+    CErrorReduceEntry aEntries[2];
+    CErrorReducer     stReducer;
+
+    cerror_reducer_init(&stReducer, CERROR_REDUCE_COLLECT_ALL, aEntries, 2);
+    contribute(&stReducer, testCode(CERROR_ABORTED, 3), "item 3", 3);
+    contribute(&stReducer, testCode(CERROR_ABORTED, 1), "item 1", 1);
+    contribute(&stReducer, testCode(CERROR_ABORTED, 2), "item 2", 2);
+
+    TEST_CHECK(3u == cerror_reducer_finish(&stReducer));
+    TEST_CHECK(1u == cerror_reducer_dropped(&stReducer));
+    TEST_CHECK(2u == cerror_reducer_entry_count(&stReducer));
+    TEST_CHECK(1u == cerror_reducer_entry(&stReducer, 0)->ullIndex);
+    TEST_CHECK(3u == cerror_reducer_entry(&stReducer, 1)->ullIndex);
+    TEST_CHECK(NULL == cerror_reducer_entry(&stReducer, 2));
+    TEST_CHECK(testCode(CERROR_ABORTED, 1) == cerror_get_last());
+}
+
+/**
+ * @brief Nothing contributed: finish clears the joining context
+ */
+static void testNoError(void)
+{
+    CErrorReducer stReducer;
+
+    cerror_reducer_init(&stReducer, CERROR_REDUCE_FIRST_BY_INDEX, NULL, 0);
+    cerror_set_last(testCode(CERROR_INTERNAL, 1));
+    TEST_CHECK(0u == cerror_reducer_finish(&stReducer));
+    TEST_CHECK(0u == cerror_get_last());
+    TEST_CHECK(0u == cerror_reducer_entry_count(&stReducer));
+}
+
+typedef struct ReduceWorker
+{
+    CErrorReducer* pReducer;
+    uint64_t       ullFirst;
+} ReduceWorker;
+
+/**
+ * @brief Fail every third item of an interleaved slice (items first, first + THREADS, ...)
+ */
+static void* reduceThread(void* pArg)
+{
+    const ReduceWorker* const pWorker = (const ReduceWorker*)pArg;
+    uint64_t                  i;
+
+    for (i = 0; i < TEST_ITEMS_PER_THREAD; ++i)
+    {
+        const uint64_t ullIndex = pWorker->ullFirst + i * TEST_THREADS;
+
+        if (0u == ullIndex % 3u && ullIndex > 0u)
+        {
+            cerror_set_last_info(testCode(CERROR_INTERNAL, (uint16_t)ullIndex), "worker");
+        }
+        cerror_reducer_contribute(pWorker->pReducer, ullIndex);
+    }
+    cerror_cleanup_thread_local_buffer();
+    return NULL;
+}
+
+static void testConcurrent(void)
+{
+    CErrorReducer stReducer;
+    ReduceWorker  aWorkers[TEST_THREADS];
+    pthread_t     aThreads[TEST_THREADS];
+    uint32_t      uExpected = 0;
+    uint64_t      i;
+
+    for (i = 1; i < TEST_THREADS * TEST_ITEMS_PER_THREAD; ++i)
+    {
+        uExpected += (0u == i % 3u) ? 1u : 0u;
+    }
+
+    cerror_reducer_init(&stReducer, CERROR_REDUCE_FIRST_BY_INDEX, NULL, 0);
+    for (i = 0; i < TEST_THREADS; ++i)
+    {
+        aWorkers[i].pReducer = &stReducer;
+        aWorkers[i].ullFirst = i;
+        TEST_CHECK(0 == pthread_create(&aThreads[i], NULL, reduceThread, &aWorkers[i]));
+    }
+    for (i = 0; i < TEST_THREADS; ++i)
+    {
+        TEST_CHECK(0 == pthread_join(aThreads[i], NULL));
+    }
+
+    TEST_CHECK(uExpected == cerror_reducer_finish(&stReducer));
+    TEST_CHECK(testCode(CERROR_INTERNAL, 3) == cerror_get_last());
+}
+
+int main(void)
+{
+    testFirstByIndex();
+    testMostSevere();
+    testCollectAll();
+    testNoError();
+    testConcurrent();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,135 @@
+/**
+ * @file test_save_restore.c
+ * @brief Save/restore: the saved error survives cleanup code that sets, copies or clears
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <string.h>
+
+static uint64_t stepCode(uint16_t uStep)
+{
+    return MAKE_ERROR_CODE(0x01, 0x6C, CERROR_DATA_LOSS, uStep);
+}
+
+/**
+ * @brief Simulated cleanup path that reuses the info buffer and clears
+ */
+static void cleanupClobbers(void)
+{
+    cerror_set_last_info_copy(stepCode(99), "rollback failed as well");
+    cerror_clear_last();
+    cerror_set_last_info(stepCode(98), "close failed");
+}
+
+static void testCopiedInfo(void)
+{
+    CErrorSavedState saved;
+
+    cerror_set_last_info_copy(stepCode(1), "insert failed");
+    cerror_save(&saved);
+    cleanupClobbers();
+    cerror_restore(&saved);
+
+    TEST_CHECK(stepCode(1) == cerror_get_last());
+    TEST_CHECK(0 == strcmp("insert failed", cerror_get_last_info()));
+}
+
+/**
+ * @brief Info longer than the inline slot is kept as well
+ */
+static void testLongInfo(void)
+{
+    CErrorSavedState saved;
+    char             szLong[CERROR_SAVED_INFO_CAPACITY * 3];
+
+    memset(szLong, 'x', sizeof(szLong) - 1);
+    szLong[sizeof(szLong) - 1] = '\0';
+    cerror_set_last_info_copy(stepCode(2), szLong);
+    cerror_save(&saved);
+    cleanupClobbers();
+    cerror_restore(&saved);
+
+    TEST_CHECK(stepCode(2) == cerror_get_last());
+    TEST_CHECK(0 == strcmp(szLong, cerror_get_last_info()));
+}
+
+/**
+ * @brief Constant info is kept by pointer
+ */
+static void testExternalInfo(void)
+{
+    static const char s_szInfo[] = "constant message";
+    CErrorSavedState  saved;
+
+    cerror_set_last_info(stepCode(3), s_szInfo);
+    cerror_save(&saved);
+    cleanupClobbers();
+    cerror_restore(&saved);
+
+    TEST_CHECK(stepCode(3) == cerror_get_last());
+    TEST_CHECK(s_szInfo == cerror_get_last_info());
+}
+
+/**
+ * @brief A slot saved from a clear context clears on restore; discard leaves the current error
+ */
+static void testClearAndDiscard(void)
+{
+    CErrorSavedState saved;
+
+    cerror_clear_last();
+    cerror_save(&saved);
+    cleanupClobbers();
+    cerror_restore(&saved);
+    TEST_CHECK(0u == cerror_get_last());
+    TEST_CHECK('\0' == cerror_get_last_info()[0]);
+
+    cerror_set_last_info_copy(stepCode(4), "saved then dropped");
+    cerror_save(&saved);
+    cerror_set_last(stepCode(5));
+    cerror_discard_saved(&saved);
+    TEST_CHECK(stepCode(5) == cerror_get_last());
+}
+
+static void countRelease(const char* pszInfo, void* pUserData)
+{
+    (void)pszInfo;
+    ++*(unsigned*)pUserData;
+}
+
+/**
+ * @brief Shared info is retained by the slot and released once
+ */
+static void testSharedInfo(void)
+{
+    unsigned          uReleases = 0;
+    CErrorSharedInfo* pShared = cerror_shared_info_create("shared", countRelease, &uReleases);
+    CErrorSavedState  saved;
+
+    cerror_set_last_info_shared(stepCode(6), pShared);
+    cerror_shared_info_release(pShared);
+    cerror_save(&saved);
+    cleanupClobbers();
+    TEST_CHECK(0u == uReleases);
+    cerror_restore(&saved);
+
+    TEST_CHECK(stepCode(6) == cerror_get_last());
+    TEST_CHECK(0 == strcmp("shared", cerror_get_last_info()));
+    cerror_clear_last();
+    TEST_CHECK(1u == uReleases);
+}
+
+int main(void)
+{
+    testCopiedInfo();
+    testLongInfo();
+    testExternalInfo();
+    testClearAndDiscard();
+    testSharedInfo();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,129 @@
+/**
+ * @file test_shared_info.c
+ * @brief Reference-counted info: lifetime across the context, readers and threads
+ *
+ * The release callback must run exactly once, when the last reference goes,
+ * whichever of the context, the creator or another thread holds it.
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#define TEST_THREADS    8
+#define TEST_ITERATIONS 10000
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x65, CERROR_UNAVAILABLE, 0x0001);
+static const uint64_t g_ullOther = MAKE_ERROR_CODE(0x01, 0x65, CERROR_INTERNAL, 0x0002);
+
+static void countRelease(const char* pszInfo, void* pUserData)
+{
+    (void)pszInfo;
+    ++*(unsigned*)pUserData;
+}
+
+/**
+ * @brief The context's reference outlives the creator's and goes with the error
+ */
+static void testContextReference(void)
+{
+    unsigned          uReleases = 0;
+    CErrorSharedInfo* pShared = cerror_shared_info_create("shared message", countRelease, &uReleases);
+    CErrorSharedInfo* pReader;
+
+    TEST_CHECK(NULL != pShared);
+    cerror_set_last_info_shared(g_ullCode, pShared);
+    cerror_shared_info_release(pShared);
+    TEST_CHECK(0u == uReleases);
+    TEST_CHECK(g_ullCode == cerror_get_last());
+    TEST_CHECK(0 == strcmp("shared message", cerror_get_last_info()));
+
+    /* A reader keeps the string alive after the error is replaced */
+    pReader = cerror_get_last_info_shared();
+    TEST_CHECK(pReader == pShared);
+    cerror_set_last_info(g_ullOther, "replaced");
+    TEST_CHECK(NULL == cerror_get_last_info_shared());
+    TEST_CHECK(0u == uReleases);
+    TEST_CHECK(0 == strcmp("shared message", cerror_shared_info_get(pReader)));
+    cerror_shared_info_release(pReader);
+    TEST_CHECK(1u == uReleases);
+}
+
+/**
+ * @brief Clear and cleanup drop the context's reference
+ */
+static void testClearAndCleanup(void)
+{
+    unsigned          uReleases = 0;
+    CErrorSharedInfo* pShared = cerror_shared_info_create("cleared", countRelease, &uReleases);
+
+    cerror_set_last_info_shared(g_ullCode, pShared);
+    cerror_shared_info_release(pShared);
+    cerror_clear_last();
+    TEST_CHECK(1u == uReleases);
+
+    uReleases = 0;
+    pShared = cerror_shared_info_create("cleaned up", countRelease, &uReleases);
+    cerror_set_last_info_shared(g_ullCode, pShared);
+    cerror_shared_info_release(pShared);
+    cerror_cleanup_thread_local_buffer();
+    TEST_CHECK(1u == uReleases);
+
+    /* NULL holder: the code is set with empty info */
+    cerror_set_last_info_shared(g_ullCode, NULL);
+    TEST_CHECK(g_ullCode == cerror_get_last());
+    TEST_CHECK('\0' == cerror_get_last_info()[0]);
+    TEST_CHECK(0 == strcmp("", cerror_shared_info_get(NULL)));
+}
+
+static void* retainThread(void* pArg)
+{
+    CErrorSharedInfo* const pShared = (CErrorSharedInfo*)pArg;
+    int                     i;
+
+    for (i = 0; i < TEST_ITERATIONS; ++i)
+    {
+        cerror_set_last_info_shared(g_ullCode, pShared);
+        cerror_shared_info_retain(pShared);
+        cerror_clear_last();
+        cerror_shared_info_release(pShared);
+    }
+    cerror_cleanup_thread_local_buffer();
+    return NULL;
+}
+
+/**
+ * @brief Concurrent references from many threads release exactly once
+ */
+static void testConcurrent(void)
+{
+    unsigned          uReleases = 0;
+    CErrorSharedInfo* pShared = cerror_shared_info_create("from every thread", countRelease, &uReleases);
+    pthread_t         aThreads[TEST_THREADS];
+    int               i;
+
+    for (i = 0; i < TEST_THREADS; ++i)
+    {
+        TEST_CHECK(0 == pthread_create(&aThreads[i], NULL, retainThread, pShared));
+    }
+    for (i = 0; i < TEST_THREADS; ++i)
+    {
+        TEST_CHECK(0 == pthread_join(aThreads[i], NULL));
+    }
+    TEST_CHECK(0u == uReleases);
+    cerror_shared_info_release(pShared);
+    TEST_CHECK(1u == uReleases);
+}
+
+int main(void)
+{
+    testContextReference();
+    testClearAndCleanup();
+    testConcurrent();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,89 @@
+/**
+ * @file test_sticky_first.c
+ * @brief Sticky first-error mode: the first error is kept, later sets only count
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+#include <c-error/payload.h>
+
+#include <string.h>
+
+static uint64_t stepCode(uint16_t uStep)
+{
+    return MAKE_ERROR_CODE(0x01, 0x6A, CERROR_FAILED_PRECONDITION, uStep);
+}
+
+/**
+ * @brief Later setters leave code, info and payload of the first error untouched
+ */
+static void testFirstErrorKept(void)
+{
+    cerror_set_sticky_first_mode(1);
+    TEST_CHECK(cerror_is_sticky_first_mode());
+    TEST_CHECK(0u == cerror_get_error_count());
+
+    cerror_set_last_info_copy(stepCode(1), "first");
+    TEST_CHECK(1 == cerror_payload_add_int("row", 12));
+    cerror_set_last_info(stepCode(2), "second");
+    cerror_set_last_info_copy(stepCode(3), "third");
+    cerror_set_last(stepCode(4));
+
+    TEST_CHECK(stepCode(1) == cerror_get_last());
+    TEST_CHECK(0 == strcmp("first", cerror_get_last_info()));
+    TEST_CHECK(4u == cerror_get_error_count());
+
+    /* Fields of a suppressed error do not land on the kept one */
+    TEST_CHECK(0 == cerror_payload_add_int("row", 13));
+    TEST_CHECK(0 == cerror_payload_add_string("stage", "late"));
+}
+
+/**
+ * @brief A clear starts a new sticky window; setting code 0 is not counted
+ */
+static void testClearAndZero(void)
+{
+    cerror_clear_last();
+    TEST_CHECK(0u == cerror_get_last());
+    TEST_CHECK(0u == cerror_get_error_count());
+    TEST_CHECK(cerror_is_sticky_first_mode());
+
+    cerror_set_last(0u);
+    TEST_CHECK(0u == cerror_get_error_count());
+
+    cerror_set_last_info(stepCode(5), "after clear");
+    TEST_CHECK(stepCode(5) == cerror_get_last());
+    TEST_CHECK(1u == cerror_get_error_count());
+    TEST_CHECK(1 == cerror_payload_add_int("row", 14));
+}
+
+/**
+ * @brief Toggling clears the error; last-error semantics return when disabled
+ */
+static void testToggle(void)
+{
+    cerror_set_last(stepCode(6));
+    cerror_set_sticky_first_mode(0);
+    TEST_CHECK(!cerror_is_sticky_first_mode());
+    TEST_CHECK(0u == cerror_get_last());
+
+    cerror_set_last(stepCode(7));
+    cerror_set_last(stepCode(8));
+    TEST_CHECK(stepCode(8) == cerror_get_last());
+    TEST_CHECK(0u == cerror_get_error_count());
+
+    cerror_set_sticky_first_mode(1);
+    TEST_CHECK(0u == cerror_get_last());
+    cerror_set_sticky_first_mode(0);
+}
+
+int main(void)
+{
+    testFirstErrorKept();
+    testClearAndZero();
+    testToggle();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file test_timestamp.c
+ * @brief Error timestamps: clock source selection and the CLOCK_MONOTONIC base of every source
+ */
+
+#include "test_common.h"
+
+#include <c-error/lasterror.h>
+
+/** The coarse clock lags by up to a tick, the TSC conversion by calibration error */
+#define TEST_TOLERANCE_NS 50000000ULL
+
+static const uint64_t g_ullCode = MAKE_ERROR_CODE(0x01, 0x6B, CERROR_DEADLINE_EXCEEDED, 0x0001);
+
+/**
+ * @brief The set time lies between two reads of cerror_clock_now_ns()
+ */
+static int setWithinNow(void)
+{
+    const uint64_t ullBefore = cerror_clock_now_ns();
+    uint64_t       ullStamp;
+    uint64_t       ullAfter;
+
+    cerror_set_last_info(g_ullCode, "timed out");
+    ullAfter = cerror_clock_now_ns();
+    ullStamp = cerror_get_last_timestamp_ns();
+    return ullStamp + TEST_TOLERANCE_NS >= ullBefore && ullStamp <= ullAfter + TEST_TOLERANCE_NS;
+}
+
+static void testNone(void)
+{
+    TEST_CHECK(CERROR_CLOCK_NONE == cerror_get_clock_source());
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(0u == cerror_get_last_timestamp_ns());
+
+    TEST_CHECK(0 == cerror_set_clock_source((CErrorClockSource)42));
+    TEST_CHECK(CERROR_CLOCK_NONE == cerror_get_clock_source());
+}
+
+static void testCoarse(void)
+{
+    TEST_CHECK(1 == cerror_set_clock_source(CERROR_CLOCK_COARSE));
+    TEST_CHECK(CERROR_CLOCK_COARSE == cerror_get_clock_source());
+    TEST_CHECK(setWithinNow());
+
+    /* A clear drops the timestamp with the error */
+    cerror_clear_last();
+    TEST_CHECK(0u == cerror_get_last_timestamp_ns());
+}
+
+/**
+ * @brief TSC may be unavailable; when selected it converts to the same base
+ */
+static void testTsc(void)
+{
+    if (cerror_set_clock_source(CERROR_CLOCK_TSC))
+    {
+        TEST_CHECK(CERROR_CLOCK_TSC == cerror_get_clock_source());
+        TEST_CHECK(setWithinNow());
+    }
+    else
+    {
+        TEST_CHECK(CERROR_CLOCK_COARSE == cerror_get_clock_source());
+    }
+}
+
+static void testBackToNone(void)
+{
+    TEST_CHECK(1 == cerror_set_clock_source(CERROR_CLOCK_NONE));
+    cerror_set_last(g_ullCode);
+    TEST_CHECK(0u == cerror_get_last_timestamp_ns());
+}
+
+int main(void)
+{
+    testNone();
+    testCoarse();
+    testTsc();
+    testBackToNone();
+
+    cerror_cleanup_thread_local_buffer();
+    return TEST_RESULT();
+}